@@ -1,5 +1,8 @@
 #define Unrolling 24
+/* Qt: qcryptographichash.cpp builds a second copy without lane complementing */
+#ifndef QT_KECCAK_NO_BEBIGOKIMISA
 #define UseBebigokimisa
+#endif
 //#define UseSSE
 //#define UseOnlySIMD64
 //#define UseMMX
@@ -232,6 +232,257 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+/*
+    Vectorized conversion of non-ASCII text, chosen at run time. Both
+    directions handle the characters from U+0000 to U+FFFF, except surrogates,
+    and stop at anything else: surrogate pairs and malformed input are left to
+    the scalar code, up to nextAscii, so errors are reported and replaced
+    exactly as before.
+
+    The shuffle tables below are generated at compile time: for the decoder,
+    one entry per 8-bit mask of 16-bit lanes to keep, moving them to the front;
+    for the encoder, one entry per combination of the UTF-8 lengths of four
+    characters stored four bytes apart, packing their bytes together.
+*/
+static Q_DECL_CONSTEXPR int nthSetBit(uint mask, int n, int bit = 0)
+{
+    return bit == 8 ? -1
+         : !(mask & (1U << bit)) ? nthSetBit(mask, n, bit + 1)
+         : n ? nthSetBit(mask, n - 1, bit + 1)
+         : bit;
+}
+
+static Q_DECL_CONSTEXPR char decoderShuffle(uint keep, int i)
+{
+    return nthSetBit(keep, i / 2) < 0 ? char(-1) : char(nthSetBit(keep, i / 2) * 2 + i % 2);
+}
+
+// bits 0-3 are set for characters of two bytes or more, bits 4-7 for those of three
+static Q_DECL_CONSTEXPR int utf8Length(uint lengths, int ch)
+{
+    return 1 + ((lengths >> ch) & 1) + ((lengths >> (ch + 4)) & 1);
+}
+
+static Q_DECL_CONSTEXPR char encoderShuffle(uint lengths, int i, int ch = 0)
+{
+    return ch == 4 ? char(-1)
+         : i < utf8Length(lengths, ch) ? char(ch * 4 + i)
+         : encoderShuffle(lengths, i - utf8Length(lengths, ch), ch + 1);
+}
+
+#define QT_UTF8_SHUFFLE(f, m) \
+    { f(m, 0), f(m, 1), f(m, 2), f(m, 3), f(m, 4), f(m, 5), f(m, 6), f(m, 7), \
+      f(m, 8), f(m, 9), f(m, 10), f(m, 11), f(m, 12), f(m, 13), f(m, 14), f(m, 15) }
+#define QT_UTF8_SHUFFLES16(f, m) \
+    QT_UTF8_SHUFFLE(f, m + 0), QT_UTF8_SHUFFLE(f, m + 1), QT_UTF8_SHUFFLE(f, m + 2), \
+    QT_UTF8_SHUFFLE(f, m + 3), QT_UTF8_SHUFFLE(f, m + 4), QT_UTF8_SHUFFLE(f, m + 5), \
+    QT_UTF8_SHUFFLE(f, m + 6), QT_UTF8_SHUFFLE(f, m + 7), QT_UTF8_SHUFFLE(f, m + 8), \
+    QT_UTF8_SHUFFLE(f, m + 9), QT_UTF8_SHUFFLE(f, m + 10), QT_UTF8_SHUFFLE(f, m + 11), \
+    QT_UTF8_SHUFFLE(f, m + 12), QT_UTF8_SHUFFLE(f, m + 13), QT_UTF8_SHUFFLE(f, m + 14), \
+    QT_UTF8_SHUFFLE(f, m + 15)
+#define QT_UTF8_SHUFFLES(f) { \
+    QT_UTF8_SHUFFLES16(f, 0x00), QT_UTF8_SHUFFLES16(f, 0x10), QT_UTF8_SHUFFLES16(f, 0x20), \
+    QT_UTF8_SHUFFLES16(f, 0x30), QT_UTF8_SHUFFLES16(f, 0x40), QT_UTF8_SHUFFLES16(f, 0x50), \
+    QT_UTF8_SHUFFLES16(f, 0x60), QT_UTF8_SHUFFLES16(f, 0x70), QT_UTF8_SHUFFLES16(f, 0x80), \
+    QT_UTF8_SHUFFLES16(f, 0x90), QT_UTF8_SHUFFLES16(f, 0xa0), QT_UTF8_SHUFFLES16(f, 0xb0), \
+    QT_UTF8_SHUFFLES16(f, 0xc0), QT_UTF8_SHUFFLES16(f, 0xd0), QT_UTF8_SHUFFLES16(f, 0xe0), \
+    QT_UTF8_SHUFFLES16(f, 0xf0) }
+
+static const char utf8DecoderShuffles[256][16] = QT_UTF8_SHUFFLES(decoderShuffle);
+static const char utf8EncoderShuffles[256][16] = QT_UTF8_SHUFFLES(encoderShuffle);
+
+#undef QT_UTF8_SHUFFLES
+#undef QT_UTF8_SHUFFLES16
+#undef QT_UTF8_SHUFFLE
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i simdLoadShuffles(const char (*table)[16], uint low, uint high)
+{
+    const __m128i lowShuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table[low]));
+    const __m128i highShuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table[high]));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lowShuffle), highShuffle, 1);
+}
+
+// Encodes eight characters, zero-extended to 32 bits, and appends them to dst.
+// Always writes sixteen bytes past the start of each group of four.
+QT_FUNCTION_TARGET(AVX2)
+static inline void simdEncodeUtf8Lanes(uchar *&dst, __m256i c)
+{
+    const __m256i low6 = _mm256_set1_epi32(0x3f);
+    const __m256i cont = _mm256_set1_epi32(0x80);
+
+    const __m256i last = _mm256_or_si256(_mm256_and_si256(c, low6), cont);
+    const __m256i middle = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c, 6), low6), cont);
+    const __m256i twoBytes = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0xc0)),
+                                             _mm256_slli_epi32(last, 8));
+    const __m256i threeBytes = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(c, 12), _mm256_set1_epi32(0xe0)),
+                                               _mm256_or_si256(_mm256_slli_epi32(middle, 8),
+                                                               _mm256_slli_epi32(last, 16)));
+
+    const __m256i isTwoBytes = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7f));
+    const __m256i isThreeBytes = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7ff));
+    __m256i bytes = _mm256_blendv_epi8(c, twoBytes, isTwoBytes);
+    bytes = _mm256_blendv_epi8(bytes, threeBytes, isThreeBytes);
+
+    const uint twoOrMore = _mm256_movemask_ps(_mm256_castsi256_ps(isTwoBytes));
+    const uint three = _mm256_movemask_ps(_mm256_castsi256_ps(isThreeBytes));
+    const uint low = (twoOrMore & 0xf) | (three & 0xf) << 4;
+    const uint high = (twoOrMore >> 4) | (three & 0xf0);
+    bytes = _mm256_shuffle_epi8(bytes, simdLoadShuffles(utf8EncoderShuffles, low, high));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(bytes));
+    dst += 4 + _mm_popcnt_u32(low);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_extracti128_si256(bytes, 1));
+    dst += 4 + _mm_popcnt_u32(high);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void simdEncodeNonAscii_avx2(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+    const __m256i surrogateMask = _mm256_set1_epi16(short(0xf800));
+    const __m256i surrogate = _mm256_set1_epi16(short(0xd800));
+
+    // The output buffer holds three bytes per code unit and each group of
+    // four characters writes sixteen bytes: keeping two more code units in
+    // the input after the block keeps those stores inside it.
+    for ( ; end - src >= 18; src += 16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const uint surrogates = _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(data, surrogateMask),
+                                                                        surrogate));
+        if (surrogates) {
+            // leave as little as possible to the scalar code
+            nextAscii = src + qBitScanReverse(surrogates) / 2 + 1;
+            if (qCountTrailingZeroBits(surrogates) >= 16) {
+                simdEncodeUtf8Lanes(dst, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(data)));
+                src += 8;
+            }
+            return;
+        }
+
+        simdEncodeUtf8Lanes(dst, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(data)));
+        simdEncodeUtf8Lanes(dst, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(data, 1)));
+    }
+    nextAscii = end;
+}
+
+// Decodes the characters starting at each position, given the byte at that
+// position and the next one (w01) and the two after it (w12) in 16-bit lanes.
+// Only the lanes of lead bytes are meaningful.
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i simdDecodeUtf8Lanes(__m256i w01, __m256i w12)
+{
+    // multiply the payload of the first byte of each pair by 64 and add the second's
+    const __m256i weights = _mm256_set1_epi16(0x0140);
+    const __m256i twoBytes = _mm256_maddubs_epi16(_mm256_and_si256(w01, _mm256_set1_epi16(0x3f1f)), weights);
+    // the 16-bit shift by 12 keeps the payload of a three-byte lead
+    const __m256i threeBytes = _mm256_or_si256(_mm256_slli_epi16(w01, 12),
+            _mm256_maddubs_epi16(_mm256_and_si256(w12, _mm256_set1_epi16(0x3f3f)), weights));
+
+    const __m256i first = _mm256_and_si256(w01, _mm256_set1_epi16(0xff));
+    __m256i result = _mm256_blendv_epi8(first, twoBytes, _mm256_cmpgt_epi16(first, _mm256_set1_epi16(0xbf)));
+    return _mm256_blendv_epi8(result, threeBytes, _mm256_cmpgt_epi16(first, _mm256_set1_epi16(0xdf)));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void simdDecodeNonAscii_avx2(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    // a sequence starting in the last two bytes of the block needs two more
+    while (end - src >= 34) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 1));
+        const __m256i next2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2));
+
+        // One bit per byte. As signed bytes, continuation bytes are less than
+        // 0xc0 and three-byte leads greater than 0xdf.
+        const uint nonAscii = _mm256_movemask_epi8(data);
+        const uint isCont = _mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(char(0xc0)), data));
+        const uint leads = nonAscii & ~isCont;
+        const uint lead3 = nonAscii & _mm256_movemask_epi8(_mm256_cmpgt_epi8(data, _mm256_set1_epi8(char(0xdf))));
+
+        // Not handled here: 0xc0 and 0xc1, which only start overlong
+        // sequences, 0xf0 and up, which start four-byte sequences or are
+        // invalid, E0 not followed by A0-BF (overlong) and ED not followed by
+        // 80-9F (surrogates).
+        const __m256i fourBytes = _mm256_cmpeq_epi8(_mm256_max_epu8(data, _mm256_set1_epi8(char(0xf0))), data);
+        const __m256i overlong2 = _mm256_cmpeq_epi8(_mm256_and_si256(data, _mm256_set1_epi8(char(0xfe))),
+                                                    _mm256_set1_epi8(char(0xc0)));
+        const __m256i overlong3 = _mm256_and_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xe0))),
+                                                   _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0xa0)), next));
+        const __m256i surrogate = _mm256_and_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(0xed))),
+                                                   _mm256_cmpgt_epi8(next, _mm256_set1_epi8(char(0x9f))));
+        uint problems = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(fourBytes, overlong2),
+                                                             _mm256_or_si256(overlong3, surrogate)));
+
+        // Every lead byte needs its continuation bytes, which may extend two
+        // bytes past the block, and every continuation byte in the block must
+        // belong to a sequence started in it.
+        const uint contAfter = uint(_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(char(0xc0)), next2))) >> 30;
+        const quint64 cont = isCont | quint64(contAfter) << 32;
+        const quint64 needed = quint64(leads) << 1 | quint64(lead3) << 2;
+        problems |= uint(needed ^ cont);
+        if ((needed & ~cont) >> 32)
+            problems |= 1U << 31;
+        if (problems) {
+            // let the scalar code go just past the last one
+            nextAscii = src + qBitScanReverse(problems) + 1;
+            return;
+        }
+
+        if (!leads) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst) + 1,
+                                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)));
+            dst += 32;
+            src += 32;
+            continue;
+        }
+
+        // the unpacks work within 128-bit lanes: positions 0-7 and 16-23
+        // end up in "low", 8-15 and 24-31 in "high"
+        __m256i low = simdDecodeUtf8Lanes(_mm256_unpacklo_epi8(data, next), _mm256_unpacklo_epi8(next, next2));
+        __m256i high = simdDecodeUtf8Lanes(_mm256_unpackhi_epi8(data, next), _mm256_unpackhi_epi8(next, next2));
+
+        // keep one character per byte that isn't a continuation
+        const uint keep = ~isCont;
+        low = _mm256_shuffle_epi8(low, simdLoadShuffles(utf8DecoderShuffles, keep & 0xff, (keep >> 16) & 0xff));
+        high = _mm256_shuffle_epi8(high, simdLoadShuffles(utf8DecoderShuffles, (keep >> 8) & 0xff, keep >> 24));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(low));
+        dst += _mm_popcnt_u32(keep & 0xff);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(high));
+        dst += _mm_popcnt_u32((keep >> 8) & 0xff);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_extracti128_si256(low, 1));
+        dst += _mm_popcnt_u32((keep >> 16) & 0xff);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_extracti128_si256(high, 1));
+        dst += _mm_popcnt_u32(keep >> 24);
+
+        // skip the continuation bytes of sequences that started at the end of the block
+        src += 32 + (leads >> 31) + (lead3 >> 31) + ((lead3 >> 30) & 1);
+    }
+    nextAscii = end;
+}
+
+static inline void simdEncodeNonAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+    if (qCpuHasFeature(AVX2))
+        simdEncodeNonAscii_avx2(dst, nextAscii, src, end);
+}
+
+static inline void simdDecodeNonAscii(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    if (qCpuHasFeature(AVX2))
+        simdDecodeNonAscii_avx2(dst, nextAscii, src, end);
+}
+#else
+static inline void simdEncodeNonAscii(uchar *, const ushort *, const ushort *, const ushort *)
+{
+}
+
+static inline void simdDecodeNonAscii(ushort *, const uchar *, const uchar *, const uchar *)
+{
+}
+#endif
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -244,6 +495,7 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        simdEncodeNonAscii(dst, nextAscii, src, end);
 
         do {
             ushort uc = *src++;
@@ -296,8 +548,11 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                simdEncodeNonAscii(cursor, nextAscii, src, end);
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -387,6 +642,9 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            simdDecodeNonAscii(dst, nextAscii, src, end);
+            if (src == end)
+                break;
 
             do {
                 uchar b = *src++;
@@ -475,8 +733,16 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the BOM check below needs to see the first character
+            if (headerdone) {
+                simdDecodeNonAscii(dst, nextAscii, src, end);
+                if (src == end)
+                    break;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
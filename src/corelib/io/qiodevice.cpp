@@ -167,6 +167,7 @@ QIODevicePrivate::QIODevicePrivate()
       transactionPos(0),
       transactionStarted(false)
        , baseReadLineDataCalled(false)
+       , currentWriteChunk(nullptr)
        , accessMode(Unset)
 #ifdef QT_NO_QOBJECT
        , q_ptr(0)
@@ -1694,15 +1695,50 @@ qint64 QIODevice::write(const char *data)
     return write(data, qstrlen(data));
 }
 
-/*! \fn qint64 QIODevice::write(const QByteArray &byteArray)
-
+/*!
     \overload
 
     Writes the content of \a byteArray to the device. Returns the number of
     bytes that were actually written, or -1 if an error occurred.
 
+    Devices that buffer their output, such as QTcpSocket, keep a reference
+    to \a byteArray rather than copying its contents where that pays off.
+
     \sa read(), writeData()
 */
+qint64 QIODevice::write(const QByteArray &byteArray)
+{
+    Q_D(QIODevice);
+
+    // Let writeData() recognize the data (see appendToWriteBuffer())
+    const QByteArray *previousChunk = d->currentWriteChunk;
+    d->currentWriteChunk = &byteArray;
+    const qint64 written = write(byteArray.constData(), byteArray.size());
+    d->currentWriteChunk = previousChunk;
+    return written;
+}
+
+/*!
+    \internal
+
+    Appends \a size bytes from \a data to the current write buffer. If
+    \a data is the contents of a QByteArray passed to QIODevice::write()
+    and at least one buffer chunk long, the buffer shares it instead of
+    copying it; smaller arrays are cheaper to copy than to keep as blocks of
+    their own. Arrays created with QByteArray::fromRawData() are always copied, since
+    the caller may free their contents as soon as write() returns.
+*/
+void QIODevicePrivate::appendToWriteBuffer(const char *data, qint64 size)
+{
+    if (currentWriteChunk && currentWriteChunk->constData() == data
+        && currentWriteChunk->size() == size
+        && currentWriteChunk->capacity() != 0 // owns its data
+        && size >= qMax(writeBuffer.chunkSize(), QRINGBUFFER_CHUNKSIZE)) {
+        writeBuffer.append(*currentWriteChunk);
+    } else {
+        writeBuffer.append(data, size);
+    }
+}
 
 /*!
     Puts the character \a c back into the device, and decrements the
@@ -97,6 +97,7 @@ public:
         inline qint64 nextDataBlockSize() const { return (m_buf ? m_buf->nextDataBlockSize() : Q_INT64_C(0)); }
         inline const char *readPointer() const { return (m_buf ? m_buf->readPointer() : Q_NULLPTR); }
         inline const char *readPointerAtPosition(qint64 pos, qint64 &length) const { Q_ASSERT(m_buf); return m_buf->readPointerAtPosition(pos, length); }
+        inline int readPointers(const char **pointers, qint64 *lengths, int maxCount) const { return (m_buf ? m_buf->readPointers(pointers, lengths, maxCount) : 0); }
         inline void free(qint64 bytes) { Q_ASSERT(m_buf); m_buf->free(bytes); }
         inline char *reserve(qint64 bytes) { Q_ASSERT(m_buf); return m_buf->reserve(bytes); }
         inline char *reserveFront(qint64 bytes) { Q_ASSERT(m_buf); return m_buf->reserveFront(bytes); }
@@ -133,8 +134,10 @@ public:
     qint64 transactionPos;
     bool transactionStarted;
     bool baseReadLineDataCalled;
+    const QByteArray *currentWriteChunk; // set during QIODevice::write(const QByteArray &)
 
     virtual bool putCharHelper(char c);
+    void appendToWriteBuffer(const char *data, qint64 size);
 
     enum AccessMode {
         Unset,
@@ -4,6 +4,8 @@ HEADERS += \
     json/qjsonobject.h \
     json/qjsonvalue.h \
     json/qjsonarray.h \
+    json/qjsonstream.h \
+    json/qjsonlazyvalue.h \
     json/qjsonwriter_p.h \
     json/qjsonparser_p.h
 
@@ -14,4 +16,5 @@ SOURCES += \
     json/qjsonarray.cpp \
     json/qjsonvalue.cpp \
     json/qjsonwriter.cpp \
-    json/qjsonparser.cpp
+    json/qjsonparser.cpp \
+    json/qjsonstream.cpp
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QJSONLAZYVALUE_H
+#define QJSONLAZYVALUE_H
+
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QJsonParseError;
+
+class Q_CORE_EXPORT QJsonLazyValue
+{
+public:
+    QJsonLazyValue() : from(0), to(0) {}
+    explicit QJsonLazyValue(const QByteArray &json);
+
+    void swap(QJsonLazyValue &other) Q_DECL_NOTHROW
+    {
+        qSwap(json, other.json);
+        qSwap(from, other.from);
+        qSwap(to, other.to);
+    }
+
+    QJsonValue::Type type() const;
+    bool isUndefined() const { return type() == QJsonValue::Undefined; }
+    bool isObject() const { return type() == QJsonValue::Object; }
+    bool isArray() const { return type() == QJsonValue::Array; }
+
+    int size() const;
+    QStringList keys() const;
+
+    QJsonLazyValue value(const QString &key) const;
+    QJsonLazyValue at(int i) const;
+    QJsonLazyValue operator[](const QString &key) const { return value(key); }
+    QJsonLazyValue operator[](int i) const { return at(i); }
+
+    QByteArray rawJson() const;
+    QJsonValue toValue(QJsonParseError *error = Q_NULLPTR) const;
+
+private:
+    QJsonLazyValue(const QByteArray &text, int begin, int end) : json(text), from(begin), to(end) {}
+
+    QByteArray json;
+    int from;
+    int to;
+};
+
+Q_DECLARE_SHARED(QJsonLazyValue)
+
+QT_END_NAMESPACE
+
+#endif // QJSONLAZYVALUE_H
@@ -42,9 +42,13 @@
 #include <qcoreapplication.h>
 #endif
 #include <qdebug.h>
+#include <qjsonarray.h>
+#include <qjsonlazyvalue.h>
+#include <qjsonobject.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -62,6 +66,8 @@ static const int nestingLimit = 1024;
 
 QT_BEGIN_NAMESPACE
 
+void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW; // qstring.cpp
+
 // error strings for the JSON parser
 #define JSONERR_OK          QT_TRANSLATE_NOOP("QJsonParseError", "no error occurred")
 #define JSONERR_UNTERM_OBJ  QT_TRANSLATE_NOOP("QJsonParseError", "unterminated object")
@@ -245,6 +251,97 @@ enum {
     Quote = 0x22
 };
 
+static inline bool isWhitespace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+/*
+    The scanners below look for the next byte that needs attention 16 or 32
+    bytes at a time, and handle the remainder one byte at a time. They return
+    \a end if there is no such byte.
+*/
+
+static inline const char *skipWhitespace(const char *ptr, const char *end)
+{
+    // most tokens are not preceded by whitespace, or only by a single space
+    if (ptr >= end || !isWhitespace(*ptr))
+        return ptr;
+    ++ptr;
+
+#ifdef __SSE2__
+    // but indentation in pretty-printed documents comes in longer runs
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i carriageReturn = _mm_set1_epi8(Return);
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, carriageReturn)));
+        const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+
+    while (ptr < end && isWhitespace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+QT_FUNCTION_TARGET(AVX2)
+static const char *findStringSpecial_avx2(const char *ptr, const char *end, bool stopAtNonAscii)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - ptr >= 32; ptr += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        uint mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                         _mm256_cmpeq_epi8(data, backslash)));
+        if (stopAtNonAscii)
+            mask |= _mm256_movemask_epi8(data);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+    return ptr;
+}
+#endif
+
+/*
+    Finds the end of a run of characters inside a string that can be copied
+    verbatim: the next quote or backslash and, if \a stopAtNonAscii is true,
+    the next byte of a multi-byte UTF-8 sequence.
+*/
+static inline const char *findStringSpecial(const char *ptr, const char *end, bool stopAtNonAscii)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (end - ptr >= 32 && qCpuHasFeature(AVX2))
+        ptr = findStringSpecial_avx2(ptr, end, stopAtNonAscii);
+#endif
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        uint mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                   _mm_cmpeq_epi8(data, backslash)));
+        if (stopAtNonAscii)
+            mask |= _mm_movemask_epi8(data);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for ( ; ptr < end; ++ptr) {
+        if (*ptr == Quote || *ptr == '\\' || (stopAtNonAscii && uchar(*ptr) >= 0x80))
+            break;
+    }
+    return ptr;
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -258,16 +355,7 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -668,13 +756,16 @@ bool Parser::parseValue(QJsonPrivate::Value *val, int baseOffset)
 
 */
 
-bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+/*
+    Returns the end of the number that starts at \a json, read as
+    [ minus ] int [ frac ] [ exp ]. A digit after a leading zero is not part
+    of the number. Whether the digits are there at all is left to the
+    conversion. \a isInt is set to whether there is neither a fraction nor
+    an exponent.
+*/
+const char *QJsonPrivate::scanNumber(const char *json, const char *end, bool *isInt)
 {
-    BEGIN << "parseNumber" << json;
-    val->type = QJsonValue::Double;
-
-    const char *start = json;
-    bool isInt = true;
+    *isInt = true;
 
     // minus
     if (json < end && *json == '-')
@@ -690,7 +781,7 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // frac = decimal-point 1*DIGIT
     if (json < end && *json == '.') {
-        isInt = false;
+        *isInt = false;
         ++json;
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
@@ -698,13 +789,24 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // exp = e [ minus / plus ] 1*DIGIT
     if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
+        *isInt = false;
         ++json;
         if (json < end && (*json == '-' || *json == '+'))
             ++json;
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
     }
+    return json;
+}
+
+bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+{
+    BEGIN << "parseNumber" << json;
+    val->type = QJsonValue::Double;
+
+    const char *start = json;
+    bool isInt;
+    json = scanNumber(json, end, &isInt);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
@@ -858,6 +960,21 @@ bool Parser::parseString(bool *latin1)
     int stringPos = reserveSpace(2);
     BEGIN << "parse string stringPos=" << stringPos << json;
     while (json < end) {
+        // copy runs of ASCII characters in one go
+        const char *run = findStringSpecial(json, end, true);
+        if (run != json) {
+            const int length = int(run - json);
+            const int pos = reserveSpace(length);
+            memcpy(data + pos, json, length);
+            json = run;
+            if (json - start >= 0x8000) {
+                *latin1 = false;
+                break;
+            }
+            if (json >= end)
+                break;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -906,6 +1023,22 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+        const char *run = findStringSpecial(json, end, true);
+        if (run != json) {
+            const int length = int(run - json);
+            const int pos = reserveSpace(2 * length);
+            char *out = data + pos;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            qt_from_latin1(reinterpret_cast<ushort *>(out), json, length);
+#else
+            for (int i = 0; i < length; ++i)
+                reinterpret_cast<QJsonPrivate::qle_ushort *>(out)[i] = ushort(uchar(json[i]));
+#endif
+            json = run;
+            if (json >= end)
+                break;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -945,4 +1078,575 @@ bool Parser::parseString(bool *latin1)
     return true;
 }
 
+/*
+    Decodes the contents of a string, without the quotes, into \a string.
+    Used where the parser's binary output is not wanted.
+*/
+QJsonParseError::ParseError QJsonPrivate::decodeString(const char *json, const char *end, QString *string)
+{
+    if (findStringSpecial(json, end, true) == end) {
+        *string = QString::fromLatin1(json, int(end - json));
+        return QJsonParseError::NoError;
+    }
+
+    string->clear();
+    string->reserve(int(end - json));
+    while (json < end) {
+        uint ch = 0;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch))
+                return QJsonParseError::IllegalEscapeSequence;
+        } else if (!scanUtf8Char(json, end, &ch)) {
+            return QJsonParseError::IllegalUTF8String;
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            *string += QChar(QChar::highSurrogate(ch));
+            *string += QChar(QChar::lowSurrogate(ch));
+        } else {
+            *string += QChar(ushort(ch));
+        }
+    }
+    return QJsonParseError::NoError;
+}
+
+/*
+    Skipping over values for QJsonLazyValue. These only check what is needed to
+    find the end of a value; the full grammar is checked when a value gets
+    materialized.
+*/
+
+// ptr points past the opening quote; returns a pointer past the closing one
+static const char *skipString(const char *ptr, const char *end)
+{
+    while (ptr < end) {
+        ptr = findStringSpecial(ptr, end, false);
+        if (ptr >= end)
+            break;
+        if (*ptr == Quote)
+            return ptr + 1;
+        // skip the backslash and the character it escapes
+        ptr += 2;
+    }
+    return 0;
+}
+
+/*
+    Containers are skipped a block at a time: the quotes, backslashes and
+    brackets of each block are collected in a bit mask, and only those
+    positions are looked at. SkipState carries what is needed across blocks.
+*/
+namespace {
+struct SkipState
+{
+    int depth;
+    bool inString;
+    bool escaped;       // - the first byte of the next block is escaped
+};
+}
+
+// returns the offset past the closing bracket in the block, 0 if the
+// container continues past the block, or -1 if it is nested too deeply
+static inline int skipStructural(SkipState &state, const char *block, uint mask, int blockSize)
+{
+    if (state.escaped) {
+        mask &= ~1u;
+        state.escaped = false;
+    }
+    while (mask) {
+        const int i = qCountTrailingZeroBits(mask);
+        mask &= mask - 1;
+        switch (block[i]) {
+        case '\\':
+            if (!state.inString)
+                break;
+            if (i + 1 < blockSize)
+                mask &= ~(1u << (i + 1));
+            else
+                state.escaped = true;
+            break;
+        case Quote:
+            state.inString = !state.inString;
+            break;
+        case BeginArray:
+        case BeginObject:
+            if (!state.inString && ++state.depth > nestingLimit)
+                return -1;
+            break;
+        default:
+            if (!state.inString && --state.depth == 0)
+                return i + 1;
+            break;
+        }
+    }
+    return 0;
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+// returns true once the end of the container was found (ptr is then the
+// result of skipContainer), false if it needs to continue after ptr
+QT_FUNCTION_TARGET(AVX2)
+static bool skipContainer_avx2(SkipState &state, const char *&ptr, const char *end)
+{
+    // '[' and ']' only differ from '{' and '}' in the 0x20 bit, and no other
+    // byte folds onto these
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lowerCase = _mm256_set1_epi8(0x20);
+    const __m256i beginObject = _mm256_set1_epi8(BeginObject);
+    const __m256i endObject = _mm256_set1_epi8(EndObject);
+    for ( ; end - ptr >= 32; ptr += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        const __m256i folded = _mm256_or_si256(data, lowerCase);
+        const __m256i special = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(data, quote), _mm256_cmpeq_epi8(data, backslash)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(folded, beginObject),
+                                    _mm256_cmpeq_epi8(folded, endObject)));
+        const uint mask = _mm256_movemask_epi8(special);
+        if (!mask && !state.escaped)
+            continue;
+        const int offset = skipStructural(state, ptr, mask, 32);
+        if (offset) {
+            ptr = offset < 0 ? 0 : ptr + offset;
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// ptr points to the opening bracket; returns a pointer past the closing one
+static const char *skipContainer(const char *ptr, const char *end)
+{
+    SkipState state = { 0, false, false };
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(AVX2) && skipContainer_avx2(state, ptr, end))
+        return ptr;
+#endif
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lowerCase = _mm_set1_epi8(0x20);
+    const __m128i beginObject = _mm_set1_epi8(BeginObject);
+    const __m128i endObject = _mm_set1_epi8(EndObject);
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i folded = _mm_or_si128(data, lowerCase);
+        const __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(data, quote), _mm_cmpeq_epi8(data, backslash)),
+                    _mm_or_si128(_mm_cmpeq_epi8(folded, beginObject),
+                                 _mm_cmpeq_epi8(folded, endObject)));
+        const uint mask = _mm_movemask_epi8(special);
+        if (!mask && !state.escaped)
+            continue;
+        const int offset = skipStructural(state, ptr, mask, 16);
+        if (offset)
+            return offset < 0 ? 0 : ptr + offset;
+    }
+#endif
+
+    while (ptr < end) {
+        const int blockSize = int(qMin<qptrdiff>(end - ptr, 32));
+        uint mask = 0;
+        for (int i = 0; i < blockSize; ++i) {
+            const char c = ptr[i] | 0x20;
+            if (ptr[i] == Quote || ptr[i] == '\\' || c == BeginObject || c == EndObject)
+                mask |= 1u << i;
+        }
+        const int offset = skipStructural(state, ptr, mask, blockSize);
+        if (offset)
+            return offset < 0 ? 0 : ptr + offset;
+        ptr += blockSize;
+    }
+    return 0;
+}
+
+// ptr points to the first character of a value; returns 0 on error
+static const char *skipValue(const char *ptr, const char *end)
+{
+    if (ptr >= end)
+        return 0;
+
+    switch (*ptr) {
+    case Quote:
+        return skipString(ptr + 1, end);
+    case BeginArray:
+    case BeginObject:
+        return skipContainer(ptr, end);
+    case EndArray:
+    case EndObject:
+    case NameSeparator:
+    case ValueSeparator:
+        return 0;
+    default:
+        // literals and numbers run up to the next delimiter
+        while (ptr < end && !isWhitespace(*ptr) && *ptr != ValueSeparator
+               && *ptr != EndArray && *ptr != EndObject)
+            ++ptr;
+        return ptr;
+    }
+}
+
+namespace {
+struct LazyMember
+{
+    const char *key;        // - raw key, without the quotes
+    const char *keyEnd;
+    const char *value;
+    const char *valueEnd;
+};
+}
+
+/*
+    Iterates over the members of the object (or the elements of the array)
+    starting at ptr, calling visitor until it returns false. For arrays the key
+    of each member is null. Returns false if the text is malformed.
+*/
+template <typename Visitor>
+static bool forEachMember(const char *ptr, const char *end, Visitor visitor)
+{
+    const bool isObject = (*ptr++ == BeginObject);
+    const char endToken = isObject ? EndObject : EndArray;
+
+    ptr = skipWhitespace(ptr, end);
+    if (ptr < end && *ptr == endToken)
+        return true;
+
+    while (ptr < end) {
+        LazyMember member = { 0, 0, 0, 0 };
+        if (isObject) {
+            if (*ptr != Quote)
+                return false;
+            member.key = ptr + 1;
+            ptr = skipString(member.key, end);
+            if (!ptr)
+                return false;
+            member.keyEnd = ptr - 1;
+            ptr = skipWhitespace(ptr, end);
+            if (ptr >= end || *ptr != NameSeparator)
+                return false;
+            ptr = skipWhitespace(ptr + 1, end);
+        }
+
+        member.value = ptr;
+        ptr = skipValue(ptr, end);
+        if (!ptr)
+            return false;
+        member.valueEnd = ptr;
+        if (!visitor(member))
+            return true;
+
+        ptr = skipWhitespace(ptr, end);
+        if (ptr < end && *ptr == endToken)
+            return true;
+        if (ptr >= end || *ptr != ValueSeparator)
+            return false;
+        ptr = skipWhitespace(ptr + 1, end);
+    }
+    return false;
+}
+
+static QString decodeKey(const LazyMember &member)
+{
+    QString key;
+    if (decodeString(member.key, member.keyEnd, &key) != QJsonParseError::NoError)
+        return QString();
+    return key;
+}
+
+/*!
+    \class QJsonLazyValue
+    \inmodule QtCore
+    \ingroup json
+    \ingroup shared
+    \reentrant
+    \since 5.9
+
+    \brief The QJsonLazyValue class reads values out of a JSON text without
+    parsing all of it.
+
+    QJsonDocument::fromJson() parses the whole text before any value can be
+    read. When only a few values of a large document are needed,
+    QJsonLazyValue avoids most of that work. It refers to a value inside the
+    text; looking up a member with value() or an element with at() skips
+    over everything in front of it without building it, and toValue() then
+    parses just the value at hand into a QJsonValue.
+
+    \code
+        const QJsonLazyValue root(file.readAll());
+        const QJsonLazyValue user = root[QLatin1String("user")];
+        const QString name = user[QLatin1String("name")].toValue().toString();
+        const int id = user[QLatin1String("id")].toValue().toInt();
+    \endcode
+
+    A QJsonLazyValue shares the text with the QByteArray it was created
+    from and with all the values looked up in it, so it is cheap to copy.
+    Each lookup scans the object or array it is made in from its start;
+    keep values that are used repeatedly instead of looking them up again.
+
+    Only the parts of the text that are actually parsed are checked. A
+    lookup in malformed text returns an undefined value, and toValue()
+    reports errors through its QJsonParseError argument, but errors in the
+    parts that are skipped over go unnoticed.
+
+    \sa QJsonDocument, QJsonValue, QJsonStreamReader
+*/
+
+/*!
+    \fn QJsonLazyValue::QJsonLazyValue()
+
+    Creates an undefined value.
+*/
+
+/*!
+    \fn void QJsonLazyValue::swap(QJsonLazyValue &other)
+
+    Swaps this value with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    Creates a value that refers to the JSON text \a json, which holds a
+    single value, usually an object or an array. \a json is not copied and
+    not parsed.
+*/
+QJsonLazyValue::QJsonLazyValue(const QByteArray &json)
+    : json(json), from(0), to(json.size())
+{
+    const char *begin = json.constData();
+    const char *end = begin + json.size();
+    const char *ptr = begin;
+
+    // skip the UTF-8 byte order mark and surrounding whitespace
+    if (end - ptr >= 3 && uchar(ptr[0]) == 0xef && uchar(ptr[1]) == 0xbb && uchar(ptr[2]) == 0xbf)
+        ptr += 3;
+    ptr = skipWhitespace(ptr, end);
+    while (end > ptr && isWhitespace(end[-1]))
+        --end;
+
+    from = int(ptr - begin);
+    to = int(end - begin);
+}
+
+/*!
+    Returns the type of the value, as far as it can be told from its first
+    character, or QJsonValue::Undefined if there is no value.
+
+    \sa isObject(), isArray(), isUndefined()
+*/
+QJsonValue::Type QJsonLazyValue::type() const
+{
+    if (from >= to)
+        return QJsonValue::Undefined;
+
+    switch (json.at(from)) {
+    case BeginObject:
+        return QJsonValue::Object;
+    case BeginArray:
+        return QJsonValue::Array;
+    case Quote:
+        return QJsonValue::String;
+    case 't':
+    case 'f':
+        return QJsonValue::Bool;
+    case 'n':
+        return QJsonValue::Null;
+    case '-':
+    case '.':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return QJsonValue::Double;
+    default:
+        return QJsonValue::Undefined;
+    }
+}
+
+/*!
+    \fn bool QJsonLazyValue::isUndefined() const
+
+    Returns \c true if this is not a value, for example because a member
+    or an element that was looked up does not exist.
+
+    \sa type()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isObject() const
+
+    Returns \c true if the value is an object.
+
+    \sa type()
+*/
+
+/*!
+    \fn bool QJsonLazyValue::isArray() const
+
+    Returns \c true if the value is an array.
+
+    \sa type()
+*/
+
+/*!
+    Returns the number of members of an object or elements of an array as
+    they appear in the text, including members with duplicate keys, and 0
+    for any other value.
+*/
+int QJsonLazyValue::size() const
+{
+    const QJsonValue::Type t = type();
+    if (t != QJsonValue::Object && t != QJsonValue::Array)
+        return 0;
+
+    int count = 0;
+    const char *begin = json.constData();
+    forEachMember(begin + from, begin + to, [&count](const LazyMember &) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+/*!
+    Returns the keys of the members of an object in the order in which they
+    appear in the text, or an empty list if the value is not an object.
+*/
+QStringList QJsonLazyValue::keys() const
+{
+    QStringList list;
+    if (type() != QJsonValue::Object)
+        return list;
+
+    const char *begin = json.constData();
+    forEachMember(begin + from, begin + to, [&list](const LazyMember &member) {
+        list.append(decodeKey(member));
+        return true;
+    });
+    return list;
+}
+
+/*!
+    Returns the value of the member \a key of an object. The value is
+    undefined if the value is not an object or it has no such member.
+
+    Like in QJsonObject, the last of several members with the same key
+    wins, so this always scans the whole object.
+
+    \sa at(), operator[]()
+*/
+QJsonLazyValue QJsonLazyValue::value(const QString &key) const
+{
+    if (type() != QJsonValue::Object)
+        return QJsonLazyValue();
+
+    const QByteArray utf8 = key.toUtf8();
+    const char *begin = json.constData();
+    const char *found = 0;
+    const char *foundEnd = 0;
+    const bool ok = forEachMember(begin + from, begin + to, [&](const LazyMember &member) {
+        const int length = int(member.keyEnd - member.key);
+        const bool escaped = findStringSpecial(member.key, member.keyEnd, false) != member.keyEnd;
+        if (escaped ? decodeKey(member) == key
+                    : (length == utf8.size() && memcmp(member.key, utf8.constData(), length) == 0)) {
+            found = member.value;
+            foundEnd = member.valueEnd;
+        }
+        return true;
+    });
+
+    if (!ok || !found)
+        return QJsonLazyValue();
+    return QJsonLazyValue(json, int(found - begin), int(foundEnd - begin));
+}
+
+/*!
+    Returns the element at index position \a i of an array. The value is
+    undefined if the value is not an array or \a i is out of range.
+
+    \sa value(), operator[]()
+*/
+QJsonLazyValue QJsonLazyValue::at(int i) const
+{
+    if (type() != QJsonValue::Array || i < 0)
+        return QJsonLazyValue();
+
+    const char *begin = json.constData();
+    const char *found = 0;
+    const char *foundEnd = 0;
+    forEachMember(begin + from, begin + to, [&](const LazyMember &member) {
+        if (i-- > 0)
+            return true;
+        found = member.value;
+        foundEnd = member.valueEnd;
+        return false;
+    });
+
+    if (!found)
+        return QJsonLazyValue();
+    return QJsonLazyValue(json, int(found - begin), int(foundEnd - begin));
+}
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](const QString &key) const
+
+    Same as value(\a key).
+*/
+
+/*!
+    \fn QJsonLazyValue QJsonLazyValue::operator[](int i) const
+
+    Same as at(\a i).
+*/
+
+/*!
+    Returns the text of the value, without surrounding whitespace.
+*/
+QByteArray QJsonLazyValue::rawJson() const
+{
+    return json.mid(from, to - from);
+}
+
+/*!
+    Parses the value into a QJsonValue. If the text of the value is not
+    valid JSON, an undefined QJsonValue is returned and, if \a error is not
+    null, the error is reported there, with the offset into the text the
+    value was created from.
+*/
+QJsonValue QJsonLazyValue::toValue(QJsonParseError *error) const
+{
+    const QJsonValue::Type t = type();
+    if (t == QJsonValue::Undefined) {
+        if (error) {
+            error->offset = from;
+            error->error = QJsonParseError::IllegalValue;
+        }
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    if (t == QJsonValue::Object || t == QJsonValue::Array) {
+        Parser parser(json.constData() + from, to - from);
+        const QJsonDocument doc = parser.parse(error);
+        if (error && error->error != QJsonParseError::NoError)
+            error->offset += from;
+        if (doc.isObject())
+            return doc.object();
+        if (doc.isArray())
+            return doc.array();
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    // the parser only accepts objects and arrays at the top level
+    QByteArray wrapped;
+    wrapped.reserve(to - from + 2);
+    wrapped += BeginArray;
+    wrapped += rawJson();
+    wrapped += EndArray;
+    Parser parser(wrapped.constData(), wrapped.size());
+    const QJsonDocument doc = parser.parse(error);
+    if (error && error->error != QJsonParseError::NoError)
+        error->offset += from - 1;
+    if (doc.array().size() != 1)
+        return QJsonValue(QJsonValue::Undefined);
+    return doc.array().at(0);
+}
+
 QT_END_NAMESPACE
@@ -54,6 +54,7 @@
 #include <QtCore/private/qglobal_p.h>
 #include <qjsondocument.h>
 #include <qvarlengtharray.h>
+#include <qvector.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -116,6 +117,9 @@ private:
     }
 };
 
+QJsonParseError::ParseError decodeString(const char *json, const char *end, QString *string);
+const char *scanNumber(const char *json, const char *end, bool *isInt);
+
 }
 
 QT_END_NAMESPACE
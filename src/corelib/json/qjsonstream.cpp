@@ -0,0 +1,1359 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstream.h"
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qbuffer.h>
+#include <qcoreapplication.h>
+#include <qvarlengtharray.h>
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// the same limit as QJsonDocument::fromJson()
+static const int nestingLimit = 1024;
+
+enum {
+    Space = 0x20,
+    Tab = 0x09,
+    LineFeed = 0x0a,
+    Return = 0x0d,
+    BeginArray = 0x5b,
+    BeginObject = 0x7b,
+    EndArray = 0x5d,
+    EndObject = 0x7d,
+    NameSeparator = 0x3a,
+    ValueSeparator = 0x2c,
+    Quote = 0x22
+};
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        ExpectDocument,
+        ExpectValue,
+        ExpectValueOrEnd,
+        ExpectMember,
+        ExpectMemberOrEnd,
+        ExpectSeparatorOrEnd,
+        ExpectEndOfDocument,
+        Done
+    };
+
+    // what becomes of an attempt to read a token
+    enum Result {
+        Complete,
+        NeedMoreData,
+        Failed
+    };
+
+    enum { ChunkSize = 16384 };
+
+    QJsonStreamReaderPrivate() { init(); }
+
+    void init();
+    bool fetchData();
+    int skipWhitespace(int p);
+    void compactBuffer();
+
+    Result readString(int &p, QString *string);
+    Result readScalar(int &p);
+    QJsonStreamReader::TokenType readNext();
+    QJsonStreamReader::TokenType endContainer(int p);
+    QJsonStreamReader::TokenType valueDone(QJsonStreamReader::TokenType token);
+    QJsonStreamReader::TokenType premature();
+    QJsonStreamReader::TokenType notWellFormed(QJsonParseError::ParseError parseError, int p);
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;                // - everything before this has been reported
+    qint64 bufferOffset;    // - offset of the buffer in the stream
+    bool dataAdded;
+    State state;
+    QVarLengthArray<char, 16> stack;
+
+    QJsonStreamReader::TokenType type;
+    QString name;
+    QString text;
+    double number;
+    bool boolean;
+
+    QJsonStreamReader::Error error;
+    QString errorString;
+};
+
+void QJsonStreamReaderPrivate::init()
+{
+    device = 0;
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    dataAdded = false;
+    state = ExpectDocument;
+    stack.clear();
+    type = QJsonStreamReader::NoToken;
+    name.clear();
+    text.clear();
+    number = 0;
+    boolean = false;
+    error = QJsonStreamReader::NoError;
+    errorString.clear();
+}
+
+/*
+    Appends the next chunk of the device to the buffer. Returns false if
+    there is no device or it has no more data for now.
+*/
+bool QJsonStreamReaderPrivate::fetchData()
+{
+    if (!device)
+        return false;
+
+    const int oldSize = buffer.size();
+    if (buffer.capacity() < oldSize + ChunkSize)
+        buffer.reserve(qMax(oldSize + ChunkSize, 2 * buffer.capacity()));
+    buffer.resize(oldSize + ChunkSize);
+    const qint64 bytesRead = device->read(buffer.data() + oldSize, ChunkSize);
+    buffer.resize(oldSize + int(qMax<qint64>(bytesRead, 0)));
+    return bytesRead > 0;
+}
+
+int QJsonStreamReaderPrivate::skipWhitespace(int p)
+{
+    forever {
+        const char *data = buffer.constData();
+        const int size = buffer.size();
+        while (p < size && (data[p] == Space || data[p] == Tab
+                            || data[p] == LineFeed || data[p] == Return))
+            ++p;
+        if (p < size || !fetchData())
+            return p;
+    }
+}
+
+/*
+    Drops the data that has been reported already, so that reading a
+    document needs no more memory than its largest token.
+*/
+void QJsonStreamReaderPrivate::compactBuffer()
+{
+    if (pos < ChunkSize || pos < buffer.size() / 2)
+        return;
+
+    const int remaining = buffer.size() - pos;
+    memmove(buffer.data(), buffer.constData() + pos, remaining);
+    buffer.resize(remaining);
+    bufferOffset += pos;
+    pos = 0;
+}
+
+// p points to the opening quote; on success, it points past the closing one
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::readString(int &p, QString *string)
+{
+    int end = p + 1;
+    forever {
+        const char *data = buffer.constData();
+        const char *quote = static_cast<const char *>(memchr(data + end, Quote, buffer.size() - end));
+        if (quote) {
+            // the quote is escaped if it follows an odd number of backslashes
+            const char *backslash = quote;
+            while (backslash > data + p + 1 && backslash[-1] == '\\')
+                --backslash;
+            end = int(quote - data);
+            if ((quote - backslash) % 2 == 0)
+                break;
+            ++end;
+            continue;
+        }
+        end = buffer.size();
+        if (!fetchData())
+            return NeedMoreData;
+    }
+
+    const char *data = buffer.constData();
+    const QJsonParseError::ParseError parseError =
+            QJsonPrivate::decodeString(data + p + 1, data + end, string);
+    if (parseError != QJsonParseError::NoError) {
+        notWellFormed(parseError, p);
+        return Failed;
+    }
+    p = end + 1;
+    return Complete;
+}
+
+static inline bool isNumberCharacter(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
+// p points to the first character of a value; sets up the token for it
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::readScalar(int &p)
+{
+    const char c = buffer.at(p);
+    switch (c) {
+    case BeginObject:
+        type = QJsonStreamReader::StartObject;
+        ++p;
+        return Complete;
+    case BeginArray:
+        type = QJsonStreamReader::StartArray;
+        ++p;
+        return Complete;
+    case Quote:
+        type = QJsonStreamReader::String;
+        return readString(p, &text);
+    case 't':
+    case 'f':
+    case 'n': {
+        const char *literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        const int length = int(qstrlen(literal));
+        while (buffer.size() - p < length) {
+            if (!fetchData())
+                return NeedMoreData;
+        }
+        if (memcmp(buffer.constData() + p, literal, length) != 0) {
+            notWellFormed(QJsonParseError::IllegalValue, p);
+            return Failed;
+        }
+        type = c == 'n' ? QJsonStreamReader::Null : QJsonStreamReader::Bool;
+        boolean = c == 't';
+        p += length;
+        return Complete;
+    }
+    default:
+        break;
+    }
+
+    // like QJsonDocument::fromJson(), accept a number without an integer part
+    if (c != '-' && c != '.' && (c < '0' || c > '9')) {
+        notWellFormed(QJsonParseError::IllegalValue, p);
+        return Failed;
+    }
+
+    int end = p + 1;
+    forever {
+        while (end < buffer.size() && isNumberCharacter(buffer.at(end)))
+            ++end;
+        if (end < buffer.size() || !fetchData())
+            break;
+    }
+    // a number inside a container is always followed by something, but one
+    // at the top level ends with the data
+    if (end == buffer.size() && !stack.isEmpty())
+        return NeedMoreData;
+
+    // the characters must form a single number, which rules out 01 or 1.2.3
+    const char *digits = buffer.constData() + p;
+    const char *digitsEnd = buffer.constData() + end;
+    bool isInt;
+    if (QJsonPrivate::scanNumber(digits, digitsEnd, &isInt) != digitsEnd) {
+        notWellFormed(QJsonParseError::IllegalNumber, p);
+        return Failed;
+    }
+
+    // integers that are exact in a double don't need the full conversion
+    const bool negative = *digits == '-';
+    if (negative)
+        ++digits;
+    if (isInt && digits < digitsEnd && digitsEnd - digits <= 15) {
+        qint64 n = 0;
+        while (digits < digitsEnd)
+            n = n * 10 + (*digits++ - '0');
+        number = negative ? -double(n) : double(n);
+        type = QJsonStreamReader::Number;
+        p = end;
+        return Complete;
+    }
+
+    bool ok;
+    number = QByteArray::fromRawData(buffer.constData() + p, end - p).toDouble(&ok);
+    if (!ok) {
+        notWellFormed(QJsonParseError::IllegalNumber, p);
+        return Failed;
+    }
+    type = QJsonStreamReader::Number;
+    p = end;
+    return Complete;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::premature()
+{
+    error = QJsonStreamReader::PrematureEndOfDocumentError;
+    errorString = QCoreApplication::translate("QJsonStreamReader", "Premature end of document.");
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::notWellFormed(QJsonParseError::ParseError parseError, int p)
+{
+    QJsonParseError e;
+    e.offset = 0;
+    e.error = parseError;
+    error = QJsonStreamReader::NotWellFormedError;
+    errorString = e.errorString();
+    pos = p;
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::valueDone(QJsonStreamReader::TokenType token)
+{
+    state = stack.isEmpty() ? ExpectEndOfDocument : ExpectSeparatorOrEnd;
+    return type = token;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(int p)
+{
+    const bool isObject = stack.last() == BeginObject;
+    stack.removeLast();
+    pos = p;
+    name.clear();
+    return valueDone(isObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray);
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error == QJsonStreamReader::PrematureEndOfDocumentError) {
+        error = QJsonStreamReader::NoError;
+        errorString.clear();
+    } else if (error != QJsonStreamReader::NoError) {
+        return type = QJsonStreamReader::Invalid;
+    }
+    dataAdded = false;
+
+    if (state == Done)
+        return type = QJsonStreamReader::EndDocument;
+    if (state == ExpectDocument) {
+        state = ExpectValue;
+        return type = QJsonStreamReader::StartDocument;
+    }
+
+    compactBuffer();
+    int p = skipWhitespace(pos);
+    if (p == buffer.size()) {
+        if (state != ExpectEndOfDocument)
+            return premature();
+        pos = p;
+        state = Done;
+        name.clear();
+        return type = QJsonStreamReader::EndDocument;
+    }
+
+    char c = buffer.at(p);
+    switch (state) {
+    case ExpectEndOfDocument:
+        return notWellFormed(QJsonParseError::GarbageAtEnd, p);
+    case ExpectSeparatorOrEnd: {
+        const bool isObject = stack.last() == BeginObject;
+        if (c == (isObject ? EndObject : EndArray))
+            return endContainer(p + 1);
+        if (c != ValueSeparator)
+            return notWellFormed(isObject ? QJsonParseError::UnterminatedObject
+                                          : QJsonParseError::MissingValueSeparator, p);
+
+        // the separator is not a token of its own
+        pos = p + 1;
+        state = isObject ? ExpectMember : ExpectValue;
+        p = skipWhitespace(pos);
+        if (p == buffer.size())
+            return premature();
+        c = buffer.at(p);
+        if (isObject && c == EndObject)
+            return notWellFormed(QJsonParseError::MissingObject, p);
+        break;
+    }
+    case ExpectValueOrEnd:
+        if (c == EndArray)
+            return endContainer(p + 1);
+        break;
+    case ExpectMemberOrEnd:
+        if (c == EndObject)
+            return endContainer(p + 1);
+        break;
+    default:
+        break;
+    }
+
+    // nothing is committed until the whole token, including the name of
+    // an object member, has been read
+    QString key;
+    if (state == ExpectMember || state == ExpectMemberOrEnd) {
+        if (c != Quote)
+            return notWellFormed(QJsonParseError::UnterminatedObject, p);
+        switch (readString(p, &key)) {
+        case NeedMoreData:
+            return premature();
+        case Failed:
+            return type;
+        case Complete:
+            break;
+        }
+        p = skipWhitespace(p);
+        if (p == buffer.size())
+            return premature();
+        if (buffer.at(p) != NameSeparator)
+            return notWellFormed(QJsonParseError::MissingNameSeparator, p);
+        p = skipWhitespace(p + 1);
+        if (p == buffer.size())
+            return premature();
+    }
+
+    switch (readScalar(p)) {
+    case NeedMoreData:
+        return premature();
+    case Failed:
+        return type;
+    case Complete:
+        break;
+    }
+
+    pos = p;
+    name = key;
+    if (type == QJsonStreamReader::StartObject || type == QJsonStreamReader::StartArray) {
+        if (stack.size() >= nestingLimit)
+            return notWellFormed(QJsonParseError::DeepNesting, p - 1);
+        stack.append(type == QJsonStreamReader::StartObject ? BeginObject : BeginArray);
+        state = type == QJsonStreamReader::StartObject ? ExpectMemberOrEnd : ExpectValueOrEnd;
+        return type;
+    }
+    return valueDone(type);
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.9
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON via a simple streaming API.
+
+    QJsonStreamReader reads a JSON document one token at a time, either from
+    a QIODevice (see setDevice()), or from a QByteArray (see addData()).
+    Unlike QJsonDocument::fromJson(), it never holds more of the document in
+    memory than the token it is reporting, so it can process documents of
+    any size.
+
+    Qt provides QJsonStreamWriter for writing JSON.
+
+    Like QXmlStreamReader, the application drives the loop and pulls tokens
+    from the reader by calling readNext(). The values of objects and arrays
+    are reported in document order; for members of an object, name() holds
+    the member's name. A typical loop looks like this:
+
+    \code
+        QJsonStreamReader reader(&file);
+        while (!reader.atEnd()) {
+            reader.readNext();
+            if (reader.isString() && reader.name() == QLatin1String("message"))
+                process(reader.text());
+        }
+        if (reader.hasError()) {
+            ... // do error handling
+        }
+    \endcode
+
+    readCurrentValue() reads a whole object or array at once, which makes it
+    easy to process a long array of small records one record at a time.
+
+    A document consists of a single value, which does not need to be an
+    object or an array. QJsonStreamReader is an incremental parser: when it
+    runs out of data in the middle of a document, it reports a
+    PrematureEndOfDocumentError, and continues with the next call to
+    readNext() once more data has arrived through addData() or the device().
+
+    \sa QJsonDocument, QJsonStreamWriter, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything.
+    \value Invalid An error has occurred, reported in error() and
+           errorString().
+    \value StartDocument The reader reports the start of the document.
+    \value EndDocument The reader reports the end of the document.
+    \value StartObject The reader reports the start of an object.
+    \value EndObject The reader reports the end of an object.
+    \value StartArray The reader reports the start of an array.
+    \value EndArray The reader reports the end of an array.
+    \value String The reader reports a string, see text().
+    \value Number The reader reports a number, see toDouble().
+    \value Bool The reader reports \c true or \c false, see toBool().
+    \value Null The reader reports \c null.
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies the different error cases.
+
+    \value NoError No error has occurred.
+    \value CustomError A custom error has been raised with raiseError().
+    \value NotWellFormedError The parser internally raised an error due to
+           the read JSON not being valid.
+    \value PrematureEndOfDocumentError The input stream ended before the
+           document was complete. This error is not fatal; see the class
+           documentation.
+*/
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \sa addData(), clear(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    addData(data);
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device. Setting the device resets the
+    stream to its initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamReader, or 0
+    if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing if
+    the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->buffer += data;
+    d->dataAdded = !data.isEmpty();
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the JSON
+    document, or if an error() has occurred and reading has been aborted.
+    Otherwise, it returns \c false.
+
+    When atEnd() and hasError() return true and error() returns
+    PrematureEndOfDocumentError, it means the document has been incomplete
+    so far. To continue reading, either add more data through addData(), or
+    wait until more data is available on the device().
+
+    \sa hasError(), error(), device(), QIODevice::atEnd()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->type == Invalid && d->error == PrematureEndOfDocumentError)
+        return d->device ? d->device->atEnd() : !d->dataAdded;
+    return d->type == EndDocument || d->type == Invalid;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    With one exception, once an error() is reported by readNext(), further
+    reading of the JSON stream is not possible. Then atEnd() returns \c true,
+    hasError() returns \c true, and this function returns
+    QJsonStreamReader::Invalid.
+
+    The exception is when error() returns PrematureEndOfDocumentError. This
+    error is reported when the end of an otherwise valid document is
+    reached, but the document is not complete yet. In that case, the next
+    call to readNext() continues where the reader left off.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    return d->readNext();
+}
+
+/*!
+    Reads the current value completely and returns it. If the current token
+    is StartObject or StartArray, all of the object or array is read and the
+    reader is left on the matching EndObject or EndArray token.
+
+    Returns an undefined value if the current token is not a value or if an
+    error occurs while reading. A PrematureEndOfDocumentError in the middle
+    of an object or array loses the part of it that has been read so far;
+    use readNext() to read incomplete data as it arrives.
+
+    \sa skipCurrentValue(), value()
+*/
+QJsonValue QJsonStreamReader::readCurrentValue()
+{
+    switch (tokenType()) {
+    case StartObject: {
+        QJsonObject object;
+        while (readNext() != EndObject) {
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            const QString key = name();
+            object.insert(key, readCurrentValue());
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+        }
+        return object;
+    }
+    case StartArray: {
+        QJsonArray array;
+        while (readNext() != EndArray) {
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+            array.append(readCurrentValue());
+            if (hasError())
+                return QJsonValue(QJsonValue::Undefined);
+        }
+        return array;
+    }
+    default:
+        return value();
+    }
+}
+
+/*!
+    Reads until the end of the current object or array, skipping any
+    nested values. Does nothing if the current token is not StartObject or
+    StartArray.
+
+    \sa readCurrentValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    if (tokenType() != StartObject && tokenType() != StartArray)
+        return;
+
+    int depth = 1;
+    while (depth && readNext() != Invalid) {
+        if (isStartObject() || isStartArray())
+            ++depth;
+        else if (isEndObject() || isEndArray())
+            --depth;
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+static const char QJsonStreamReader_tokenTypeString[] =
+    "NoToken\0"
+    "Invalid\0"
+    "StartDocument\0"
+    "EndDocument\0"
+    "StartObject\0"
+    "EndObject\0"
+    "StartArray\0"
+    "EndArray\0"
+    "String\0"
+    "Number\0"
+    "Bool\0"
+    "Null\0";
+
+static const short QJsonStreamReader_tokenTypeString_indices[] = {
+    0, 8, 16, 30, 42, 54, 64, 75, 84, 91, 98, 103, 0
+};
+
+/*!
+    Returns the reader's current token as string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    Q_D(const QJsonStreamReader);
+    return QLatin1String(QJsonStreamReader_tokenTypeString +
+                         QJsonStreamReader_tokenTypeString_indices[d->type]);
+}
+
+/*!
+    Returns the number of objects and arrays that are open at the current
+    token. A StartObject or StartArray token counts its own container, an
+    EndObject or EndArray token does not.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->stack.size();
+}
+
+/*!
+    Returns the offset in bytes after the current token. If an error
+    occurred, it is the offset at which it was detected.
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the name of the current value if it is a member of an object.
+    Otherwise, returns a null string.
+
+    \sa text()
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->name;
+}
+
+/*!
+    Returns the string if the current token is a String. Otherwise, returns
+    a null string.
+
+    \sa name(), value()
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == String ? d->text : QString();
+}
+
+/*!
+    Returns the number if the current token is a Number. Otherwise, returns
+    0.
+
+    \sa value()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number ? d->number : 0;
+}
+
+/*!
+    Returns \c true if the current token is a Bool that is \c true.
+    Otherwise, returns \c false.
+
+    \sa value()
+*/
+bool QJsonStreamReader::toBool() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the current token as a QJsonValue if it is a String, Number,
+    Bool or Null. Otherwise, returns an undefined value.
+
+    \sa readCurrentValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case String:
+        return d->text;
+    case Number:
+        return d->number;
+    case Bool:
+        return d->boolean;
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Raises a custom error with an optional error \a message.
+
+    \sa error(), errorString()
+*/
+void QJsonStreamReader::raiseError(const QString &message)
+{
+    Q_D(QJsonStreamReader);
+    d->error = CustomError;
+    d->errorString = message;
+    if (d->errorString.isNull())
+        d->errorString = QCoreApplication::translate("QJsonStreamReader", "Invalid document.");
+    d->type = Invalid;
+}
+
+/*!
+    Returns the error message that was set with raiseError().
+
+    \sa error(), characterOffset()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Invalid ? d->errorString : QString();
+}
+
+/*!
+    Returns the type of the current error, or NoError if no error occurred.
+
+    \sa errorString(), raiseError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Invalid ? d->error : NoError;
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa errorString(), error()
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container
+    {
+        bool isObject;
+        bool hasMembers;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(0), deleteDevice(false), autoFormatting(false), hasError(false) {}
+    ~QJsonStreamWriterPrivate()
+    {
+        if (deleteDevice)
+            delete device;
+    }
+
+    void write(const char *data, int size);
+    inline void write(const QByteArray &data) { write(data.constData(), data.size()); }
+    bool startValue(const QString *name);
+    void endValue();
+    void writeStart(bool isObject, const QString *name);
+    void writeEnd(bool isObject);
+    void writeValue(const QString *name, const QJsonValue &value);
+
+    QIODevice *device;
+    bool deleteDevice;
+    bool autoFormatting;
+    bool hasError;
+    QVarLengthArray<Container, 16> stack;
+};
+
+void QJsonStreamWriterPrivate::write(const char *data, int size)
+{
+    if (!device || hasError)
+        return;
+    if (device->write(data, size) != size)
+        hasError = true;
+}
+
+/*
+    Writes what comes before a value: the separator, the indentation and
+    the name, if the value is a member of an object. The output has the
+    same layout as QJsonDocument::toJson().
+*/
+bool QJsonStreamWriterPrivate::startValue(const QString *name)
+{
+    if (stack.isEmpty()) {
+        if (name)
+            qWarning("QJsonStreamWriter: the value at the top level cannot have a name");
+        return true;
+    }
+
+    Container &container = stack.last();
+    if (container.isObject && !name) {
+        qWarning("QJsonStreamWriter: a member of an object needs a name");
+        return false;
+    }
+    if (!container.isObject && name)
+        qWarning("QJsonStreamWriter: ignoring the name of an element of an array");
+
+    if (container.hasMembers)
+        write(autoFormatting ? ",\n" : ",", autoFormatting ? 2 : 1);
+    container.hasMembers = true;
+    if (autoFormatting)
+        write(QByteArray(4 * stack.size(), ' '));
+    if (container.isObject) {
+        write("\"", 1);
+        write(QJsonPrivate::Writer::escapedString(*name));
+        write(autoFormatting ? "\": " : "\":", autoFormatting ? 3 : 2);
+    }
+    return true;
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (stack.isEmpty() && autoFormatting)
+        write("\n", 1);
+}
+
+void QJsonStreamWriterPrivate::writeStart(bool isObject, const QString *name)
+{
+    if (!startValue(name))
+        return;
+    write(isObject ? "{" : "[", 1);
+    if (autoFormatting)
+        write("\n", 1);
+    const Container container = { isObject, false };
+    stack.append(container);
+}
+
+void QJsonStreamWriterPrivate::writeEnd(bool isObject)
+{
+    if (stack.isEmpty() || stack.last().isObject != isObject) {
+        qWarning(isObject ? "QJsonStreamWriter: no object to end" : "QJsonStreamWriter: no array to end");
+        return;
+    }
+
+    const Container container = stack.last();
+    stack.removeLast();
+    if (autoFormatting) {
+        if (container.hasMembers)
+            write("\n", 1);
+        write(QByteArray(4 * stack.size(), ' '));
+    }
+    write(isObject ? "}" : "]", 1);
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::writeValue(const QString *name, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        writeStart(true, name);
+        for (QJsonObject::const_iterator it = object.begin(); it != object.end(); ++it) {
+            const QString key = it.key();
+            writeValue(&key, it.value());
+        }
+        writeEnd(true);
+        return;
+    }
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        writeStart(false, name);
+        for (const QJsonValue &element : array)
+            writeValue(0, element);
+        writeEnd(false);
+        return;
+    }
+    case QJsonValue::Undefined:
+        qWarning("QJsonStreamWriter: cannot write an undefined value");
+        return;
+    default:
+        break;
+    }
+
+    if (!startValue(name))
+        return;
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        if (value.toBool())
+            write("true", 4);
+        else
+            write("false", 5);
+        break;
+    case QJsonValue::Double:
+        write(QJsonPrivate::Writer::doubleToJson(value.toDouble()));
+        break;
+    case QJsonValue::String:
+        write("\"", 1);
+        write(QJsonPrivate::Writer::escapedString(value.toString()));
+        write("\"", 1);
+        break;
+    default:
+        write("null", 4);
+        break;
+    }
+    endValue();
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.9
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a simple
+    streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader for writing
+    JSON. It writes directly to a QIODevice (see setDevice()) as the
+    document is being produced, so that documents of any size can be written
+    without building them in memory first.
+
+    Objects and arrays are opened with writeStartObject() and
+    writeStartArray() and closed with writeEndObject() and writeEndArray().
+    Values are written with writeValue(); the members of objects take a
+    name. writeValue() also writes whole QJsonObject and QJsonArray values.
+
+    \code
+        QJsonStreamWriter writer(&file);
+        writer.setAutoFormatting(true);
+        writer.writeStartObject();
+        writer.writeValue("version", 2);
+        writer.writeStartArray("records");
+        for (const Record &record : records)
+            writer.writeValue(record.toJson());
+        writer.writeEndDocument();
+    \endcode
+
+    The output has the same layout as QJsonDocument::toJson(): the compact
+    format by default, or the indented format if autoFormatting() is
+    enabled.
+
+    \sa QJsonStreamReader, QJsonDocument
+*/
+
+/*!
+    Constructs a stream writer.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->device = device;
+}
+
+/*!
+    Constructs a stream writer that writes into \a array. This is the same
+    as creating a JSON writer that operates on a QBuffer device which in
+    turn operates on \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->device = new QBuffer(array);
+    d->device->open(QIODevice::WriteOnly);
+    d->deleteDevice = true;
+}
+
+/*!
+    Destructor.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+}
+
+/*!
+    Sets the current device to \a device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    if (device == d->device)
+        return;
+    if (d->deleteDevice) {
+        delete d->device;
+        d->deleteDevice = false;
+    }
+    d->device = device;
+    d->hasError = false;
+    d->stack.clear();
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamWriter, or 0
+    if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Enables auto formatting if \a enable is \c true, otherwise disables it.
+
+    With auto formatting, the output is indented by four spaces per level
+    and every member of an object or array is on a line of its own, like
+    QJsonDocument::Indented. The default is the compact format.
+
+    \sa autoFormatting()
+*/
+void QJsonStreamWriter::setAutoFormatting(bool enable)
+{
+    Q_D(QJsonStreamWriter);
+    d->autoFormatting = enable;
+}
+
+/*!
+    Returns \c true if auto formatting is enabled, otherwise \c false.
+
+    \sa setAutoFormatting()
+*/
+bool QJsonStreamWriter::autoFormatting() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->autoFormatting;
+}
+
+/*!
+    Writes the start of an object. If the object is a member of another
+    object, use the overload that takes a name instead.
+
+    \sa writeEndObject()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(true, 0);
+}
+
+/*!
+    \overload
+
+    Writes the start of an object that is the member \a name of the current
+    object.
+*/
+void QJsonStreamWriter::writeStartObject(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(true, &name);
+}
+
+/*!
+    Closes the object opened with writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd(true);
+}
+
+/*!
+    Writes the start of an array. If the array is a member of an object, use
+    the overload that takes a name instead.
+
+    \sa writeEndArray()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(false, 0);
+}
+
+/*!
+    \overload
+
+    Writes the start of an array that is the member \a name of the current
+    object.
+*/
+void QJsonStreamWriter::writeStartArray(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(false, &name);
+}
+
+/*!
+    Closes the array opened with writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd(false);
+}
+
+/*!
+    Writes \a value as an element of the current array, or as the value of
+    the document. Objects and arrays are written completely.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(0, value);
+}
+
+/*!
+    \overload
+
+    Writes \a value as the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeValue(const QString &name, const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(&name, value);
+}
+
+/*!
+    Closes all remaining open objects and arrays.
+*/
+void QJsonStreamWriter::writeEndDocument()
+{
+    Q_D(QJsonStreamWriter);
+    while (!d->stack.isEmpty())
+        d->writeEnd(d->stack.last().isObject);
+}
+
+/*!
+    Writes the current token of \a reader. This allows filtering a document
+    while copying it, without holding it in memory.
+
+    \sa QJsonStreamReader::tokenType()
+*/
+void QJsonStreamWriter::writeCurrentToken(const QJsonStreamReader &reader)
+{
+    Q_D(QJsonStreamWriter);
+    const bool inObject = !d->stack.isEmpty() && d->stack.last().isObject;
+    const QString name = reader.name();
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject:
+        d->writeStart(true, inObject ? &name : 0);
+        break;
+    case QJsonStreamReader::EndObject:
+        d->writeEnd(true);
+        break;
+    case QJsonStreamReader::StartArray:
+        d->writeStart(false, inObject ? &name : 0);
+        break;
+    case QJsonStreamReader::EndArray:
+        d->writeEnd(false);
+        break;
+    case QJsonStreamReader::String:
+    case QJsonStreamReader::Number:
+    case QJsonStreamReader::Bool:
+    case QJsonStreamReader::Null:
+        d->writeValue(inObject ? &name : 0, reader.value());
+        break;
+    case QJsonStreamReader::EndDocument:
+        writeEndDocument();
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+    Returns \c true if writing failed.
+
+    This can happen if the stream failed to write to the underlying device.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+QT_END_NAMESPACE
@@ -55,7 +55,7 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(const QString &s)
 {
     const uchar replacement = '?';
     QByteArray ba(s.length(), Qt::Uninitialized);
@@ -120,6 +120,13 @@ static QByteArray escapedString(const QString &s)
     return ba;
 }
 
+QByteArray Writer::doubleToJson(double d)
+{
+    if (qIsFinite(d)) // +2 to format to ensure the expected precision
+        return QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    return QByteArrayLiteral("null"); // +INF || -INF || NaN (see RFC4627#section2.4)
+}
+
 static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &v, QByteArray &json, int indent, bool compact)
 {
     QJsonValue::Type type = (QJsonValue::Type)(uint)v.type;
@@ -127,17 +134,12 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
     case QJsonValue::Bool:
         json += v.toBoolean() ? "true" : "false";
         break;
-    case QJsonValue::Double: {
-        const double d = v.toDouble(b);
-        if (qIsFinite(d)) // +2 to format to ensure the expected precision
-            json += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
-        else
-            json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+    case QJsonValue::Double:
+        json += Writer::doubleToJson(v.toDouble(b));
         break;
-    }
     case QJsonValue::String:
         json += '"';
-        json += escapedString(v.toString(b));
+        json += Writer::escapedString(v.toString(b));
         json += '"';
         break;
     case QJsonValue::Array:
@@ -193,7 +195,7 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
         QJsonPrivate::Entry *e = o->entryAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(e->key());
+        json += Writer::escapedString(e->key());
         json += compact ? "\":" : "\": ";
         valueToJson(o, e->value, json, indent, compact);
 
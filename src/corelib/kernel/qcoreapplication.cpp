@@ -491,7 +491,11 @@ void QCoreApplicationPrivate::createEventDispatcher()
     else
         eventDispatcher = new QEventDispatcherUNIX(q);
 #  elif !defined(QT_NO_GLIB)
-    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
+    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
+#    if QT_CONFIG(epoll)
+        && qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") <= 0
+#    endif
+        && QEventDispatcherGlib::versionSupported())
         eventDispatcher = new QEventDispatcherGlib(q);
     else
         eventDispatcher = new QEventDispatcherUNIX(q);
@@ -1435,6 +1439,160 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+  \internal
+
+  Queues the call \a event of a batched connection (Qt::BatchedConnection) to
+  the thread \a receiver lives in, without going through its posted event list
+  in the common case: each thread sends its calls to another thread through a
+  queue of its own, and the receiving thread is only woken up when nothing was
+  pending for it yet.
+
+  Must not be called with a signal-slot lock held, since \a event is deleted
+  if the receiver is already gone.
+*/
+void QCoreApplicationPrivate::postBatchedMetaCall(QMetaCallReceiver *receiver, QMetaCallEvent *event)
+{
+    QThreadData *current = QThreadData::current();
+    QThreadData *data;
+    {
+        // the receiver keeps the thread it lives in alive until it leaves it,
+        // which it can only do with its mutex locked
+        QMutexLocker locker(&receiver->mutex);
+        data = receiver->threadData.load();
+        if (!data) {
+            // the receiver was destroyed
+            locker.unlock();
+            delete event;
+            return;
+        }
+        if (data == current) {
+            // the receiver lives in this thread, and cannot leave it behind our back
+            locker.unlock();
+            QCoreApplication::postEvent(receiver->object, event);
+            return;
+        }
+        data->ref();
+    }
+
+    // forget about the threads that are gone while looking for our queue
+    QMetaCallQueue *queue = 0;
+    QVector<QMetaCallQueue *> &outgoing = current->outgoingMetaCalls;
+    for (int i = 0; i < outgoing.size(); ) {
+        QMetaCallQueue *q = outgoing.at(i);
+        QThreadData *consumer = q->consumer.loadAcquire();
+        if (!consumer) {
+            outgoing.remove(i);
+            if (!q->ref.deref())
+                delete q;
+            continue;
+        }
+        if (consumer == data)
+            queue = q;
+        ++i;
+    }
+
+    if (!queue) {
+        queue = new QMetaCallQueue(data);
+        {
+            QMutexLocker locker(&data->postEventList.mutex);
+            queue->ref.ref();
+            data->incomingMetaCalls.append(queue);
+        }
+        outgoing.append(queue);
+    }
+
+    receiver->ref.ref();
+    queue->enqueue(receiver, event);
+
+    if (data->metaCallsPending.fetchAndStoreOrdered(1) == 0) {
+        {
+            QMutexLocker locker(&data->postEventList.mutex);
+            data->canWait = false;
+        }
+        QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+    }
+
+    data->deref();
+}
+
+/*!
+  \internal
+
+  Delivers the batched calls queued to the thread \a data, which must be the
+  current thread. Calls to receivers that have moved to another thread since
+  they were queued are forwarded there.
+*/
+void QCoreApplicationPrivate::sendBatchedMetaCalls(QThreadData *data)
+{
+    if (!data->metaCallsPending.fetchAndStoreOrdered(0))
+        return;
+
+    QVarLengthArray<QMetaCallQueue *, 16> queues;
+    {
+        QMutexLocker locker(&data->postEventList.mutex);
+        QVector<QMetaCallQueue *> &incoming = data->incomingMetaCalls;
+        for (int i = 0; i < incoming.size(); ) {
+            QMetaCallQueue *queue = incoming.at(i);
+            if (queue->ref.load() == 1 && queue->isEmpty()) {
+                // the sending thread has given up on this queue
+                incoming.remove(i);
+                delete queue;
+                continue;
+            }
+            queue->ref.ref();
+            queues.append(queue);
+            ++i;
+        }
+    }
+
+    // Exception-safe cleaning up without the need for a try/catch block
+    struct CleanUp {
+        QThreadData *data;
+        QVarLengthArray<QMetaCallQueue *, 16> &queues;
+        bool exceptionCaught;
+
+        inline CleanUp(QThreadData *data, QVarLengthArray<QMetaCallQueue *, 16> &queues) :
+            data(data), queues(queues), exceptionCaught(true)
+        {}
+        inline ~CleanUp()
+        {
+            if (exceptionCaught) {
+                // since we were interrupted, we need another pass to deliver the rest
+                data->metaCallsPending.store(1);
+            }
+            for (QMetaCallQueue *queue : queues) {
+                if (!queue->ref.deref())
+                    delete queue;
+            }
+        }
+    };
+    CleanUp cleanup(data, queues);
+
+    for (QMetaCallQueue *queue : queues) {
+        // avoid live-lock: leave what is queued while we deliver for the next pass
+        const quint32 until = queue->published();
+        QMetaCallQueue::Entry entry;
+        while (queue->dequeue(until, &entry)) {
+            struct ReceiverDeref {
+                QMetaCallReceiver *receiver;
+                ~ReceiverDeref() { receiver->deref(); }
+            } receiverDeref = { entry.receiver };
+            QScopedPointer<QEvent> event(entry.event);
+
+            QThreadData *receiverData = entry.receiver->threadData.load();
+            if (receiverData == data)
+                QCoreApplication::sendEvent(entry.receiver->object, event.data());
+            else if (receiverData)
+                postBatchedMetaCall(entry.receiver, static_cast<QMetaCallEvent *>(event.take()));
+        }
+    }
+
+    cleanup.exceptionCaught = false;
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1516,6 +1674,9 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
         return;
     }
 
+    if (!receiver && (!event_type || event_type == QEvent::MetaCall))
+        sendBatchedMetaCalls(data);
+
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
@@ -1523,7 +1684,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
     // events, canWait will be set to false.
-    data->canWait = (data->postEventList.size() == 0);
+    data->canWait = (data->postEventList.size() == 0 && !data->metaCallsPending.load());
 
     if (data->postEventList.size() == 0 || (receiver && !receiver->d_func()->postedEvents)) {
         --data->postEventList.recursion;
@@ -118,6 +118,8 @@ public:
     static bool threadRequiresCoreApplication();
 
     static void sendPostedEvents(QObject *receiver, int event_type, QThreadData *data);
+    static void postBatchedMetaCall(QMetaCallReceiver *receiver, QMetaCallEvent *event);
+    static void sendBatchedMetaCalls(QThreadData *data);
 
     static void checkReceiverThread(QObject *receiver);
     void cleanupThreadData();
@@ -55,6 +55,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
@@ -223,17 +225,192 @@ int QThreadPipe::check(const pollfd &pfd)
 }
 
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
+#if QT_CONFIG(epoll)
+    : epollFd(-1)
+#endif
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0 && !initEpoll())
+        perror("QEventDispatcherUNIXPrivate(): Unable to create epoll instance, using poll()");
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
 
+#if QT_CONFIG(epoll)
+static inline quint32 pollToEpollEvents(short events)
+{
+    return ((events & POLLIN) ? quint32(EPOLLIN) : 0u)
+         | ((events & POLLOUT) ? quint32(EPOLLOUT) : 0u)
+         | ((events & POLLPRI) ? quint32(EPOLLPRI) : 0u);
+}
+
+static inline short epollToPollEvents(quint32 events)
+{
+    return ((events & EPOLLIN) ? POLLIN : 0)
+         | ((events & EPOLLOUT) ? POLLOUT : 0)
+         | ((events & EPOLLPRI) ? POLLPRI : 0)
+         | ((events & EPOLLHUP) ? POLLHUP : 0)
+         | ((events & EPOLLERR) ? POLLERR : 0);
+}
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1)
+        return false;
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, threadPipe.fds[0], &ev) == -1) {
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+    Replaces the interest set with a new one built from socketNotifiers. A
+    descriptor that was closed while its open file description lives on in
+    another process or descriptor stays in the old set, and cannot be removed
+    from it any more, as epoll_ctl() needs the descriptor to find it.
+*/
+void QEventDispatcherUNIXPrivate::rebuildEpoll()
+{
+    qt_safe_close(epollFd);
+    if (!initEpoll()) {
+        perror("QEventDispatcherUNIXPrivate: Unable to recreate epoll instance, using poll()");
+        return;
+    }
+
+    for (auto it = socketNotifiers.cbegin(); it != socketNotifiers.cend(); ++it) {
+        updateEpollInterest(it.key(), 0, it.value().events());
+        if (epollFd < 0)
+            return;
+    }
+}
+
+/*
+    Keeps the epoll interest set in sync with socketNotifiers. Unlike the
+    poll() backend, which rebuilds pollfds on every iteration, this is only
+    called when a notifier is registered or unregistered.
+*/
+void QEventDispatcherUNIXPrivate::updateEpollInterest(int fd, short oldEvents, short newEvents)
+{
+    Q_ASSERT(epollFd >= 0);
+
+    if (newEvents == 0) {
+        // fails with EBADF or ENOENT if the socket was closed before its
+        // notifiers were disabled, which is harmless
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    epoll_event ev;
+    ev.events = pollToEpollEvents(newEvents);
+    ev.data.u64 = 0;
+    ev.data.fd = fd;
+
+    int op = oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+        return;
+
+    if (errno == ENOENT || errno == EEXIST) {
+        // the descriptor was closed and reused behind our back
+        op = (op == EPOLL_CTL_MOD) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+            return;
+    }
+
+    if (errno == EPERM) {
+        // regular files and directories cannot be watched with epoll(7), but
+        // poll(2) reports them as always ready; switch back to poll() for good
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return;
+    }
+
+    qErrnoWarning("QSocketNotifier: Unable to watch socket %d", fd);
+}
+
+/*
+    Waits on the persistent interest set and translates the ready descriptors
+    into pollfds, so that the remainder of processEvents() can be shared with
+    the poll() backend. As with qt_safe_poll(), the thread pipe is always the
+    last entry. The cost is proportional to the number of ready descriptors,
+    not to the number of registered ones.
+*/
+int QEventDispatcherUNIXPrivate::epollWait(const timespec *timeout)
+{
+    int msecs = -1;
+    if (timeout) {
+        // round up so that we don't wake up before the next timer is due
+        const qint64 ms = qint64(timeout->tv_sec) * 1000 + (timeout->tv_nsec + 999999) / 1000000;
+        msecs = int(qMin<qint64>(ms, std::numeric_limits<int>::max()));
+    }
+
+    // level-triggered, so whatever doesn't fit is reported on the next call
+    const int maxEvents = qMin(socketNotifiers.size() + 1, 1024);
+    if (epollEvents.size() < maxEvents)
+        epollEvents.resize(maxEvents);
+
+    const int nready = epoll_wait(epollFd, epollEvents.data(), maxEvents, msecs);
+
+    pollfd pipefd = threadPipe.prepare();
+    pollfds.clear();
+
+    if (nready == -1 && errno != EINTR)
+        perror("epoll_wait");
+
+    bool stale = false;
+    for (int i = 0; i < nready; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        if (ev.data.fd == pipefd.fd) {
+            pipefd.revents = epollToPollEvents(ev.events);
+            continue;
+        }
+
+        if (!socketNotifiers.contains(ev.data.fd)) {
+            // left behind by a descriptor that was closed before its
+            // notifiers were unregistered, or by one that has been reused
+            if (epoll_ctl(epollFd, EPOLL_CTL_DEL, ev.data.fd, nullptr) == -1)
+                stale = true;
+            continue;
+        }
+
+        pollfd pfd = qt_make_pollfd(ev.data.fd, 0);
+        pfd.revents = epollToPollEvents(ev.events);
+        // poll() reports a closed descriptor as POLLNVAL, epoll keeps
+        // reporting the file it referred to
+        if (fcntl(pfd.fd, F_GETFD) == -1 && errno == EBADF)
+            pfd.revents |= POLLNVAL;
+        pollfds.append(pfd);
+    }
+
+    if (stale)
+        rebuildEpoll();
+
+    pollfds.append(pipefd);
+    return qMax(nready, 0);
+}
+#endif // QT_CONFIG(epoll)
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -256,7 +433,8 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
             continue;
 
         auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
+        if (it == socketNotifiers.end())
+            continue;
 
         const QSocketNotifierSetUNIX &sn_set = it.value();
 
@@ -411,7 +589,16 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0 && oldEvents != sn_set.events())
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,8 +637,17 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = nullptr;
 
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0)
+        d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -485,19 +681,30 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+    int nready;
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0 && include_notifiers) {
+        nready = d->epollWait(tm);
+    } else
+#endif
+    {
+        d->pollfds.clear();
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
 
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        nready = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm);
+    }
 
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+    switch (nready) {
     case -1:
         perror("qt_safe_poll");
         break;
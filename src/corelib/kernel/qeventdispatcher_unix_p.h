@@ -59,6 +59,10 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -141,9 +145,23 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void rebuildEpoll();
+    void updateEpollInterest(int fd, short oldEvents, short newEvents);
+    int epollWait(const timespec *timeout);
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
+#if QT_CONFIG(epoll)
+    // persistent interest set, kept in sync with socketNotifiers;
+    // -1 if the poll() backend is in use
+    int epollFd;
+    QVector<epoll_event> epollEvents;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QVector<QSocketNotifier *> pendingNotifiers;
 
@@ -250,6 +250,15 @@ QObjectPrivate::~QObjectPrivate()
     if (postedEvents)
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
+    if (QMetaCallReceiver *receiver = metaCallReceiver.load()) {
+        // the batched calls still queued to us are dropped when they are dequeued
+        {
+            QMutexLocker locker(&receiver->mutex);
+            receiver->threadData.store(0);
+        }
+        receiver->deref();
+    }
+
     threadData->deref();
 
     if (metaObject) metaObject->objectDestroyed(q_ptr);
@@ -287,32 +296,125 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    Modifications of this vector are protected by the object mutex
+    (signalSlotMutexes()). QMetaObject::activate() reads it without
+    locking: it takes a reference on the vector for the duration of the
+    emission, and nothing that such a reader could still be looking at is
+    freed while a reference other than the one of the owner is held.
+    Disconnected connections are unlinked and freed only when the vector
+    is not in use; the array of lists is replaced rather than resized in
+    place, and the old array is freed in the same way.
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
 */
-class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
+class QObjectConnectionListVector
 {
 public:
-    bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
-    bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
-    int inUse; //number of functions that are currently accessing this object or its connections
+    struct SignalVector
+    {
+        explicit SignalVector(int count)
+            : count(count), lists(new QObjectPrivate::ConnectionList[count]), nextInOrphanList(0)
+        { }
+        ~SignalVector() { delete [] lists; }
+
+        int count;
+        QObjectPrivate::ConnectionList *lists;
+        SignalVector *nextInOrphanList;
+    };
+
+    QAtomicInt ref; //one for the QObject owning this vector, plus one for each function currently using it
+    bool orphaned; //the QObject owner of this vector has been destroyed while the vector was in use
+    QAtomicInt dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
+    QAtomicPointer<SignalVector> signalVector;
     QObjectPrivate::ConnectionList allsignals;
+    QAtomicPointer<QObjectPrivate::Connection> orphanedConnections; //removed from the lists, but maybe still seen by a reader
+    SignalVector *orphanedSignalVectors;
 
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+        : ref(1), orphaned(false), dirty(0), signalVector(0), orphanedConnections(0), orphanedSignalVectors(0)
     { }
+    ~QObjectConnectionListVector();
+
+    // Returns \c true if a function other than the owner holds a reference on the vector.
+    // The read-modify-write orders this check after any preceding write, so that a reader that
+    // takes its reference later is guaranteed to observe those writes.
+    bool isInUse() { return ref.fetchAndAddOrdered(0) > 1; }
+
+    int count() const
+    {
+        const SignalVector *v = signalVector.loadAcquire();
+        return v ? v->count : 0;
+    }
+
+    const QObjectPrivate::ConnectionList &at(int at) const
+    {
+        if (at < 0)
+            return allsignals;
+        return signalVector.loadAcquire()->lists[at];
+    }
 
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
-        return QVector<QObjectPrivate::ConnectionList>::operator[](at);
+        return signalVector.load()->lists[at];
     }
+
+    void resize(int count);
+    void freeOrphanedSignalVectors();
 };
 
+/*!
+    \internal
+    Grows the vector to \a count lists. Must be called with the mutex of the owner locked.
+ */
+void QObjectConnectionListVector::resize(int count)
+{
+    SignalVector *old = signalVector.load();
+    SignalVector *v = new SignalVector(count);
+    if (old) {
+        Q_ASSERT(count > old->count);
+        for (int i = 0; i < old->count; ++i) {
+            v->lists[i].first.store(old->lists[i].first.load());
+            v->lists[i].last.store(old->lists[i].last.load());
+        }
+        // activate() may still be reading the old lists
+        old->nextInOrphanList = orphanedSignalVectors;
+        orphanedSignalVectors = old;
+    }
+    signalVector.storeRelease(v);
+}
+
+void QObjectConnectionListVector::freeOrphanedSignalVectors()
+{
+    SignalVector *v = orphanedSignalVectors;
+    orphanedSignalVectors = 0;
+    while (v) {
+        SignalVector *next = v->nextInOrphanList;
+        delete v;
+        v = next;
+    }
+}
+
+QObjectConnectionListVector::~QObjectConnectionListVector()
+{
+    Q_ASSERT(!ref.load());
+    QObjectPrivate::reclaimConnections(orphanedConnections.load());
+    for (int signal = -1; signal < count(); ++signal) {
+        QObjectPrivate::Connection *c = (*this)[signal].first.load();
+        while (c) {
+            QObjectPrivate::Connection *next = c->nextConnectionList.load();
+            c->nextInOrphanList = 0;
+            QObjectPrivate::reclaimConnections(c);
+            c = next;
+        }
+    }
+    delete signalVector.load();
+    freeOrphanedSignalVectors();
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -321,15 +423,15 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
-                connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver == receiver)
+                if (c->receiver.load() == receiver)
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -345,14 +447,14 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
-            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
+            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver)
-                    returnValue << c->receiver;
-                c = c->nextConnectionList;
+                if (QObject *receiver = c->receiver.load())
+                    returnValue << receiver;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -382,22 +484,33 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists) {
         connectionLists = new QObjectConnectionListVector();
+        this->connectionLists.storeRelease(connectionLists);
+    }
     if (signal >= connectionLists->count())
         connectionLists->resize(signal + 1);
 
+    // The receiver's thread data is only cached when the receiver lives in the current
+    // thread: it cannot be moved to another thread while we are connecting it.
+    QObject *receiver = c->receiver.load();
+    QThreadData *receiverThreadData = QObjectPrivate::get(receiver)->threadData;
+    if (receiverThreadData->threadId == QThread::currentThreadId()) {
+        receiverThreadData->ref();
+        c->receiverThreadData.store(receiverThreadData);
+    }
+
+    // publish the connection only once it is complete
     ConnectionList &connectionList = (*connectionLists)[signal];
-    if (connectionList.last) {
-        connectionList.last->nextConnectionList = c;
+    if (Connection *last = connectionList.last.load()) {
+        last->nextConnectionList.storeRelease(c);
     } else {
-        connectionList.first = c;
+        connectionList.first.storeRelease(c);
     }
-    connectionList.last = c;
+    connectionList.last.storeRelease(c);
 
-    cleanConnectionLists();
-
-    c->prev = &(QObjectPrivate::get(c->receiver)->senders);
+    c->prev = &(QObjectPrivate::get(receiver)->senders);
     c->next = *c->prev;
     *c->prev = c;
     if (c->next)
@@ -410,9 +523,30 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
     }
 }
 
-void QObjectPrivate::cleanConnectionLists()
+/*!
+  \internal
+  Removes the connections that have been disconnected from the connection lists,
+  provided that no emission is in progress.
+
+  The connections that were removed cannot be freed right away, because an emission
+  that started in another thread while they were being removed may still be looking
+  at them. They are kept aside until the lists are found not to be in use, and then
+  returned as a list linked by Connection::nextInOrphanList; the caller must pass it
+  to reclaimConnections() once it has unlocked all the mutexes of the signalSlotLock()
+  pool, as destroying a functor or releasing a thread data may lock them again.
+
+  The signalSlotLock() of the sender must be locked while calling this function.
+ */
+QObjectPrivate::Connection *QObjectPrivate::cleanConnectionLists()
 {
-    if (connectionLists->dirty && !connectionLists->inUse) {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists)
+        return 0;
+
+    if (connectionLists->dirty.load() && !connectionLists->isInUse()) {
+        connectionLists->dirty.store(0);
+        QObjectPrivate::Connection *orphans = connectionLists->orphanedConnections.load();
+
         // remove broken connections
         for (int signal = -1; signal < connectionLists->count(); ++signal) {
             QObjectPrivate::ConnectionList &connectionList =
@@ -423,29 +557,77 @@ void QObjectPrivate::cleanConnectionLists()
             // at the end of the cleanup.
             QObjectPrivate::Connection *last = 0;
 
-            QObjectPrivate::Connection **prev = &connectionList.first;
-            QObjectPrivate::Connection *c = *prev;
+            QAtomicPointer<QObjectPrivate::Connection> *prev = &connectionList.first;
+            QObjectPrivate::Connection *c = prev->load();
             while (c) {
-                if (c->receiver) {
+                QObjectPrivate::Connection *next = c->nextConnectionList.load();
+                if (c->receiver.load()) {
                     last = c;
                     prev = &c->nextConnectionList;
-                    c = *prev;
                 } else {
-                    QObjectPrivate::Connection *next = c->nextConnectionList;
-                    *prev = next;
-                    c->deref();
-                    c = next;
+                    // c keeps pointing to next, for the readers that may currently be on it
+                    prev->store(next);
+                    c->nextInOrphanList = orphans;
+                    orphans = c;
                 }
+                c = next;
             }
 
             // Correct the connection list's last pointer.
             // As conectionList.last could equal last, this could be a noop
-            connectionList.last = last;
+            connectionList.last.store(last);
         }
-        connectionLists->dirty = false;
+        connectionLists->orphanedConnections.store(orphans);
+    }
+
+    if ((connectionLists->orphanedConnections.load() || connectionLists->orphanedSignalVectors)
+        && !connectionLists->isInUse()) {
+        connectionLists->freeOrphanedSignalVectors();
+        return connectionLists->orphanedConnections.fetchAndStoreRelaxed(0);
+    }
+    return 0;
+}
+
+/*!
+  \internal
+  Frees the list of connections \a c returned by cleanConnectionLists(), destroying
+  their functors.
+
+  No mutex of the signalSlotLock() pool may be locked while calling this function.
+ */
+void QObjectPrivate::reclaimConnections(Connection *c)
+{
+    while (c) {
+        Connection *next = c->nextInOrphanList;
+        if (c->isSlotObject) {
+            c->isSlotObject = false;
+            c->slotObj->destroyIfLastRef();
+        }
+        c->deref();
+        c = next;
     }
 }
 
+/*!
+  \internal
+  Forgets the thread data cached in the connections to this object and its
+  children, before they are moved to another thread.
+ */
+void QObjectPrivate::invalidateReceiverThreadData()
+{
+    Q_Q(QObject);
+    {
+        QMutexLocker locker(signalSlotLock(q));
+        for (Connection *c = senders; c; c = c->next) {
+            // the object still holds a reference, this is never the last one
+            if (QThreadData *td = c->receiverThreadData.fetchAndStoreRelaxed(0))
+                td->deref();
+        }
+    }
+    for (int i = 0; i < children.size(); ++i)
+        children.at(i)->d_func()->invalidateReceiverThreadData();
+}
+
 /*!
     \internal
  */
@@ -935,55 +1117,46 @@ QObject::~QObject()
         d->currentSender->ref = 0;
     d->currentSender = 0;
 
-    if (d->connectionLists || d->senders) {
+    QObjectConnectionListVector *orphanedConnectionLists = 0;
+    if (d->connectionLists.load() || d->senders) {
         QMutex *signalSlotMutex = signalSlotLock(this);
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            // prevent the lists from being cleaned while the mutex is unlocked
+            connectionLists->ref.ref();
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
-                while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
-                        connectionList.first = c->nextConnectionList;
-                        c->deref();
+                for (QObjectPrivate::Connection *c = connectionList.first.load(); c;
+                     c = c->nextConnectionList.load()) {
+                    QObject *receiver = c->receiver.load();
+                    if (!receiver)
                         continue;
-                    }
 
-                    QMutex *m = signalSlotLock(c->receiver);
+                    QMutex *m = signalSlotLock(receiver);
                     bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
 
-                    if (c->receiver) {
+                    if (c->receiver.load()) {
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    c->receiver.store(0);
                     if (needToUnlock)
                         m->unlock();
-
-                    connectionList.first = c->nextConnectionList;
-
-                    // The destroy operation must happen outside the lock
-                    if (c->isSlotObject) {
-                        c->isSlotObject = false;
-                        locker.unlock();
-                        c->slotObj->destroyIfLastRef();
-                        locker.relock();
-                    }
-                    c->deref();
                 }
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
-            } else {
-                d->connectionLists->orphaned = true;
-            }
-            d->connectionLists = 0;
+            // The connections, and their functors, are released with the vector, once the
+            // emissions that may be in progress are done with it and outside of the lock.
+            connectionLists->orphaned = true;
+            d->connectionLists.store(0);
+            connectionLists->ref.deref();
+            if (!connectionLists->ref.deref())
+                orphanedConnectionLists = connectionLists;
         }
 
         /* Disconnect all senders:
@@ -1012,13 +1185,14 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
+            node->receiver.store(0);
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
             if (senderLists)
-                senderLists->dirty = true;
+                senderLists->dirty.store(1);
 
+            // If the sender is emitting, the functor is destroyed when the emission is done
             QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
-            if (node->isSlotObject) {
+            if (node->isSlotObject && (!senderLists || !senderLists->isInUse())) {
                 slotObj = node->slotObj;
                 node->isSlotObject = false;
             }
@@ -1036,6 +1210,7 @@ QObject::~QObject()
             }
         }
     }
+    delete orphanedConnectionLists;
 
     if (!d->children.isEmpty())
         d->deleteChildren();
@@ -1057,6 +1232,8 @@ QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (QThreadData *td = receiverThreadData.load())
+        td->deref();
 }
 
 
@@ -1505,6 +1682,7 @@ void QObject::moveToThread(QThread *targetThread)
 
     // prepare to move
     d->moveToThread_helper();
+    d->invalidateReceiverThreadData();
 
     if (!targetData)
         targetData = new QThreadData(0);
@@ -1567,12 +1745,51 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     threadData->deref();
     threadData = targetData;
 
+    // batched calls queued to the old thread are forwarded when it dequeues them
+    if (QMetaCallReceiver *receiver = metaCallReceiver.load()) {
+        QMutexLocker locker(&receiver->mutex);
+        receiver->threadData.storeRelease(targetData);
+    }
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
     }
 }
 
+/*!
+    \internal
+
+    Returns the control block of \a object for batched calls, creating it if
+    necessary. The caller must make sure that \a object is not destroyed
+    meanwhile.
+*/
+QMetaCallReceiver *QMetaCallReceiver::get(QObject *object)
+{
+    QObjectPrivate *d = QObjectPrivate::get(object);
+    QMetaCallReceiver *receiver = d->metaCallReceiver.loadAcquire();
+    if (receiver)
+        return receiver;
+
+    // the thread data of the object can only be trusted while its post event
+    // list is locked, as this is what QObject::moveToThread() locks
+    QThreadData *data = d->threadData;
+    data->postEventList.mutex.lock();
+    while (data != d->threadData) {
+        data->postEventList.mutex.unlock();
+        data = d->threadData;
+        data->postEventList.mutex.lock();
+    }
+
+    receiver = d->metaCallReceiver.load();
+    if (!receiver) {
+        receiver = new QMetaCallReceiver(object, data);
+        d->metaCallReceiver.storeRelease(receiver);
+    }
+    data->postEventList.mutex.unlock();
+    return receiver;
+}
+
 void QObjectPrivate::_q_reregisterTimers(void *pointer)
 {
     Q_Q(QObject);
@@ -2429,13 +2646,13 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first.load();
                 while (c) {
-                    receivers += c->receiver ? 1 : 0;
-                    c = c->nextConnectionList;
+                    receivers += c->receiver.load() ? 1 : 0;
+                    c = c->nextConnectionList.load();
                 }
             }
         }
@@ -2480,14 +2697,14 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first.load();
             while (c) {
-                if (c->receiver)
+                if (c->receiver.load())
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -2733,7 +2950,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~Qt::BatchedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(0);
     }
@@ -2814,7 +3031,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~Qt::BatchedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(0);
 
@@ -3257,37 +3474,40 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             int method_index_absolute = method_index + method_offset;
 
             while (c2) {
-                if (!c2->isSlotObject && c2->receiver == receiver && c2->method() == method_index_absolute)
+                if (!c2->isSlotObject && c2->receiver.load() == receiver && c2->method() == method_index_absolute)
                     return 0;
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
-        type &= Qt::UniqueConnection - 1;
+        type &= ~Qt::UniqueConnection;
     }
 
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->method_relative = method_index;
     c->method_offset = method_offset;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = false;
     c->argumentTypes.store(types);
-    c->nextConnectionList = 0;
     c->callFunction = callFunction;
 
-    QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QObjectPrivate *sp = QObjectPrivate::get(s);
+    sp->addConnection(signal_index, c.data());
+    QObjectPrivate::Connection *orphans = sp->cleanConnectionLists();
 
     locker.unlock();
+    QObjectPrivate::reclaimConnections(orphans);
     QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
     if (smethod.isValid())
         s->connectNotify(smethod);
@@ -3334,18 +3554,15 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
 {
     bool success = false;
     while (c) {
-        if (c->receiver
-            && (receiver == 0 || (c->receiver == receiver
+        QObject *r = c->receiver.load();
+        if (r
+            && (receiver == 0 || (r == receiver
                            && (method_index < 0 || (!c->isSlotObject && c->method() == method_index))
                            && (slot == 0 || (c->isSlotObject && c->slotObj->compare(slot)))))) {
-            bool needToUnlock = false;
-            QMutex *receiverMutex = 0;
-            if (c->receiver) {
-                receiverMutex = signalSlotLock(c->receiver);
-                // need to relock this receiver and sender in the correct order
-                needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
-            }
-            if (c->receiver) {
+            QMutex *receiverMutex = signalSlotLock(r);
+            // need to relock this receiver and sender in the correct order
+            bool needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
+            if (c->receiver.load()) {
                 *c->prev = c->next;
                 if (c->next)
                     c->next->prev = c->prev;
@@ -3354,21 +3571,15 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
-
-            if (c->isSlotObject) {
-                c->isSlotObject = false;
-                senderMutex->unlock();
-                c->slotObj->destroyIfLastRef();
-                senderMutex->lock();
-            }
+            // the functor is destroyed when the connection is removed from the list
+            c->receiver.store(0);
 
             success = true;
 
             if (disconnectType == DisconnectOne)
                 return success;
         }
-        c = c->nextConnectionList;
+        c = c->nextConnectionList.load();
     }
     return success;
 }
@@ -3390,39 +3601,57 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *senderMutex = signalSlotLock(sender);
     QMutexLocker locker(senderMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
-    // prevent incoming connections changing the connectionLists while unlocked
-    ++connectionLists->inUse;
+    // prevent the lists from being cleaned while unlocked
+    connectionLists->ref.ref();
 
     bool success = false;
     if (signal_index < 0) {
         // remove from all connection lists
         for (int sig_index = -1; sig_index < connectionLists->count(); ++sig_index) {
             QObjectPrivate::Connection *c =
-                (*connectionLists)[sig_index].first;
+                (*connectionLists)[sig_index].first.load();
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
-                connectionLists->dirty = true;
+                connectionLists->dirty.store(1);
             }
         }
     } else if (signal_index < connectionLists->count()) {
         QObjectPrivate::Connection *c =
-            (*connectionLists)[signal_index].first;
+            (*connectionLists)[signal_index].first.load();
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
-            connectionLists->dirty = true;
+            connectionLists->dirty.store(1);
         }
     }
 
-    --connectionLists->inUse;
-    Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
-        delete connectionLists;
+    // The connections are removed from the lists the next time they are cleaned, but their
+    // functors are destroyed right away, unless an emission in progress may still call them
+    QVarLengthArray<QtPrivate::QSlotObjectBase *, 4> slotObjects;
+    QObjectConnectionListVector *orphanedConnectionLists = 0;
+    if (!connectionLists->ref.deref()) {
+        orphanedConnectionLists = connectionLists;
+    } else if (success && !connectionLists->orphaned && !connectionLists->isInUse()) {
+        const int begin = signal_index < 0 ? -1 : signal_index;
+        const int end = signal_index < 0 ? connectionLists->count() : signal_index + 1;
+        for (int sig_index = begin; sig_index < end; ++sig_index) {
+            QObjectPrivate::Connection *c = (*connectionLists)[sig_index].first.load();
+            for (; c; c = c->nextConnectionList.load()) {
+                if (!c->receiver.load() && c->isSlotObject) {
+                    c->isSlotObject = false;
+                    slotObjects.append(c->slotObj);
+                }
+            }
+        }
+    }
 
     locker.unlock();
+    delete orphanedConnectionLists;
+    for (int i = 0; i < slotObjects.size(); ++i)
+        slotObjects.at(i)->destroyIfLastRef();
     if (success) {
         QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
         if (smethod.isValid())
@@ -3575,7 +3804,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
             args[n] = QMetaType::create(types[n], argv[n]);
         locker.relock();
 
-        if (!c->receiver) {
+        if (!c->receiver.load()) {
             locker.unlock();
             // we have been disconnected while the mutex was unlocked
             for (int n = 1; n < nargs; ++n)
@@ -3590,7 +3819,17 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    if (c->isBatched) {
+        // the call is dropped, and thus deleted, if the receiver is gone: do it unlocked
+        QMetaCallReceiver *receiver = QMetaCallReceiver::get(c->receiver.load());
+        receiver->ref.ref();
+        locker.unlock();
+        QCoreApplicationPrivate::postBatchedMetaCall(receiver, ev);
+        receiver->deref();
+        locker.relock();
+    } else {
+        QCoreApplication::postEvent(c->receiver.load(), ev);
+    }
 }
 
 /*!
@@ -3632,32 +3871,40 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     }
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
     struct ConnectionListsRef {
+        QObject *sender;
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        ConnectionListsRef(QObject *sender)
+            : sender(sender), connectionLists(sender->d_func()->connectionLists.loadAcquire())
         {
             if (connectionLists)
-                ++connectionLists->inUse;
+                connectionLists->ref.ref();
         }
         ~ConnectionListsRef()
         {
             if (!connectionLists)
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
+            const int previousRef = connectionLists->ref.fetchAndAddOrdered(-1);
+            Q_ASSERT(previousRef > 0);
+            if (previousRef == 1) {
+                // the sender was destroyed during the emission
+                Q_ASSERT(connectionLists->orphaned);
+                delete connectionLists;
+            } else if (previousRef == 2 && !connectionLists->orphaned
+                       && (connectionLists->dirty.load() || connectionLists->orphanedConnections.load())) {
+                // we were the last emission: remove what was disconnected in the meantime
+                QMutexLocker locker(signalSlotLock(sender));
+                QObjectPrivate::Connection *orphans = sender->d_func()->cleanConnectionLists();
+                locker.unlock();
+                QObjectPrivate::reclaimConnections(orphans);
             }
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender);
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
@@ -3672,43 +3919,73 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
 
     do {
-        QObjectPrivate::Connection *c = list->first;
+        QObjectPrivate::Connection *c = list->first.loadAcquire();
         if (!c) continue;
         // We need to check against last here to ensure that signals added
         // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
+        QObjectPrivate::Connection *last = list->last.loadAcquire();
 
         do {
-            if (!c->receiver)
+            QObject *receiver = c->receiver.loadAcquire();
+            if (!receiver)
                 continue;
 
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+            const QThreadData *receiverThreadData = c->receiverThreadData.loadAcquire();
+            bool receiverInSameThread;
+            if (receiverThreadData) {
+                receiverInSameThread = currentThreadId == receiverThreadData->threadId;
+            } else if (c->connectionType == Qt::DirectConnection) {
+                // Not cached, as the connection was made from another thread or the receiver
+                // was moved. The other types find out under the lock below; a direct call
+                // needs the receiver to stay alive anyway.
+                receiverInSameThread = currentThreadId == QObjectPrivate::get(receiver)->threadData->threadId;
+            } else {
+                receiverInSameThread = false;
+            }
 
             // determine if this connection should be sent immediately or
             // put into the event queue
             if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
-                continue;
+                || c->connectionType == Qt::QueuedConnection
+                || c->connectionType == Qt::BlockingQueuedConnection) {
+                // The receiver may live in another thread and be destroyed there at any time:
+                // the sender's lock keeps it alive while we look at it.
+                QMutexLocker locker(signalSlotLock(sender));
+                receiver = c->receiver.load();
+                if (!receiver)
+                    continue;
+                QThreadData *td = receiver->d_func()->threadData;
+                receiverInSameThread = currentThreadId == td->threadId;
+
+                if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
+                    || (c->connectionType == Qt::QueuedConnection)) {
+                    queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
+                    continue;
 #ifndef QT_NO_THREAD
-            } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                if (receiverInSameThread) {
-                    qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
-                    "Sender is %s(%p), receiver is %s(%p)",
-                    sender->metaObject()->className(), sender,
-                    receiver->metaObject()->className(), receiver);
-                }
-                QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
-                    new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
-                locker.unlock();
-                semaphore.acquire();
-                locker.relock();
-                continue;
+                } else if (c->connectionType == Qt::BlockingQueuedConnection) {
+                    if (receiverInSameThread) {
+                        qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
+                        "Sender is %s(%p), receiver is %s(%p)",
+                        sender->metaObject()->className(), sender,
+                        receiver->metaObject()->className(), receiver);
+                    }
+                    QSemaphore semaphore;
+                    QMetaCallEvent *ev = c->isSlotObject ?
+                        new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+                        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
+                    QCoreApplication::postEvent(receiver, ev);
+                    locker.unlock();
+                    semaphore.acquire();
+                    continue;
 #endif
+                }
+
+                // The receiver lives in this thread, so it cannot be moved to another one
+                // behind our back: remember it for the next emissions.
+                if (!receiverThreadData) {
+                    td->ref();
+                    c->receiverThreadData.storeRelease(td);
+                }
             }
 
             QConnectionSenderSwitcher sw;
@@ -3719,21 +3996,12 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
             if (c->isSlotObject) {
                 c->slotObj->ref();
                 QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
                 obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
             } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
                 //we compare the vtable to make sure we are not in the destructor of the object.
                 const int methodIndex = c->method();
                 const int method_relative = c->method_relative;
                 const auto callFunction = c->callFunction;
-                locker.unlock();
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0)
                     qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
 
@@ -3741,10 +4009,8 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
-                locker.relock();
             } else {
                 const int method = c->method_relative + c->method_offset;
-                locker.unlock();
 
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
                     qt_signal_spy_callback_set.slot_begin_callback(receiver,
@@ -3756,13 +4022,11 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
             }
 
             if (connectionLists->orphaned)
                 break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+        } while (c != last && (c = c->nextConnectionList.loadAcquire()) != 0);
 
         if (connectionLists->orphaned)
             break;
@@ -4035,32 +4299,33 @@ void QObject::dumpObjectInfo() const
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
             while (c) {
-                if (!c->receiver) {
+                const QObject *receiver = c->receiver.load();
+                if (!receiver) {
                     qDebug("          <Disconnected receiver>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
                 if (c->isSlotObject) {
                     qDebug("          <functor or function pointer>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = receiver->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       receiver->objectName().isEmpty() ? "unnamed" : qPrintable(receiver->objectName()),
                        method.methodSignature().constData());
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     } else {
@@ -4788,17 +5053,17 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection && slot) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             while (c2) {
-                if (c2->receiver == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
+                if (c2->receiver.load() == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
                     slotObj->destroyIfLastRef();
                     return QMetaObject::Connection();
                 }
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type = static_cast<Qt::ConnectionType>(type ^ Qt::UniqueConnection);
@@ -4807,18 +5072,22 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->slotObj = slotObj;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = true;
     if (types) {
         c->argumentTypes.store(types);
         c->ownArgumentTypes = false;
     }
 
-    QObjectPrivate::get(s)->addConnection(signal_index, c.data());
+    QObjectPrivate *sp = QObjectPrivate::get(s);
+    sp->addConnection(signal_index, c.data());
+    QObjectPrivate::Connection *orphans = sp->cleanConnectionLists();
     QMetaObject::Connection ret(c.take());
     locker.unlock();
+    QObjectPrivate::reclaimConnections(orphans);
 
     QMetaMethod method = QMetaObjectPrivate::signal(senderMetaObject, signal_index);
     Q_ASSERT(method.isValid());
@@ -4839,30 +5108,35 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
 {
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(connection.d_ptr);
 
-    if (!c || !c->receiver)
+    if (!c || !c->receiver.load())
         return false;
 
     QMutex *senderMutex = signalSlotLock(c->sender);
-    QMutex *receiverMutex = signalSlotLock(c->receiver);
+    QMutex *receiverMutex = signalSlotLock(c->receiver.load());
 
+    QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
         Q_ASSERT(connectionLists);
-        connectionLists->dirty = true;
+        connectionLists->dirty.store(1);
 
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
+        c->receiver.store(0);
+
+        // If the sender is emitting, the functor is destroyed when the emission is done
+        if (c->isSlotObject && !connectionLists->isInUse()) {
+            slotObj = c->slotObj;
+            c->isSlotObject = false;
+        }
     }
 
     // destroy the QSlotObject, if possible
-    if (c->isSlotObject) {
-        c->slotObj->destroyIfLastRef();
-        c->isSlotObject = false;
-    }
+    if (slotObj)
+        slotObj->destroyIfLastRef();
 
     c->sender->disconnectNotify(QMetaObjectPrivate::signal(c->sender->metaObject(),
                                                            c->signal_index));
@@ -5043,7 +5317,7 @@ bool QMetaObject::Connection::isConnected_helper() const
     Q_ASSERT(d_ptr);    // we're only called from operator RestrictedBool() const
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(d_ptr);
 
-    return c->receiver;
+    return c->receiver.load();
 }
 
 
@@ -238,7 +238,7 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if ((type & ~Qt::BatchedConnection) == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal),
@@ -278,7 +278,7 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if ((type & ~Qt::BatchedConnection) == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, Q_NULLPTR,
@@ -317,7 +317,7 @@ public:
                           "No Q_OBJECT in the class with the signal");
 
         const int *types = Q_NULLPTR;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if ((type & ~Qt::BatchedConnection) == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, Q_NULLPTR,
@@ -66,6 +66,7 @@ QT_BEGIN_NAMESPACE
 
 class QVariant;
 class QThreadData;
+class QMetaCallReceiver;
 class QObjectConnectionListVector;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
@@ -127,16 +128,21 @@ public:
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
         };
         // The next pointer for the singly-linked ConnectionList
-        Connection *nextConnectionList;
+        QAtomicPointer<Connection> nextConnectionList;
+        // The next pointer in the list of connections waiting to be freed (see cleanConnectionLists())
+        Connection *nextInOrphanList;
         //senders linked list
         Connection *next;
         Connection **prev;
+        // Thread data of the receiver, cached only while the receiver lives in the thread that
+        // set it, so that QMetaObject::activate can tell direct calls apart without locking
+        QAtomicPointer<QThreadData> receiverThreadData;
         QAtomicPointer<const int> argumentTypes;
         QAtomicInt ref_;
         ushort method_offset;
@@ -145,7 +151,8 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        ushort isBatched : 1; // queued calls go through a QMetaCallQueue (Qt::BatchedConnection)
+        Connection() : nextConnectionList(0), nextInOrphanList(0), receiverThreadData(0), ref_(2), ownArgumentTypes(true), isBatched(false) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -153,7 +160,7 @@ public:
         void ref() { ref_.ref(); }
         void deref() {
             if (!ref_.deref()) {
-                Q_ASSERT(!receiver);
+                Q_ASSERT(!receiver.load());
                 delete this;
             }
         }
@@ -161,8 +168,8 @@ public:
     // ConnectionList is a singly-linked list
     struct ConnectionList {
         ConnectionList() : first(0), last(0) {}
-        Connection *first;
-        Connection *last;
+        QAtomicPointer<Connection> first;
+        QAtomicPointer<Connection> last;
     };
 
     struct Sender
@@ -187,7 +194,9 @@ public:
     QObjectList senderList() const;
 
     void addConnection(int signal, Connection *c);
-    void cleanConnectionLists();
+    Connection *cleanConnectionLists();
+    static void reclaimConnections(Connection *c);
+    void invalidateReceiverThreadData();
 
     static inline Sender *setCurrentSender(QObject *receiver,
                                     Sender *sender);
@@ -227,7 +236,7 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -241,6 +250,9 @@ public:
     // these objects are all used to indicate that a QObject was deleted
     // plus QPointer, which keeps a separate list
     QAtomicPointer<QtSharedPointer::ExternalRefCountData> sharedRefcount;
+
+    // created when the first batched call is queued to this object
+    QAtomicPointer<QMetaCallReceiver> metaCallReceiver;
 };
 
 
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvector.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -53,6 +54,8 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
@@ -62,6 +65,11 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  * timerBitVec array is used for keeping track of timer identifiers.
  */
 
+static inline qint64 timespecToMsecs(const timespec &ts)
+{
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / (1000 * 1000);
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
@@ -84,6 +92,8 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+    wheelTime = 0;
+    clearWheel();
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -150,10 +160,12 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers and rebuild the wheel around the new timeouts
+    clearWheel();
+    wheelTime = timespecToMsecs(currentTime);
+    for (QTimerInfo *t : qAsConst(timers)) {
         t->timeout = t->timeout + diff;
+        timerInsert(t);
     }
 }
 
@@ -174,18 +186,226 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+void QTimerInfoList::clearWheel()
+{
+    for (int i = 0; i < SlotCount; ++i)
+        wheel[i].first = wheel[i].last = 0;
+    for (int i = 0; i < RootSize / 64; ++i)
+        rootBitmap[i] = 0;
+    for (int i = 0; i < LevelCount; ++i)
+        levelBitmap[i] = 0;
+    earliestTimer = 0;
+    earliestTimerValid = true;
+}
+
 /*
-  insert timer info into list
+  insert timer info into the wheel
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    // overdue timers go to the current slot, which is sorted
+    const qint64 msecs = qMax(timespecToMsecs(ti->timeout), wheelTime);
+    const quint64 diff = quint64(msecs ^ wheelTime);
+    WheelSlot *slot;
+
+    if (diff < RootSize) {
+        ti->slot = int(msecs & (RootSize - 1));
+        rootBitmap[ti->slot / 64] |= Q_UINT64_C(1) << (ti->slot % 64);
+        slot = &wheel[ti->slot];
+
+        // keep root slots sorted, inserting after timers with the same timeout
+        QTimerInfo *after = slot->last;
+        while (after && ti->timeout < after->timeout)
+            after = after->prev;
+        ti->prev = after;
+        ti->next = after ? after->next : slot->first;
+    } else {
+        ti->slot = OverflowSlot;
+        for (int level = 0; level < LevelCount; ++level) {
+            const int shift = RootBits + level * LevelBits;
+            if ((diff >> (shift + LevelBits)) == 0) {
+                const int index = int(msecs >> shift) & (LevelSize - 1);
+                levelBitmap[level] |= Q_UINT64_C(1) << index;
+                ti->slot = RootSize + level * LevelSize + index;
+                break;
+            }
+        }
+        slot = &wheel[ti->slot];
+        ti->prev = slot->last;
+        ti->next = 0;
     }
-    insert(index+1, ti);
+
+    if (ti->prev)
+        ti->prev->next = ti;
+    else
+        slot->first = ti;
+    if (ti->next)
+        ti->next->prev = ti;
+    else
+        slot->last = ti;
+
+    if (earliestTimerValid && (!earliestTimer || ti->timeout < earliestTimer->timeout))
+        earliestTimer = ti;
+}
+
+/*
+  remove timer info from the wheel
+*/
+void QTimerInfoList::timerUnlink(QTimerInfo *ti)
+{
+    WheelSlot &slot = wheel[ti->slot];
+    if (ti->prev)
+        ti->prev->next = ti->next;
+    else
+        slot.first = ti->next;
+    if (ti->next)
+        ti->next->prev = ti->prev;
+    else
+        slot.last = ti->prev;
+
+    if (!slot.first) {
+        if (ti->slot < RootSize) {
+            rootBitmap[ti->slot / 64] &= ~(Q_UINT64_C(1) << (ti->slot % 64));
+        } else if (ti->slot < OverflowSlot) {
+            const int level = (ti->slot - RootSize) / LevelSize;
+            levelBitmap[level] &= ~(Q_UINT64_C(1) << ((ti->slot - RootSize) % LevelSize));
+        }
+    }
+
+    if (ti == earliestTimer)
+        earliestTimerValid = false;
+}
+
+/*
+  remove timer info from the timers of its object
+*/
+void QTimerInfoList::objectTimerUnlink(QTimerInfo *ti)
+{
+    if (ti->nextForObject)
+        ti->nextForObject->prevForObject = ti->prevForObject;
+    if (ti->prevForObject)
+        ti->prevForObject->nextForObject = ti->nextForObject;
+    else if (ti->nextForObject)
+        objectTimers[ti->obj] = ti->nextForObject;
+    else
+        objectTimers.remove(ti->obj);
+}
+
+/*
+  redistribute the timers of a slot that the wheel time has reached
+*/
+void QTimerInfoList::cascade(int slot)
+{
+    QTimerInfo *t = wheel[slot].first;
+    wheel[slot].first = wheel[slot].last = 0;
+    if (slot < OverflowSlot) {
+        const int level = (slot - RootSize) / LevelSize;
+        levelBitmap[level] &= ~(Q_UINT64_C(1) << ((slot - RootSize) % LevelSize));
+    }
+    while (t) {
+        QTimerInfo *next = t->next;
+        timerInsert(t);
+        t = next;
+    }
+}
+
+/*
+  move the wheel time forward to \a msecs, or to the earliest timer if
+  that comes first
+*/
+void QTimerInfoList::advanceWheel(qint64 msecs)
+{
+    while (wheelTime < msecs) {
+        for (int i = 0; i < RootSize / 64; ++i) {
+            if (rootBitmap[i]) {
+                const qint64 first = (wheelTime & ~qint64(RootSize - 1))
+                        | (i * 64 + qCountTrailingZeroBits(rootBitmap[i]));
+                wheelTime = qMin(first, msecs);
+                return;
+            }
+        }
+
+        int slot = -1;
+        qint64 start = 0;
+        for (int level = 0; level < LevelCount; ++level) {
+            if (levelBitmap[level]) {
+                const int shift = RootBits + level * LevelBits;
+                const int index = qCountTrailingZeroBits(levelBitmap[level]);
+                start = (wheelTime & ~((qint64(1) << (shift + LevelBits)) - 1))
+                        | (qint64(index) << shift);
+                slot = RootSize + level * LevelSize + index;
+                break;
+            }
+        }
+
+        if (slot < 0) {
+            // only overflow timers left, if any
+            if (!wheel[OverflowSlot].first) {
+                wheelTime = msecs;
+                return;
+            }
+            start = timespecToMsecs(findEarliestTimer(false)->timeout);
+            slot = OverflowSlot;
+        }
+
+        if (start > msecs) {
+            wheelTime = msecs;
+            if (slot == OverflowSlot)
+                cascade(slot);
+            return;
+        }
+        wheelTime = start;
+        cascade(slot);
+    }
+}
+
+/*
+  find the timer that expires first, optionally ignoring the timers
+  currently being activated
+*/
+QTimerInfo *QTimerInfoList::findEarliestTimer(bool skipActive) const
+{
+    // root slots are sorted and all lie in the current window
+    for (int i = 0; i < RootSize / 64; ++i) {
+        quint64 bits = rootBitmap[i];
+        while (bits) {
+            const int slot = i * 64 + qCountTrailingZeroBits(bits);
+            for (QTimerInfo *t = wheel[slot].first; t; t = t->next) {
+                if (!skipActive || !t->activateRef)
+                    return t;
+            }
+            bits &= bits - 1;
+        }
+    }
+
+    // the other slots cover consecutive, later ranges but are not sorted
+    for (int level = 0; level <= LevelCount; ++level) {
+        quint64 bits = level < LevelCount ? levelBitmap[level] : 1;
+        while (bits) {
+            const int slot = level < LevelCount
+                    ? RootSize + level * LevelSize + qCountTrailingZeroBits(bits)
+                    : int(OverflowSlot);
+            QTimerInfo *earliest = 0;
+            for (QTimerInfo *t = wheel[slot].first; t; t = t->next) {
+                if ((!skipActive || !t->activateRef)
+                        && (!earliest || t->timeout < earliest->timeout))
+                    earliest = t;
+            }
+            if (earliest)
+                return earliest;
+            bits &= bits - 1;
+        }
+    }
+    return 0;
+}
+
+QTimerInfo *QTimerInfoList::constFirst() const
+{
+    if (!earliestTimerValid) {
+        earliestTimer = findEarliestTimer(false);
+        earliestTimerValid = true;
+    }
+    return earliestTimer;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -387,15 +607,12 @@ bool QTimerInfoList::timerWait(timespec &tm)
 {
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
+    advanceWheel(timespecToMsecs(currentTime));
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
+    QTimerInfo *t = constFirst();
+    if (t && t->activateRef)
+        t = findEarliestTimer(true);
 
     if (!t)
       return false;
@@ -423,16 +640,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -453,6 +667,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->activateRef = 0;
 
     timespec expected = updateCurrentTime() + interval;
+    if (timers.isEmpty())
+        wheelTime = qMax(wheelTime, timespecToMsecs(currentTime));
 
     switch (timerType) {
     case Qt::PreciseTimer:
@@ -494,6 +710,14 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     }
 
     timerInsert(t);
+    timers.insert(timerId, t);
+
+    QTimerInfo *&objectFirst = objectTimers[object];
+    t->prevForObject = 0;
+    t->nextForObject = objectFirst;
+    if (objectFirst)
+        objectFirst->prevForObject = t;
+    objectFirst = t;
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -508,56 +732,57 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timers.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+    objectTimerUnlink(t);
+    timerUnlink(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+    QTimerInfo *next = objectTimers.take(object);
+    while (next) {
+        QTimerInfo *t = next;
+        next = t->nextForObject;
+        timers.remove(t->id);
+        timerUnlink(t);
+        if (t == firstTimerInfo)
+            firstTimerInfo = 0;
+        if (t->activateRef)
+            *(t->activateRef) = 0;
+        delete t;
     }
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
+    // report the timers in the order they expire
+    QVector<const QTimerInfo *> objectTimerInfos;
+    for (const QTimerInfo *t = objectTimers.value(object); t; t = t->nextForObject)
+        objectTimerInfos.append(t);
+    std::sort(objectTimerInfos.begin(), objectTimerInfos.end(),
+              [](const QTimerInfo *a, const QTimerInfo *b) { return a->timeout < b->timeout; });
+
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    list.reserve(objectTimerInfos.size());
+    for (const QTimerInfo *t : qAsConst(objectTimerInfos)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -576,21 +801,47 @@ int QTimerInfoList::activateTimers()
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
-
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
+    const qint64 currentMsecs = timespecToMsecs(currentTime);
+    advanceWheel(currentMsecs);
+
+    // Find out how many timer have expired; only the slots up to the
+    // current time can hold any, and root slots are sorted
+    for (int i = 0; i < RootSize / 64; ++i) {
+        for (quint64 bits = rootBitmap[i]; bits; bits &= bits - 1) {
+            const int slot = i * 64 + qCountTrailingZeroBits(bits);
+            for (const QTimerInfo *t = wheel[slot].first; t; t = t->next) {
+                if (currentTime < t->timeout)
+                    goto counted;
+                maxCount++;
+            }
+        }
     }
+    for (int level = 0; level <= LevelCount; ++level) {
+        quint64 bits = level < LevelCount ? levelBitmap[level] : 1;
+        for (; bits; bits &= bits - 1) {
+            int slot = OverflowSlot;
+            if (level < LevelCount) {
+                const int shift = RootBits + level * LevelBits;
+                const int index = qCountTrailingZeroBits(bits);
+                const qint64 start = (wheelTime & ~((qint64(1) << (shift + LevelBits)) - 1))
+                        | (qint64(index) << shift);
+                if (start > currentMsecs)
+                    goto counted;
+                slot = RootSize + level * LevelSize + index;
+            }
+            for (const QTimerInfo *t = wheel[slot].first; t; t = t->next) {
+                if (!(currentTime < t->timeout))
+                    maxCount++;
+            }
+        }
+    }
+counted:
 
     //fire the timers.
     while (maxCount--) {
-        if (isEmpty())
-            break;
-
         QTimerInfo *currentTimerInfo = constFirst();
+        if (!currentTimerInfo)
+            break;
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
 
@@ -604,8 +855,8 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
-        // remove from list
-        removeFirst();
+        // remove from wheel
+        timerUnlink(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
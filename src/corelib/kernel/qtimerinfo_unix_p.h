@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -69,6 +70,11 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    QTimerInfo *next; // - next timer in the same wheel slot
+    QTimerInfo *prev; // - previous timer in the same wheel slot
+    int slot;         // - wheel slot holding this timer
+    QTimerInfo *nextForObject; // - next timer of the same object
+    QTimerInfo *prevForObject; // - previous timer of the same object
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,7 +83,7 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -92,6 +98,45 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    // Timers are kept in a hierarchical timer wheel with millisecond
+    // resolution. The root level has one slot per millisecond of the
+    // current 256 ms window and keeps each slot sorted by timeout; each
+    // further level covers 64 windows of the level below it. Timers
+    // beyond the last level go to an unsorted overflow slot.
+    enum {
+        RootBits = 8,
+        RootSize = 1 << RootBits,
+        LevelBits = 6,
+        LevelSize = 1 << LevelBits,
+        LevelCount = 4,
+        OverflowSlot = RootSize + LevelCount * LevelSize,
+        SlotCount = OverflowSlot + 1
+    };
+    struct WheelSlot {
+        QTimerInfo *first;
+        QTimerInfo *last;
+    };
+
+    WheelSlot wheel[SlotCount];
+    quint64 rootBitmap[RootSize / 64];
+    quint64 levelBitmap[LevelCount];
+    qint64 wheelTime; // - in milliseconds, never after the earliest timer
+
+    QHash<int, QTimerInfo *> timers;
+    QHash<QObject *, QTimerInfo *> objectTimers; // - first timer of each object
+
+    mutable QTimerInfo *earliestTimer;
+    mutable bool earliestTimerValid;
+
+    void clearWheel();
+    void advanceWheel(qint64 msecs);
+    void cascade(int slot);
+    void timerUnlink(QTimerInfo *);
+    void objectTimerUnlink(QTimerInfo *);
+    QTimerInfo *findEarliestTimer(bool skipActive) const;
+
+    Q_DISABLE_COPY(QTimerInfoList)
+
 public:
     QTimerInfoList();
 
@@ -112,6 +157,20 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
+    int count() const { return timers.size(); }
+
+    // the timer that expires first
+    QTimerInfo *constFirst() const;
+
+    // iteration in no particular order, e.g. for qDeleteAll()
+    typedef QHash<int, QTimerInfo *>::const_iterator const_iterator;
+    const_iterator begin() const { return timers.constBegin(); }
+    const_iterator end() const { return timers.constEnd(); }
+    const_iterator constBegin() const { return timers.constBegin(); }
+    const_iterator constEnd() const { return timers.constEnd(); }
 };
 
 QT_END_NAMESPACE
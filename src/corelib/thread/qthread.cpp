@@ -91,9 +91,80 @@ QThreadData::~QThreadData()
         }
     }
 
+    for (QMetaCallQueue *queue : qAsConst(outgoingMetaCalls)) {
+        if (!queue->ref.deref())
+            delete queue;
+    }
+
+    // nobody can send batched calls to us anymore, since senders hold a
+    // reference while they queue one: drop the remaining calls, and tell the
+    // senders to forget about their queues
+    for (QMetaCallQueue *queue : qAsConst(incomingMetaCalls)) {
+        queue->consumer.storeRelease(0);
+        QMetaCallQueue::Entry entry;
+        while (queue->dequeue(queue->published(), &entry)) {
+            delete entry.event;
+            entry.receiver->deref();
+        }
+        if (!queue->ref.deref())
+            delete queue;
+    }
+
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+/*
+  QMetaCallQueue
+*/
+
+QMetaCallQueue::QMetaCallQueue(QThreadData *consumer)
+    : ref(1), consumer(consumer), enqueued(0), tail(new Chunk), tailIndex(0),
+      dequeued(0), head(tail), headIndex(0)
+{
+}
+
+QMetaCallQueue::~QMetaCallQueue()
+{
+    Entry entry;
+    while (dequeue(enqueued.load(), &entry)) {
+        delete entry.event;
+        entry.receiver->deref();
+    }
+    delete head;
+}
+
+void QMetaCallQueue::enqueue(QMetaCallReceiver *receiver, QMetaCallEvent *event)
+{
+    if (tailIndex == ChunkSize) {
+        Chunk *chunk = new Chunk;
+        tail->next = chunk;
+        tail = chunk;
+        tailIndex = 0;
+    }
+    Entry &entry = tail->entries[tailIndex++];
+    entry.receiver = receiver;
+    entry.event = event;
+    enqueued.storeRelease(enqueued.load() + 1);
+}
+
+// Takes the next entry, provided it was published before \a until was read.
+// The entry is removed before the call is delivered, so a nested drain (from a
+// slot that processes events) simply continues where this one stopped.
+bool QMetaCallQueue::dequeue(quint32 until, Entry *entry)
+{
+    if (qint32(until - dequeued) <= 0)
+        return false;
+    if (headIndex == ChunkSize) {
+        Chunk *chunk = head;
+        head = chunk->next;
+        headIndex = 0;
+        delete chunk;
+    }
+    *entry = head->entries[headIndex++];
+    ++dequeued;
+    return true;
+}
+
 void QThreadData::ref()
 {
 #ifndef QT_NO_THREAD
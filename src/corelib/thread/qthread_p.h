@@ -140,6 +140,79 @@ private:
     using QVector<QPostEvent>::insert;
 };
 
+// Shared by an object and the batched calls (Qt::BatchedConnection) queued to
+// it, so that the thread draining a call can tell where the object lives without
+// touching it. threadData is 0 once the object is destroyed; it is only changed
+// by the object's thread, with the mutex locked.
+class QMetaCallReceiver
+{
+public:
+    QMetaCallReceiver(QObject *object, QThreadData *threadData)
+        : ref(1), object(object), threadData(threadData)
+    { }
+
+    static QMetaCallReceiver *get(QObject *object);
+
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+
+    QAtomicInt ref;
+    QObject *object;
+    QAtomicPointer<QThreadData> threadData;
+    QMutex mutex;
+};
+
+// Unbounded single-producer, single-consumer queue of the batched calls sent
+// from one thread to another. The entries are stored in chunks: the producer
+// publishes them by bumping the enqueued count, and the consumer frees a chunk
+// once it has moved past it. The queue does not keep its consumer alive: the
+// consumer is reset to 0 when the receiving thread's data is destroyed.
+class QMetaCallQueue
+{
+public:
+    struct Entry
+    {
+        QMetaCallReceiver *receiver;
+        QMetaCallEvent *event;
+    };
+
+    explicit QMetaCallQueue(QThreadData *consumer);
+    ~QMetaCallQueue();
+
+    // producer thread only
+    void enqueue(QMetaCallReceiver *receiver, QMetaCallEvent *event);
+
+    // consumer thread only
+    quint32 published() const { return enqueued.loadAcquire(); }
+    bool isEmpty() const { return dequeued == enqueued.loadAcquire(); }
+    bool dequeue(quint32 until, Entry *entry);
+
+    QAtomicInt ref;
+    QAtomicPointer<QThreadData> consumer;
+
+private:
+    enum { ChunkSize = 256 };
+    struct Chunk
+    {
+        Chunk() : next(0) { }
+        Chunk *next;
+        Entry entries[ChunkSize];
+    };
+
+    QAtomicInteger<quint32> enqueued;
+    Chunk *tail;
+    int tailIndex;
+
+    quint32 dequeued;
+    Chunk *head;
+    int headIndex;
+
+    Q_DISABLE_COPY(QMetaCallQueue)
+};
+
 #ifndef QT_NO_THREAD
 
 class Q_CORE_EXPORT QDaemonThread : public QThread
@@ -289,6 +362,14 @@ public:
     QVector<void *> tls;
     FlaggedDebugSignatures flaggedSignatures;
 
+    // Batched queued calls: the queues this thread sends calls through, only
+    // used by this thread, and the queues it receives calls from, protected by
+    // postEventList.mutex. metaCallsPending is set when calls were enqueued
+    // since the thread last drained its incoming queues.
+    QVector<QMetaCallQueue *> outgoingMetaCalls;
+    QVector<QMetaCallQueue *> incomingMetaCalls;
+    QAtomicInt metaCallsPending;
+
     bool quitNow;
     bool canWait;
     bool isAdopted;
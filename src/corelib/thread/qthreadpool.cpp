@@ -42,6 +42,8 @@
 #include "qelapsedtimer.h"
 
 #include <algorithm>
+#include <deque>
+#include <limits>
 
 #ifndef QT_NO_THREAD
 
@@ -59,11 +61,40 @@ public:
     void run() Q_DECL_OVERRIDE;
     void registerThreadInactive();
 
+    bool enqueueLocalTask(QRunnable *task, int priority);
+    QRunnable *takeLocalTask(int minimumPriority);
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Runnables started from the runnables run by this thread. They are run
+    // by this thread without going through the pool's mutex, unless an idle
+    // thread steals them. localMutex may be locked while holding the pool's
+    // mutex, but not the other way round.
+    QMutex localMutex;
+    std::deque<QPair<QRunnable *, int> > localQueue;
 };
 
+#ifdef Q_COMPILER_THREAD_LOCAL
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+#endif
+
+/*
+    Returns the thread of \a pool we're running in, if any.
+*/
+static inline QThreadPoolThread *localThread(const QThreadPoolPrivate *pool)
+{
+#ifdef Q_COMPILER_THREAD_LOCAL
+    QThreadPoolThread *thread = currentPoolThread;
+    if (thread && thread->manager == pool)
+        return thread;
+#else
+    Q_UNUSED(pool);
+#endif
+    return nullptr;
+}
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +112,10 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#ifdef Q_COMPILER_THREAD_LOCAL
+    currentPoolThread = this;
+#endif
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -88,35 +123,45 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool autoDelete = r->autoDelete();
+                locker.unlock();
 
+                do {
+                    const bool autoDelete = r->autoDelete();
 
-                // run the task
-                locker.unlock();
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
-                locker.relock();
+                    if (autoDelete && !r->ref.deref())
+                        delete r;
 
-                if (autoDelete && !--r->ref)
-                    delete r;
-            }
+                    // keep going with the tasks started from this thread, as
+                    // long as nothing more important is waiting in the pool's queue
+                    r = takeLocalTask(manager->topQueuedPriority.load());
+                } while (r != 0);
 
-            // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
-                break;
+                locker.relock();
+            }
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            // if too many threads are active, expire this thread, but only
+            // after running the tasks started from it
+            if (manager->tooManyThreadsActive()) {
+                r = takeLocalTask(std::numeric_limits<int>::min());
+                if (!r)
+                    break;
+            } else {
+                r = manager->takeTask(this);
+            }
         } while (r != 0);
 
         if (manager->isExiting) {
@@ -128,6 +173,7 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            manager->saturated.storeRelease(0);
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
@@ -137,6 +183,7 @@ void QThreadPoolThread::run()
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
+            manager->saturated.storeRelease(0);
             registerThreadInactive();
             break;
         }
@@ -149,12 +196,58 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+inline bool operator<(int priority, const QPair<QRunnable *, int> &p)
+{ return p.second < priority; }
+inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
+{ return priority < p.second; }
+
+/*
+    \internal
+    Queues \a task on this thread, returns \c true if the queue was empty.
+    Must be called from this thread.
+*/
+bool QThreadPoolThread::enqueueLocalTask(QRunnable *task, int priority)
+{
+    QMutexLocker localLocker(&localMutex);
+
+    if (task->autoDelete())
+        task->ref.ref();
+
+    const bool wasEmpty = localQueue.empty();
+
+    // same ordering as the pool's queue
+    std::deque<QPair<QRunnable *, int> >::iterator it = localQueue.end();
+    if (it != localQueue.begin() && priority > (*(it - 1)).second)
+        it = std::upper_bound(localQueue.begin(), --it, priority);
+    localQueue.insert(it, qMakePair(task, priority));
+
+    return wasEmpty;
+}
+
+/*
+    \internal
+    Dequeues the first task queued on this thread, if its priority is at least
+    \a minimumPriority. Must be called from this thread.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask(int minimumPriority)
+{
+    QMutexLocker localLocker(&localMutex);
+
+    if (localQueue.empty() || localQueue.front().second < minimumPriority)
+        return 0;
+
+    QRunnable *r = localQueue.front().first;
+    localQueue.pop_front();
+    return r;
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
-    : isExiting(false),
+    : topQueuedPriority(std::numeric_limits<int>::min()),
+      isExiting(false),
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
@@ -170,8 +263,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     }
 
     // can't do anything if we're over the limit
-    if (activeThreadCount() >= maxThreadCount)
+    if (activeThreadCount() >= maxThreadCount) {
+        saturated.storeRelease(1);
         return false;
+    }
 
     if (waitingThreads.count() > 0) {
         // recycle an available thread
@@ -188,7 +283,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            task->ref.ref();
         thread->runnable = task;
         thread->start();
         return true;
@@ -199,15 +294,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     return true;
 }
 
-inline bool operator<(int priority, const QPair<QRunnable *, int> &p)
-{ return p.second < priority; }
-inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
-{ return priority < p.second; }
-
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     if (runnable->autoDelete())
-        ++runnable->ref;
+        runnable->ref.ref();
 
     // put it on the queue
     QVector<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -215,6 +305,126 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     if (it != begin && priority > (*(it - 1)).second)
         it = std::upper_bound(begin, --it, priority);
     queue.insert(it - begin, qMakePair(runnable, priority));
+    updateTopQueuedPriority();
+}
+
+/*!
+    \internal
+    Queues \a task on the calling thread's own queue if the calling thread
+    belongs to this pool, and returns \c true in that case. The pool's mutex
+    is only needed if an idle thread has to be woken up to steal it.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocalTask(QRunnable *task, int priority)
+{
+    QThreadPoolThread *thread = localThread(this);
+    if (!thread)
+        return false;
+
+    if (thread->enqueueLocalTask(task, priority)) {
+        QMutexLocker locker(&mutex);
+        startThief();
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Returns the next task for \a thread to run: the first one queued on the
+    thread itself, unless the pool's queue has one with a higher priority,
+    and otherwise one stolen from another thread.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    const int priority = queue.isEmpty() ? std::numeric_limits<int>::min()
+                                         : queue.constFirst().second;
+    if (QRunnable *r = thread->takeLocalTask(priority))
+        return r;
+
+    if (!queue.isEmpty()) {
+        QRunnable *r = queue.takeFirst().first;
+        updateTopQueuedPriority();
+        return r;
+    }
+
+    return stealLocalTask(thread);
+}
+
+/*!
+    \internal
+    Takes the task with the highest priority from the queues of the threads
+    other than \a thief. If there is more work left, another thread is woken
+    up to help.
+*/
+QRunnable *QThreadPoolPrivate::stealLocalTask(QThreadPoolThread *thief)
+{
+    for (;;) {
+        QThreadPoolThread *victim = 0;
+        int priority = std::numeric_limits<int>::min();
+        for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+            if (thread == thief)
+                continue;
+            QMutexLocker localLocker(&thread->localMutex);
+            if (!thread->localQueue.empty()
+                    && (!victim || thread->localQueue.front().second > priority)) {
+                victim = thread;
+                priority = thread->localQueue.front().second;
+            }
+        }
+
+        if (!victim)
+            return 0;
+
+        QMutexLocker localLocker(&victim->localMutex);
+        if (victim->localQueue.empty())
+            continue; // the owner was faster
+
+        QRunnable *r = victim->localQueue.front().first;
+        victim->localQueue.pop_front();
+        const bool moreWork = !victim->localQueue.empty();
+        localLocker.unlock();
+
+        if (moreWork)
+            startThief();
+        return r;
+    }
+}
+
+/*!
+    \internal
+    Wakes up or starts a thread, if the thread count permits, which will go
+    looking for tasks to steal.
+*/
+void QThreadPoolPrivate::startThief()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        return;
+    }
+
+    if (activeThreadCount() >= maxThreadCount)
+        return;
+
+    if (!expiredThreads.isEmpty()) {
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == 0);
+        ++activeThreads;
+        thread->start();
+        return;
+    }
+
+    startThread();
+}
+
+/*!
+    \internal
+    Publishes the priority of the first task in the queue, so that threads
+    running their own tasks can check whether the queue has something more
+    important without locking the mutex.
+*/
+void QThreadPoolPrivate::updateTopQueuedPriority()
+{
+    topQueuedPriority.store(queue.isEmpty() ? std::numeric_limits<int>::min()
+                                            : queue.constFirst().second);
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -230,6 +440,18 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty() && tryStart(queue.constFirst().first))
         queue.removeFirst();
+    updateTopQueuedPriority();
+
+    // and let the remaining ones help with the tasks queued on busy threads
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        if (activeThreadCount() >= maxThreadCount)
+            break;
+        QMutexLocker localLocker(&thread->localMutex);
+        const bool hasTasks = !thread->localQueue.empty();
+        localLocker.unlock();
+        if (hasTasks)
+            startThief();
+    }
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -248,8 +470,8 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    if (runnable && runnable->autoDelete())
+        runnable->ref.ref();
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -281,6 +503,7 @@ void QThreadPoolPrivate::reset()
 
     waitingThreads.clear();
     expiredThreads.clear();
+    saturated.storeRelease(0);
 
     isExiting = false;
 }
@@ -308,10 +531,21 @@ void QThreadPoolPrivate::clear()
     for (QVector<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (r->autoDelete() && !r->ref.deref())
             delete r;
     }
     queue.clear();
+    updateTopQueuedPriority();
+
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        for (const QPair<QRunnable *, int> &task : thread->localQueue) {
+            QRunnable *r = task.first;
+            if (r->autoDelete() && !r->ref.deref())
+                delete r;
+        }
+        thread->localQueue.clear();
+    }
 }
 
 /*!
@@ -331,10 +565,22 @@ bool QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
         while (it != end) {
             if (it->first == runnable) {
                 queue.erase(it);
+                updateTopQueuedPriority();
                 return true;
             }
             ++it;
         }
+
+        for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            std::deque<QPair<QRunnable *, int> >::iterator lit = thread->localQueue.begin();
+            for (; lit != thread->localQueue.end(); ++lit) {
+                if (lit->first == runnable) {
+                    thread->localQueue.erase(lit);
+                    return true;
+                }
+            }
+        }
     }
 
     return false;
@@ -351,7 +597,7 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     if (!stealRunnable(runnable))
         return;
     const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = autoDelete && !runnable->ref.deref();
 
     runnable->run();
 
@@ -443,6 +689,12 @@ QThreadPool *QThreadPool::globalInstance()
     \a runnable is added to a run queue instead. The \a priority argument can
     be used to control the run queue's order of execution.
 
+    When called from a runnable that is run by this thread pool, \a runnable
+    is queued on the calling thread instead, which runs it once the calling
+    runnable has returned, unless an idle thread of the pool picks it up
+    first. This avoids contention on the pool's run queue for tasks that
+    start more tasks.
+
     Note that the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
     and the \a runnable will be deleted automatically by the thread
@@ -458,6 +710,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->tryEnqueueLocalTask(runnable, priority))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -474,6 +729,10 @@ void QThreadPool::start(QRunnable *runnable, int priority)
     does nothing and returns \c false.  Otherwise, \a runnable is run immediately
     using one available thread and this function returns \c true.
 
+    When called from a runnable that is run by this thread pool, \a runnable
+    is queued on the calling thread for the available thread to pick up, and
+    the calling thread runs it itself if it gets to it first.
+
     Note that the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
     and the \a runnable will be deleted automatically by the thread
@@ -490,10 +749,25 @@ bool QThreadPool::tryStart(QRunnable *runnable)
 
     Q_D(QThreadPool);
 
+    // QtConcurrent keeps asking while the pool is busy; don't contend on the
+    // mutex for an answer that cannot have changed
+    if (d->saturated.loadAcquire())
+        return false;
+
     QMutexLocker locker(&d->mutex);
 
-    if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
+    if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount) {
+        d->saturated.storeRelease(1);
         return false;
+    }
+
+    // from a thread of this pool, the task is queued on that thread and the
+    // thread that is started for it steals it, unless the caller gets to it first
+    if (QThreadPoolThread *thread = localThread(d)) {
+        thread->enqueueLocalTask(runnable, 0);
+        d->startThief();
+        return true;
+    }
 
     return d->tryStart(runnable);
 }
@@ -552,6 +826,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->maxThreadCount = maxThreadCount;
+    d->saturated.storeRelease(0);
     d->tryToStartMoreThreads();
 }
 
@@ -608,6 +883,7 @@ void QThreadPool::releaseThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
+    d->saturated.storeRelease(0);
     d->tryToStartMoreThreads();
 }
 
@@ -655,7 +931,7 @@ void QThreadPool::cancel(QRunnable *runnable)
     Q_D(QThreadPool);
     if (!d->stealRunnable(runnable))
         return;
-    if (runnable->autoDelete() && !--runnable->ref) {
+    if (runnable->autoDelete() && !runnable->ref.deref()) {
         delete runnable;
     }
 }
@@ -73,6 +73,11 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    bool tryEnqueueLocalTask(QRunnable *task, int priority);
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    QRunnable *stealLocalTask(QThreadPoolThread *thief);
+    void startThief();
+    void updateTopQueuedPriority();
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -90,6 +95,10 @@ public:
     QQueue<QThreadPoolThread *> waitingThreads;
     QQueue<QThreadPoolThread *> expiredThreads;
     QVector<QPair<QRunnable *, int> > queue;
+    QAtomicInt topQueuedPriority;
+    // set when tryStart() finds no thread available, cleared whenever one may
+    // have become available, so that tryStart() can fail without the mutex
+    QAtomicInt saturated;
     QWaitCondition noActiveThreads;
 
     bool isExiting;
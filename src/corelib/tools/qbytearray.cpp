@@ -2581,11 +2581,10 @@ int QByteArray::indexOf(char ch, int from) const
     if (from < 0)
         from = qMax(from + d->size, 0);
     if (from < d->size) {
-        const char *n = d->data() + from - 1;
-        const char *e = d->data() + d->size;
-        while (++n != e)
-        if (*n == ch)
-            return  n - d->data();
+        // memchr is vectorized, and picks the best variant for the CPU at load time
+        const char *n = static_cast<const char *>(memchr(d->data() + from, ch, d->size - from));
+        if (n)
+            return n - d->data();
     }
     return -1;
 }
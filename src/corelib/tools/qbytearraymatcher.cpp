@@ -38,6 +38,8 @@
 ****************************************************************************/
 
 #include "qbytearraymatcher.h"
+#include "qalgorithms.h"
+#include "qsimd_p.h"
 
 #include <limits.h>
 
@@ -236,11 +238,10 @@ static int findChar(const char *str, int len, char ch, int from)
     if (from < 0)
         from = qMax(from + len, 0);
     if (from < len) {
-        const uchar *n = s + from - 1;
-        const uchar *e = s + len;
-        while (++n != e)
-            if (*n == c)
-                return  n - s;
+        // memchr is vectorized, and picks the best variant for the CPU at load time
+        const uchar *n = static_cast<const uchar *>(memchr(s + from, c, len - from));
+        if (n)
+            return n - s;
     }
     return -1;
 }
@@ -260,6 +261,60 @@ static int qFindByteArrayBoyerMoore(
                    (const uchar *)needle, needleLen, skiptable);
 }
 
+/*
+    Vectorized search for needles of at least two bytes: compares the first
+    and last byte of the needle against a block of candidate positions at
+    once, and only checks the positions where both match. Returns the match,
+    or the first position it did not check; \a end is one past the last
+    possible match.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+QT_FUNCTION_TARGET(AVX2)
+static const char *qFindByteArray_avx2(const char *haystack, const char *end,
+                                       const char *needle, int needleLen, bool *found)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleLen - 1]);
+    for ( ; end - haystack >= 32; haystack += 32) {
+        const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack));
+        const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + needleLen - 1));
+        uint mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                                          _mm256_cmpeq_epi8(blockLast, last)));
+        for ( ; mask; mask &= mask - 1) {
+            const char *candidate = haystack + qCountTrailingZeroBits(mask);
+            if (memcmp(candidate + 1, needle + 1, needleLen - 2) == 0) {
+                *found = true;
+                return candidate;
+            }
+        }
+    }
+    return haystack;
+}
+#endif
+
+#ifdef __SSE2__
+static const char *qFindByteArray_sse2(const char *haystack, const char *end,
+                                       const char *needle, int needleLen, bool *found)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleLen - 1]);
+    for ( ; end - haystack >= 16; haystack += 16) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + needleLen - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                    _mm_cmpeq_epi8(blockLast, last)));
+        for ( ; mask; mask &= mask - 1) {
+            const char *candidate = haystack + qCountTrailingZeroBits(mask);
+            if (memcmp(candidate + 1, needle + 1, needleLen - 2) == 0) {
+                *found = true;
+                return candidate;
+            }
+        }
+    }
+    return haystack;
+}
+#endif
+
 #define REHASH(a) \
     if (sl_minus_1 < sizeof(uint) * CHAR_BIT) \
         hashHaystack -= uint(a) << sl_minus_1; \
@@ -289,19 +344,39 @@ int qFindByteArray(
     /*
       We use the Boyer-Moore algorithm in cases where the overhead
       for the skip table should pay off, otherwise we use a simple
-      hash function.
+      hash function. Where SIMD is available, the first and last
+      byte filter beats Boyer-Moore unless the needle is long.
     */
+#ifdef __SSE2__
+    if (l > 500 && sl > 64)
+#else
     if (l > 500 && sl > 5)
+#endif
         return qFindByteArrayBoyerMoore(haystack0, haystackLen, from,
                                         needle, needleLen);
 
+    const char *haystack = haystack0 + from;
+    const char *end = haystack0 + (l - sl);
+
+#ifdef __SSE2__
+    bool found = false;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (end + 1 - haystack >= 32 && qCpuHasFeature(AVX2))
+        haystack = qFindByteArray_avx2(haystack, end + 1, needle, sl, &found);
+#  endif
+    if (!found)
+        haystack = qFindByteArray_sse2(haystack, end + 1, needle, sl, &found);
+    if (found)
+        return haystack - haystack0;
+    if (haystack > end)
+        return -1;
+#endif
+
     /*
       We use some hashing for efficiency's sake. Instead of
       comparing strings, we compare the hash value of str with that
       of a part of this QString. Only if that matches, we call memcmp().
     */
-    const char *haystack = haystack0 + from;
-    const char *end = haystack0 + (l - sl);
     const uint sl_minus_1 = sl - 1;
     uint hashNeedle = 0, hashHaystack = 0;
     int idx;
@@ -0,0 +1,833 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <string.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+Q_CORE_EXPORT uint qFlatHashSeed();
+
+// The control byte of a slot is either one of these, or the top 7 bits of
+// the hash of the key stored in it.
+enum QFlatHashCtrl : signed char {
+    QFlatHashEmpty = -128,
+    QFlatHashDeleted = -2
+};
+
+// A group of control bytes that is probed at once. Tables are laid out the
+// same whether or not the SIMD path is compiled in, so they can be shared
+// between code built with different flags.
+class QFlatHashGroup
+{
+public:
+    enum { Width = 16 };
+
+    explicit QFlatHashGroup(const signed char *ctrl) Q_DECL_NOTHROW
+#if defined(__SSE2__)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl)))
+    {
+    }
+
+    // bit N of the results refers to the Nth slot of the group
+    uint match(signed char h2) const Q_DECL_NOTHROW
+    { return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)))); }
+    uint matchFree() const Q_DECL_NOTHROW
+    { return uint(_mm_movemask_epi8(ctrl)); }
+
+private:
+    __m128i ctrl;
+#else
+        : ctrl(ctrl)
+    {
+    }
+
+    // bit N of the results refers to the Nth slot of the group
+    uint match(signed char h2) const Q_DECL_NOTHROW
+    {
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] == h2) << i;
+        return mask;
+    }
+    uint matchFree() const Q_DECL_NOTHROW
+    {
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] < 0) << i;
+        return mask;
+    }
+
+private:
+    const signed char *ctrl;
+#endif
+
+public:
+    uint matchEmpty() const Q_DECL_NOTHROW { return match(QFlatHashEmpty); }
+};
+
+// qHash() results are often poorly distributed (integers hash to
+// themselves), so mix them before splitting into group index and tag.
+inline uint qFlatHashMix(uint h) Q_DECL_NOTHROW
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+    void setValue(const T &value0) { value = value0; }
+
+    Key key;
+    T value;
+};
+
+template <class Key>
+struct QFlatHashNode<Key, QHashDummyValue>
+{
+    QFlatHashNode(const Key &key0, const QHashDummyValue &) : key(key0) {}
+    void setValue(const QHashDummyValue &) {}
+
+    Key key;
+};
+
+} // namespace QtPrivate
+
+struct QFlatHashData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int growthLeft; // free slots that can be used before rehashing
+    int capacity;   // a power of two, at least QFlatHashGroup::Width
+    uint seed;
+    signed char *ctrl;
+    void *nodes;
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QtPrivate::QFlatHashNode<Key, T> Node;
+    typedef QtPrivate::QFlatHashGroup Group;
+
+    QFlatHashData *d;
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(nullptr) {}
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key, T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+    QFlatHash(const QFlatHash &other) Q_DECL_NOTHROW : d(other.d) { if (d) d->ref.ref(); }
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = nullptr; }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other) Q_DECL_NOTHROW
+    { QFlatHash copy(other); swap(copy); return *this; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const Q_DECL_NOTHROW { return d ? d->size : 0; }
+    inline int count() const Q_DECL_NOTHROW { return size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return size() == 0; }
+    inline int capacity() const Q_DECL_NOTHROW { return d ? maxLoad(d->capacity) : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const Q_DECL_NOTHROW { return !d || !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const Q_DECL_NOTHROW { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        iterator(QFlatHashData *data, int index) Q_DECL_NOTHROW : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        iterator() Q_DECL_NOTHROW : d(nullptr), i(0) {}
+
+        inline const Key &key() const { return node()->key; }
+        inline T &value() const { return node()->value; }
+        inline T &operator*() const { return node()->value; }
+        inline T *operator->() const { return &node()->value; }
+        inline bool operator==(const iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline iterator &operator++() { i = nextFull(d, i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; i = nextFull(d, i); return r; }
+
+    private:
+        inline Node *node() const { return static_cast<Node *>(d->nodes) + i; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+        const_iterator(const QFlatHashData *data, int index) Q_DECL_NOTHROW : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const_iterator() Q_DECL_NOTHROW : d(nullptr), i(0) {}
+        const_iterator(const iterator &o) Q_DECL_NOTHROW : d(o.d), i(o.i) {}
+
+        inline const Key &key() const { return node()->key; }
+        inline const T &value() const { return node()->value; }
+        inline const T &operator*() const { return node()->value; }
+        inline const T *operator->() const { return &node()->value; }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        inline const_iterator &operator++() { i = nextFull(d, i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; i = nextFull(d, i); return r; }
+
+    private:
+        inline const Node *node() const { return static_cast<const Node *>(d->nodes) + i; }
+    };
+    friend class const_iterator;
+
+    inline iterator begin() { detach(); return iterator(d, d ? nextFull(d, -1) : 0); }
+    inline const_iterator begin() const Q_DECL_NOTHROW { return cbegin(); }
+    inline const_iterator cbegin() const Q_DECL_NOTHROW { return const_iterator(d, d ? nextFull(d, -1) : 0); }
+    inline const_iterator constBegin() const Q_DECL_NOTHROW { return cbegin(); }
+    inline iterator end() { detach(); return iterator(d, d ? d->capacity : 0); }
+    inline const_iterator end() const Q_DECL_NOTHROW { return cend(); }
+    inline const_iterator cend() const Q_DECL_NOTHROW { return const_iterator(d, d ? d->capacity : 0); }
+    inline const_iterator constEnd() const Q_DECL_NOTHROW { return cend(); }
+
+    iterator erase(iterator it);
+    iterator erase(const_iterator it) { return erase(iterator(d, it.i)); }
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const Q_DECL_NOTHROW { return isEmpty(); }
+
+private:
+    static inline int maxLoad(int capacity) Q_DECL_NOTHROW { return capacity - capacity / 8; }
+    static int capacityFor(int size);
+    static int nextFull(const QFlatHashData *d, int i) Q_DECL_NOTHROW;
+    static inline uint hashOf(const Key &key, uint seed)
+    { return QtPrivate::qFlatHashMix(qHash(key, seed)); }
+    static inline signed char tagOf(uint hash) Q_DECL_NOTHROW { return static_cast<signed char>(hash >> 25); }
+
+    inline Node *nodes() const Q_DECL_NOTHROW { return static_cast<Node *>(d->nodes); }
+
+    static QFlatHashData *allocateData(int capacity, uint seed);
+    static void freeData(QFlatHashData *x);
+    void detach_helper();
+    void rehash(int capacity);
+
+    int findIndex(const Key &key) const;
+    int findIndex(const Key &key, uint hash) const;
+    static int findFree(const QFlatHashData *d, uint hash) Q_DECL_NOTHROW;
+    int findOrInsert(const Key &key, bool *found);
+    int growAndInsert(const Key &key);
+    void eraseAt(int i);
+
+    template <class> friend class QFlatSet;
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::capacityFor(int size)
+{
+    int capacity = Group::Width;
+    while (maxLoad(capacity) < size) {
+        if (capacity > std::numeric_limits<int>::max() / 2)
+            qBadAlloc();
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::nextFull(const QFlatHashData *d, int i) Q_DECL_NOTHROW
+{
+    while (++i < d->capacity && d->ctrl[i] < 0)
+        ;
+    return i;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QFlatHashData *QFlatHash<Key, T>::allocateData(int capacity, uint seed)
+{
+    Q_STATIC_ASSERT(Q_ALIGNOF(Node) <= Group::Width);
+
+    // the control bytes and the slots share one block; capacity is a
+    // multiple of the group width, so the slots are suitably aligned
+    QFlatHashData *x = new QFlatHashData;
+    x->ref.atomic.store(1);
+    x->size = 0;
+    x->growthLeft = maxLoad(capacity);
+    x->capacity = capacity;
+    x->seed = seed;
+    x->ctrl = static_cast<signed char *>(::operator new(size_t(capacity) * (1 + sizeof(Node))));
+    x->nodes = x->ctrl + capacity;
+    memset(x->ctrl, QtPrivate::QFlatHashEmpty, size_t(capacity));
+    return x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Node *n = static_cast<Node *>(x->nodes);
+        for (int i = 0; i < x->capacity; ++i) {
+            if (x->ctrl[i] >= 0)
+                n[i].~Node();
+        }
+    }
+    ::operator delete(x->ctrl);
+    delete x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    // keep the layout of the shared table, so that nothing needs rehashing
+    QFlatHashData *x = allocateData(d->capacity, d->seed);
+    memcpy(x->ctrl, d->ctrl, size_t(d->capacity));
+    const Node *from = nodes();
+    Node *to = static_cast<Node *>(x->nodes);
+    for (int i = 0; i < d->capacity; ++i) {
+        if (d->ctrl[i] >= 0)
+            new (to + i) Node(from[i]);
+    }
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int capacity)
+{
+    QFlatHashData *x = allocateData(capacity, d ? d->seed : QtPrivate::qFlatHashSeed());
+    if (d) {
+        const bool shared = d->ref.isShared();
+        Node *from = nodes();
+        Node *to = static_cast<Node *>(x->nodes);
+        for (int i = 0; i < d->capacity; ++i) {
+            if (d->ctrl[i] < 0)
+                continue;
+            const uint hash = hashOf(from[i].key, x->seed);
+            const int j = findFree(x, hash);
+            x->ctrl[j] = tagOf(hash);
+            if (shared) {
+                new (to + j) Node(from[i]);
+            } else {
+                new (to + j) Node(std::move(from[i]));
+                from[i].~Node();
+                d->ctrl[i] = QtPrivate::QFlatHashEmpty;
+            }
+        }
+        x->size = d->size;
+        x->growthLeft -= d->size;
+        if (!d->ref.deref())
+            freeData(d);
+    }
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findFree(const QFlatHashData *d, uint hash) Q_DECL_NOTHROW
+{
+    // triangular probing visits every group, as the group count is a power of two
+    const uint groupMask = uint(d->capacity / Group::Width) - 1;
+    uint group = hash & groupMask;
+    for (uint step = 1; ; ++step) {
+        const uint mask = Group(d->ctrl + group * Group::Width).matchFree();
+        if (mask)
+            return int(group * Group::Width + qCountTrailingZeroBits(mask));
+        group = (group + step) & groupMask;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key) const
+{
+    if (!d || !d->size)
+        return -1;
+    return findIndex(key, hashOf(key, d->seed));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint hash) const
+{
+    const signed char tag = tagOf(hash);
+    const uint groupMask = uint(d->capacity / Group::Width) - 1;
+    uint group = hash & groupMask;
+    for (uint step = 1; ; ++step) {
+        const int base = int(group * Group::Width);
+        const Group g(d->ctrl + base);
+        for (uint mask = g.match(tag); mask; mask &= mask - 1) {
+            const int i = base + int(qCountTrailingZeroBits(mask));
+            if (nodes()[i].key == key)
+                return i;
+        }
+        // a key is never stored past a group that still has empty slots
+        if (g.matchEmpty())
+            return -1;
+        group = (group + step) & groupMask;
+    }
+}
+
+/*
+    Returns the index of \a key, or claims a slot for it and returns that.
+    Returns -1 if the table is out of free slots; the caller must then copy
+    the key and value, which may refer to an element of this hash, and call
+    growAndInsert().
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findOrInsert(const Key &key, bool *found)
+{
+    *found = false;
+    detach();
+    if (d) {
+        const uint hash = hashOf(key, d->seed);
+        if (d->size) {
+            const int i = findIndex(key, hash);
+            if (i >= 0) {
+                *found = true;
+                return i;
+            }
+        }
+        if (d->growthLeft > 0) {
+            const int i = findFree(d, hash);
+            if (d->ctrl[i] == QtPrivate::QFlatHashEmpty)
+                --d->growthLeft;
+            d->ctrl[i] = tagOf(hash);
+            ++d->size;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+    Rehashes and claims a slot for \a key, which is not in the hash. \a key
+    must not refer to an element of this hash, as rehashing moves them.
+*/
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::growAndInsert(const Key &key)
+{
+    // grow if the table is mostly full, otherwise just get rid of the
+    // deleted slots
+    if (!d)
+        rehash(Group::Width);
+    else if (d->size >= d->capacity / 32 * 25)
+        rehash(capacityFor(maxLoad(d->capacity) + 1));
+    else
+        rehash(d->capacity);
+
+    const uint hash = hashOf(key, d->seed);
+    const int i = findFree(d, hash);
+    --d->growthLeft;
+    d->ctrl[i] = tagOf(hash);
+    ++d->size;
+    return i;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i)
+{
+    nodes()[i].~Node();
+    // Lookups never continue past a group with empty slots, so if this group
+    // has one, the slot can become empty again instead of being marked deleted.
+    if (Group(d->ctrl + (i & ~(Group::Width - 1))).matchEmpty()) {
+        d->ctrl[i] = QtPrivate::QFlatHashEmpty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = QtPrivate::QFlatHashDeleted;
+    }
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    if (asize > capacity())
+        rehash(capacityFor(asize));
+    else
+        detach();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!d)
+        return;
+    if (!d->size)
+        clear();
+    else
+        rehash(capacityFor(d->size));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    const int i = findIndex(key);
+    if (i < 0)
+        return 0;
+    detach();
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    const int i = findIndex(key);
+    if (i < 0)
+        return T();
+    detach();
+    T t = std::move(nodes()[i].value);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? T() : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? defaultValue : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    bool found;
+    int i = findOrInsert(key, &found);
+    if (i < 0) {
+        const Key copy(key);
+        i = growAndInsert(copy);
+        new (nodes() + i) Node(copy, T());
+    } else if (!found) {
+        new (nodes() + i) Node(key, T());
+    }
+    return nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &key) const
+{
+    return value(key);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    bool found;
+    int i = findOrInsert(key, &found);
+    if (i < 0) {
+        // growing invalidates key and value if they refer to an element
+        const Key keyCopy(key);
+        const T valueCopy(value);
+        i = growAndInsert(keyCopy);
+        new (nodes() + i) Node(keyCopy, valueCopy);
+    } else if (found) {
+        nodes()[i].setValue(value);
+    } else {
+        new (nodes() + i) Node(key, value);
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    const int i = findIndex(key);
+    if (i < 0)
+        return end();
+    detach();
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &key) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? cend() : const_iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator it)
+{
+    Q_ASSERT_X(it.i >= 0 && d && it.i < d->capacity && d->ctrl[it.i] >= 0,
+               "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    if (d->ref.isShared()) {
+        // the iterator refers to the same slot in the detached copy
+        detach();
+        it.d = d;
+    }
+    eraseAt(it.i);
+    ++it;
+    return it;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = cbegin(), e = cend(); it != e; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = cbegin(), e = cend(); it != e; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = cbegin(), e = cend(); it != e; ++it) {
+        const int i = other.findIndex(it.key());
+        if (i < 0 || !(other.nodes()[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class T>
+class QFlatSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatSet() Q_DECL_NOTHROW {}
+    inline QFlatSet(std::initializer_list<T> list)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<T>::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(*it);
+    }
+
+    void swap(QFlatSet &other) Q_DECL_NOTHROW { q_hash.swap(other.q_hash); }
+
+    bool operator==(const QFlatSet &other) const;
+    inline bool operator!=(const QFlatSet &other) const { return !(*this == other); }
+
+    inline int size() const Q_DECL_NOTHROW { return q_hash.size(); }
+    inline int count() const Q_DECL_NOTHROW { return q_hash.size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return q_hash.isEmpty(); }
+    inline int capacity() const Q_DECL_NOTHROW { return q_hash.capacity(); }
+    inline void reserve(int size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const Q_DECL_NOTHROW { return q_hash.isDetached(); }
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value) != 0; }
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    class const_iterator
+    {
+        typename Hash::const_iterator i;
+        friend class QFlatSet<T>;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() Q_DECL_NOTHROW {}
+        inline const_iterator(typename Hash::const_iterator o) Q_DECL_NOTHROW : i(o) {}
+
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+    };
+    typedef const_iterator iterator;
+
+    inline const_iterator begin() const Q_DECL_NOTHROW { return q_hash.cbegin(); }
+    inline const_iterator cbegin() const Q_DECL_NOTHROW { return q_hash.cbegin(); }
+    inline const_iterator constBegin() const Q_DECL_NOTHROW { return q_hash.cbegin(); }
+    inline const_iterator end() const Q_DECL_NOTHROW { return q_hash.cend(); }
+    inline const_iterator cend() const Q_DECL_NOTHROW { return q_hash.cend(); }
+    inline const_iterator constEnd() const Q_DECL_NOTHROW { return q_hash.cend(); }
+
+    inline const_iterator erase(const_iterator it)
+    { return typename Hash::const_iterator(q_hash.erase(it.i)); }
+    inline const_iterator find(const T &value) const { return q_hash.constFind(value); }
+    inline const_iterator constFind(const T &value) const { return q_hash.constFind(value); }
+    inline const_iterator insert(const T &value)
+    { return typename Hash::const_iterator(q_hash.insert(value, QHashDummyValue())); }
+
+    QList<T> values() const { return q_hash.keys(); }
+    QList<T> toList() const { return q_hash.keys(); }
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const Q_DECL_NOTHROW { return isEmpty(); }
+
+private:
+    Hash q_hash;
+};
+
+template <class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatSet<T>::operator==(const QFlatSet &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (q_hash.isSharedWith(other.q_hash))
+        return true;
+    for (const_iterator it = cbegin(), e = cend(); it != e; ++it) {
+        if (!other.contains(*it))
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
@@ -47,6 +47,7 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
 
 #ifdef truncate
 #undef truncate
@@ -361,6 +362,18 @@ int qGlobalQHashSeed()
     return qt_qhash_seed.load();
 }
 
+/*!
+    \internal
+
+    Returns the seed for a newly created QFlatHash, initializing the global
+    QHash seed if no QHash did so yet.
+*/
+uint QtPrivate::qFlatHashSeed()
+{
+    qt_initialize_qhash_seed();
+    return uint(qt_qhash_seed.load());
+}
+
 /*! \relates QHash
     \since 5.6
 
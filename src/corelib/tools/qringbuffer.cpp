@@ -69,6 +69,28 @@ const char *QRingBuffer::readPointerAtPosition(qint64 pos, qint64 &length) const
     return 0;
 }
 
+/*!
+    \internal
+
+    Fills \a pointers and \a lengths with up to \a maxCount consecutive
+    blocks from the beginning of the buffer, e.g. for a scatter/gather
+    write, and returns how many it filled in.
+*/
+int QRingBuffer::readPointers(const char **pointers, qint64 *lengths, int maxCount) const
+{
+    if (bufferSize == 0 || maxCount <= 0)
+        return 0;
+
+    const int count = qMin(maxCount, tailBuffer + 1);
+    for (int i = 0; i < count; ++i) {
+        pointers[i] = buffers[i].constData();
+        lengths[i] = (i == tailBuffer ? tail : buffers[i].size());
+    }
+    pointers[0] += head;
+    lengths[0] -= head;
+    return count;
+}
+
 void QRingBuffer::free(qint64 bytes)
 {
     Q_ASSERT(bytes <= bufferSize);
@@ -111,15 +133,19 @@ char *QRingBuffer::reserve(qint64 bytes)
     if (bufferSize == 0) {
         if (buffers.isEmpty())
             buffers.append(QByteArray(qMax(basicBlockSize, int(bytes)), Qt::Uninitialized));
+        else if (!buffers.constFirst().isDetached()) // don't copy a shared array
+            buffers.first() = QByteArray(qMax(basicBlockSize, int(bytes)), Qt::Uninitialized);
         else
             buffers.first().resize(qMax(basicBlockSize, int(bytes)));
     } else {
         const qint64 newSize = bytes + tail;
-        // if need a new buffer
-        if (basicBlockSize == 0 || (newSize > buffers.constLast().capacity()
-                                    && (tail >= basicBlockSize || newSize >= MaxByteArraySize))) {
+        // if need a new buffer; a block still shared with the array passed
+        // to append(const QByteArray &) is never written to
+        if (basicBlockSize == 0 || !buffers.constLast().isDetached()
+            || (newSize > buffers.constLast().capacity()
+                && (tail >= basicBlockSize || newSize >= MaxByteArraySize))) {
             // shrink this buffer to its current size
-            buffers.last().resize(tail);
+            trimLastBuffer();
 
             // create a new QByteArray
             buffers.append(QByteArray(qMax(basicBlockSize, int(bytes)), Qt::Uninitialized));
@@ -273,9 +299,11 @@ QByteArray QRingBuffer::read()
 
     QByteArray qba(buffers.takeFirst());
 
-    qba.reserve(0); // avoid that resizing needlessly reallocates
     if (tailBuffer == 0) {
-        qba.resize(tail);
+        if (qba.size() != tail) {
+            qba.reserve(0); // avoid that resizing needlessly reallocates
+            qba.resize(tail);
+        }
         tail = 0;
     } else {
         --tailBuffer;
@@ -335,13 +363,16 @@ void QRingBuffer::append(const char *data, qint64 size)
 */
 void QRingBuffer::append(const QByteArray &qba)
 {
+    if (qba.isEmpty())
+        return;
+
     if (tail == 0) {
         if (buffers.isEmpty())
             buffers.append(qba);
         else
             buffers.last() = qba;
     } else {
-        buffers.last().resize(tail);
+        trimLastBuffer();
         buffers.append(qba);
         ++tailBuffer;
     }
@@ -349,6 +380,20 @@ void QRingBuffer::append(const QByteArray &qba)
     bufferSize += tail;
 }
 
+/*!
+    \internal
+
+    Drops the unused space at the end of the last buffer before a new one
+    is appended. QByteArray::resize() detaches a shared array even if its
+    size does not change, so a shared block is only touched if it was
+    chopped.
+*/
+void QRingBuffer::trimLastBuffer()
+{
+    if (buffers.constLast().size() != tail)
+        buffers.last().resize(tail);
+}
+
 qint64 QRingBuffer::readLine(char *data, qint64 maxLength)
 {
     if (!data || --maxLength <= 0)
@@ -84,6 +84,7 @@ public:
     }
 
     Q_CORE_EXPORT const char *readPointerAtPosition(qint64 pos, qint64 &length) const;
+    Q_CORE_EXPORT int readPointers(const char **pointers, qint64 *lengths, int maxCount) const;
     Q_CORE_EXPORT void free(qint64 bytes);
     Q_CORE_EXPORT char *reserve(qint64 bytes);
     Q_CORE_EXPORT char *reserveFront(qint64 bytes);
@@ -152,6 +153,8 @@ public:
     }
 
 private:
+    void trimLastBuffer();
+
     QList<QByteArray> buffers;
     int head, tail;
     int tailBuffer; // always buffers.size() - 1
@@ -206,6 +206,136 @@ inline RetType UnrollTailLoop<0>::exec(int, RetType returnIfExited, Functor1, Fu
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+/*
+    AVX2 versions of the kernels below. Distribution builds target the x86-64
+    baseline, so these are compiled separately and chosen at run time with
+    qCpuHasFeature(), which reads the features detected once at startup.
+
+    Each processes as many whole 32-byte blocks as it can and returns the
+    index at which it stopped, leaving the tail to the SSE2 code.
+*/
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_from_latin1_avx2(ushort *dst, const char *str, qptrdiff size)
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 32 <= size; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset),
+                            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset + 16),
+                            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1)));
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_to_latin1_avx2(uchar *dst, const ushort *src, qptrdiff length)
+{
+    const __m256i questionMark = _mm256_set1_epi16('?');
+    const __m256i latin1Max = _mm256_set1_epi16(0xff);
+    qptrdiff offset = 0;
+    for ( ; offset + 32 <= length; offset += 32) {
+        __m256i chunk1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset));
+        __m256i chunk2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset + 16));
+
+        // replace the non-Latin 1 characters with question marks
+        const __m256i inRange1 = _mm256_cmpeq_epi16(_mm256_min_epu16(chunk1, latin1Max), chunk1);
+        const __m256i inRange2 = _mm256_cmpeq_epi16(_mm256_min_epu16(chunk2, latin1Max), chunk2);
+        chunk1 = _mm256_blendv_epi8(questionMark, chunk1, inRange1);
+        chunk2 = _mm256_blendv_epi8(questionMark, chunk2, inRange2);
+
+        // packing works within 128-bit lanes, so restore the order afterwards
+        const __m256i result = _mm256_permute4x64_epi64(_mm256_packus_epi16(chunk1, chunk2),
+                                                        _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), result);
+    }
+    return offset;
+}
+
+// returns the index of the first difference, or where it stopped
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff ucstrncmp_avx2(const ushort *a, const ushort *b, qptrdiff l)
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 16 <= l; offset += 16) {
+        const __m256i a_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + offset));
+        const __m256i b_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + offset));
+        const uint mask = ~uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a_data, b_data)));
+        if (mask)
+            return offset + qCountTrailingZeroBits(mask) / 2;
+    }
+    return offset;
+}
+
+// same as above, comparing against Latin 1 data
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff ucstrncmp_latin1_avx2(const ushort *uc, const uchar *c, qptrdiff l)
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 32 <= l; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + offset));
+        const __m256i ldata1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk));
+        const __m256i ldata2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1));
+        const __m256i ucdata1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(uc + offset));
+        const __m256i ucdata2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(uc + offset + 16));
+        uint mask = ~uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(ldata1, ucdata1)));
+        if (mask)
+            return offset + qCountTrailingZeroBits(mask) / 2;
+        mask = ~uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(ldata2, ucdata2)));
+        if (mask)
+            return offset + 16 + qCountTrailingZeroBits(mask) / 2;
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i asciiToLower_avx2(__m256i data)
+{
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi16(data, _mm256_set1_epi16('A' - 1)),
+                                           _mm256_cmpgt_epi16(_mm256_set1_epi16('Z' + 1), data));
+    return _mm256_or_si256(data, _mm256_and_si256(upper, _mm256_set1_epi16(0x20)));
+}
+
+/*
+    Skips the leading blocks of two strings that are pure ASCII and equal
+    when ignoring case, which is where case-insensitive comparisons of
+    identifiers, headers and the like spend their time. Returns where it
+    stopped; the caller folds the rest character by character.
+*/
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff ucstrnicmp_ascii_avx2(const ushort *a, const ushort *b, qptrdiff l)
+{
+    const __m256i nonAscii = _mm256_set1_epi16(short(0xff80));
+    qptrdiff offset = 0;
+    for ( ; offset + 16 <= l; offset += 16) {
+        const __m256i a_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + offset));
+        const __m256i b_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + offset));
+        if (!_mm256_testz_si256(_mm256_or_si256(a_data, b_data), nonAscii))
+            break;
+        const __m256i equal = _mm256_cmpeq_epi16(asciiToLower_avx2(a_data), asciiToLower_avx2(b_data));
+        if (uint(_mm256_movemask_epi8(equal)) != 0xffffffffU)
+            break;
+    }
+    return offset;
+}
+
+// returns the index of the first occurrence of c, or where it stopped
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff findChar_avx2(const ushort *s, qptrdiff len, ushort c)
+{
+    const __m256i mch = _mm256_set1_epi16(short(c));
+    qptrdiff offset = 0;
+    for ( ; offset + 16 <= len; offset += 16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + offset));
+        const uint mask = uint(_mm256_movemask_epi8(_mm256_cmpeq_epi16(data, mch)));
+        if (mask)
+            return offset + qCountTrailingZeroBits(mask) / 2;
+    }
+    return offset;
+}
+#endif
+
 // conversion between Latin 1 and UTF-16
 void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW
 {
@@ -216,17 +346,14 @@ void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW
 #if defined(__SSE2__)
     const char *e = str + size;
     qptrdiff offset = 0;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (size >= 32 && qCpuHasFeature(AVX2))
+        offset = qt_from_latin1_avx2(dst, str, qptrdiff(size));
+#  endif
 
     // we're going to read str[offset..offset+15] (16 bytes)
     for ( ; str + offset + 15 < e; offset += 16) {
         const __m128i chunk = _mm_loadu_si128((const __m128i*)(str + offset)); // load
-#ifdef __AVX2__
-        // zero extend to an YMM register
-        const __m256i extended = _mm256_cvtepu8_epi16(chunk);
-
-        // store
-        _mm256_storeu_si256((__m256i*)(dst + offset), extended);
-#else
         const __m128i nullMask = _mm_set1_epi32(0);
 
         // unpack the first 8 bytes, padding with zeros
@@ -236,7 +363,6 @@ void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW
         // unpack the last 8 bytes, padding with zeros
         const __m128i secondHalf = _mm_unpackhi_epi8 (chunk, nullMask);
         _mm_storeu_si128((__m128i*)(dst + offset + 8), secondHalf); // store
-#endif
     }
 
     size = size % 16;
@@ -317,6 +443,10 @@ static void qt_to_latin1(uchar *dst, const ushort *src, int length)
 #if defined(__SSE2__)
     uchar *e = dst + length;
     qptrdiff offset = 0;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (length >= 32 && qCpuHasFeature(AVX2))
+        offset = qt_to_latin1_avx2(dst, src, length);
+#  endif
 
     // we're going to write to dst[offset..offset+15] (16 bytes)
     for ( ; dst + offset + 15 < e; offset += 16) {
@@ -386,6 +516,14 @@ static int ucstricmp(const ushort *a, const ushort *ae, const ushort *b, const u
     if (be - b < ae - a)
         e = a + (be - b);
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (e - a >= 16 && qCpuHasFeature(AVX2)) {
+        const qptrdiff skipped = ucstrnicmp_ascii_avx2(a, b, e - a);
+        a += skipped;
+        b += skipped;
+    }
+#endif
+
     uint alast = 0;
     uint blast = 0;
     while (a < e) {
@@ -463,6 +601,18 @@ static int ucstrncmp(const QChar *a, const QChar *b, int l)
                                          l);
     }
 #endif // __mips_dsp
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (l >= 16 && qCpuHasFeature(AVX2)) {
+        const int done = l & ~15;
+        const int idx = int(ucstrncmp_avx2(reinterpret_cast<const ushort *>(a),
+                                           reinterpret_cast<const ushort *>(b), done));
+        if (idx < done)
+            return a[idx].unicode() - b[idx].unicode();
+        a += done;
+        b += done;
+        l -= done;
+    }
+#endif
 #ifdef __SSE2__
     const char *ptr = reinterpret_cast<const char*>(a);
     qptrdiff distance = reinterpret_cast<const char*>(b) - ptr;
@@ -548,6 +698,13 @@ static int ucstrncmp(const QChar *a, const uchar *c, int l)
 #ifdef __SSE2__
     __m128i nullmask = _mm_setzero_si128();
     qptrdiff offset = 0;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (l >= 32 && qCpuHasFeature(AVX2)) {
+        offset = ucstrncmp_latin1_avx2(uc, c, l);
+        if (offset < (l & ~31))
+            return uc[offset] - c[offset];
+    }
+#  endif
 
     // we're going to read uc[offset..offset+15] (32 bytes)
     // and c[offset..offset+15] (16 bytes)
@@ -556,16 +713,6 @@ static int ucstrncmp(const QChar *a, const uchar *c, int l)
         // load 16 bytes of Latin 1 data
         __m128i chunk = _mm_loadu_si128((const __m128i*)(c + offset));
 
-#  ifdef __AVX2__
-        // expand Latin 1 data via zero extension
-        __m256i ldata = _mm256_cvtepu8_epi16(chunk);
-
-        // load UTF-16 data and compare
-        __m256i ucdata = _mm256_loadu_si256((const __m256i*)(uc + offset));
-        __m256i result = _mm256_cmpeq_epi16(ldata, ucdata);
-
-        uint mask = ~_mm256_movemask_epi8(result);
-#  else
         // expand via unpacking
         __m128i firstHalf = _mm_unpacklo_epi8(chunk, nullmask);
         __m128i secondHalf = _mm_unpackhi_epi8(chunk, nullmask);
@@ -577,7 +724,6 @@ static int ucstrncmp(const QChar *a, const uchar *c, int l)
         __m128i result2 = _mm_cmpeq_epi16(secondHalf, ucdata2);
 
         uint mask = ~(_mm_movemask_epi8(result1) | _mm_movemask_epi8(result2) << 16);
-#  endif
         if (mask) {
             // found a different character
             uint idx = qCountTrailingZeroBits(mask);
@@ -681,6 +827,14 @@ static int findChar(const QChar *str, int len, QChar ch, int from,
         const ushort *n = s + from;
         const ushort *e = s + len;
         if (cs == Qt::CaseSensitive) {
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+            if (e - n >= 16 && qCpuHasFeature(AVX2)) {
+                const qptrdiff idx = findChar_avx2(n, e - n, c);
+                if (idx < ((e - n) & ~15))
+                    return n - s + idx;
+                n += idx;
+            }
+#endif
 #ifdef __SSE2__
             __m128i mch = _mm_set1_epi32(c | (c << 16));
 
@@ -0,0 +1,399 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qstringarena.h"
+
+#include "qflathash.h"
+#include "qvector.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW; // qstring.cpp
+
+class QStringArenaPrivate
+{
+public:
+    explicit QStringArenaPrivate(int blockSize)
+        : current(nullptr), end(nullptr), blockSize(qMax(blockSize, 256)), allocated(0)
+    {}
+    ~QStringArenaPrivate()
+    {
+        // the interned strings have their headers in the blocks
+        strings.clear();
+        byteArrays.clear();
+        freeBlocks();
+    }
+
+    static int length(const QChar *unicode)
+    {
+        int size = 0;
+        while (!unicode[size].isNull())
+            ++size;
+        return size;
+    }
+
+    void *allocate(size_t size);
+    QArrayData *allocateData(int size, size_t elementSize);
+    QArrayData *create(const void *data, int size, size_t elementSize);
+    void freeBlocks();
+
+    QVector<void *> blocks;
+    char *current;
+    char *end;
+    int blockSize;
+    qint64 allocated;
+
+    QFlatSet<QString> strings;
+    QFlatSet<QByteArray> byteArrays;
+
+#ifndef QT_NO_DEBUG
+    // In debug builds the headers are reference counted, with one reference
+    // held by the arena, so that freeBlocks() can tell whether any string
+    // still refers to them.
+    QVector<QArrayData *> headers;
+#endif
+};
+
+enum { ArenaAlignment = Q_ALIGNOF(QArrayData) };
+
+void *QStringArenaPrivate::allocate(size_t size)
+{
+    size = (size + ArenaAlignment - 1) & ~size_t(ArenaAlignment - 1);
+    if (size > size_t(end - current)) {
+        // Data that would waste much of a block gets one of its own, and
+        // the current block stays in use.
+        const bool ownBlock = size > size_t(blockSize) / 4;
+        const size_t blockBytes = ownBlock ? size : size_t(blockSize);
+        char *block = static_cast<char *>(::malloc(blockBytes));
+        Q_CHECK_PTR(block);
+        blocks.append(block);
+        allocated += blockBytes;
+        if (ownBlock)
+            return block;
+        current = block;
+        end = block + blockBytes;
+    }
+
+    void *result = current;
+    current += size;
+    return result;
+}
+
+// Creates a header followed by room for size elements and a null terminator.
+// The header is marked static, like the ones of QStringLiteral: it is never
+// freed through its reference count, copies share it and modifications detach.
+// In debug builds it is shared instead, and the arena keeps one reference, so
+// that it is not freed either.
+QArrayData *QStringArenaPrivate::allocateData(int size, size_t elementSize)
+{
+    const size_t payload = size_t(size) * elementSize;
+    QArrayData *header = static_cast<QArrayData *>(allocate(sizeof(QArrayData) + payload + elementSize));
+#ifdef QT_NO_DEBUG
+    header->ref.atomic.store(-1);
+#else
+    header->ref.atomic.store(2); // the arena's and the returned string's
+    headers.append(header);
+#endif
+    header->size = size;
+    header->alloc = 0;
+    header->capacityReserved = 0;
+    header->offset = sizeof(QArrayData);
+    memset(static_cast<char *>(header->data()) + payload, 0, elementSize);
+    return header;
+}
+
+QArrayData *QStringArenaPrivate::create(const void *data, int size, size_t elementSize)
+{
+    QArrayData *header = allocateData(size, elementSize);
+    memcpy(header->data(), data, size_t(size) * elementSize);
+    return header;
+}
+
+void QStringArenaPrivate::freeBlocks()
+{
+#ifndef QT_NO_DEBUG
+    for (const QArrayData *header : qAsConst(headers)) {
+        Q_ASSERT_X(header->ref.atomic.load() == 1, "QStringArena",
+                   "A string created by the arena outlives it or its clear()");
+    }
+    headers.clear();
+#endif
+    for (void *block : qAsConst(blocks))
+        ::free(block);
+    blocks.clear();
+    current = end = nullptr;
+    allocated = 0;
+}
+
+/*!
+    \class QStringArena
+    \inmodule QtCore
+    \since 5.9
+    \brief The QStringArena class creates many short-lived strings and byte
+    arrays without allocating memory for each of them.
+
+    \ingroup tools
+    \ingroup string-processing
+    \reentrant
+
+    Every non-empty QString and QByteArray normally lives in its own heap
+    block. Programs that create millions of short strings, such as the keys
+    of a parsed document, can spend much of their time in the memory
+    allocator and fragment the heap. QStringArena copies the characters into
+    large blocks it owns instead and returns ordinary QString and QByteArray
+    objects that refer to them:
+
+    \snippet code/src_corelib_tools_qstringarena.cpp 0
+
+    Strings created by the arena behave like the ones created by
+    QStringLiteral: copying them never allocates memory, and modifying a copy
+    first detaches it into memory of its own, leaving the arena untouched.
+
+    intern() additionally returns the same string for equal contents, so that
+    repeated keys are stored only once and compare quickly.
+
+    \warning The strings refer to the arena's memory without keeping it
+    alive. They, and any copies of them that were not modified, must be
+    destroyed before the arena is destroyed or cleared. Unlike with
+    QString::fromRawData(), this includes the headers of the strings, so
+    an arena should be declared before the containers that will hold its
+    strings. In debug builds, the arena asserts that no such string is
+    left when its memory is freed.
+
+    \sa QString::fromRawData(), QStringLiteral
+*/
+
+/*!
+    \enum QStringArena::anonymous
+    \internal
+
+    \value DefaultBlockSize
+*/
+
+/*!
+    Constructs an empty arena, which will allocate memory in blocks of
+    \a blockSize bytes. Strings too large to fit well in a block get a block
+    of their own.
+*/
+QStringArena::QStringArena(int blockSize)
+    : d(new QStringArenaPrivate(blockSize))
+{
+}
+
+/*!
+    Destroys the arena and frees all its memory. Strings created by it must
+    have been destroyed before.
+*/
+QStringArena::~QStringArena()
+{
+    delete d;
+}
+
+/*!
+    Returns a QString holding a copy of the first \a size characters of
+    \a unicode, stored in the arena. If \a size is negative, \a unicode is
+    assumed to point to a '\\0'-terminated string and its length is
+    determined dynamically.
+
+    If the string is empty, returns an empty string, or a null one if
+    \a unicode is \c nullptr; nothing is stored then.
+*/
+QString QStringArena::string(const QChar *unicode, int size)
+{
+    if (size < 0 && unicode)
+        size = QStringArenaPrivate::length(unicode);
+    if (size <= 0)
+        return QString(unicode, 0);
+    QStringDataPtr dataPtr = { static_cast<QStringData *>(d->create(unicode, size, sizeof(QChar))) };
+    return QString(dataPtr);
+}
+
+/*!
+    \fn QString QStringArena::string(const QString &str)
+    \overload
+
+    Returns a copy of \a str stored in the arena.
+*/
+
+/*!
+    \overload
+
+    Returns a copy of the Latin-1 string \a str, converted to Unicode and
+    stored in the arena.
+*/
+QString QStringArena::string(QLatin1String str)
+{
+    if (str.size() <= 0)
+        return QString(str);
+    QStringData *data = static_cast<QStringData *>(d->allocateData(str.size(), sizeof(QChar)));
+    qt_from_latin1(data->data(), str.latin1(), size_t(str.size()));
+    QStringDataPtr dataPtr = { data };
+    return QString(dataPtr);
+}
+
+/*!
+    Returns a QByteArray holding a copy of the first \a size bytes of
+    \a data, stored in the arena. If \a size is negative, \a data is
+    assumed to point to a '\\0'-terminated string and its length is
+    determined dynamically.
+
+    If the byte array is empty, returns an empty one, or a null one if
+    \a data is \c nullptr; nothing is stored then.
+*/
+QByteArray QStringArena::byteArray(const char *data, int size)
+{
+    if (size < 0)
+        size = int(qstrlen(data));
+    if (size <= 0)
+        return QByteArray(data, 0);
+    QByteArrayDataPtr dataPtr = { static_cast<QByteArrayData *>(d->create(data, size, 1)) };
+    return QByteArray(dataPtr);
+}
+
+/*!
+    \fn QByteArray QStringArena::byteArray(const QByteArray &ba)
+    \overload
+
+    Returns a copy of \a ba stored in the arena.
+*/
+
+/*!
+    Returns a string equal to the first \a size characters of \a unicode,
+    stored in the arena. If this function was called before with the same
+    characters, returns the same string as then, sharing its data; otherwise
+    stores a copy. Looking up a string that is already there allocates no
+    memory. If \a size is negative, \a unicode is assumed to be
+    '\\0'-terminated.
+
+    \sa internedCount()
+*/
+QString QStringArena::intern(const QChar *unicode, int size)
+{
+    if (size < 0 && unicode)
+        size = QStringArenaPrivate::length(unicode);
+    if (size <= 0)
+        return QString(unicode, 0);
+
+    // Look the characters up through a header on the stack, which refers to
+    // them wherever they are, so that finding them allocates nothing.
+    QArrayData header = Q_STATIC_STRING_DATA_HEADER_INITIALIZER_WITH_OFFSET(size, 0);
+    header.offset = reinterpret_cast<const char *>(unicode) - reinterpret_cast<const char *>(&header);
+    QStringDataPtr keyPtr = { static_cast<QStringData *>(&header) };
+    const QString key(keyPtr);
+
+    QFlatSet<QString>::const_iterator it = d->strings.constFind(key);
+    if (it == d->strings.constEnd())
+        it = d->strings.insert(string(unicode, size));
+    return *it;
+}
+
+/*!
+    \fn QString QStringArena::intern(const QString &str)
+    \overload
+
+    Returns a string equal to \a str, stored in the arena.
+*/
+
+/*!
+    \overload
+
+    Returns a byte array equal to the first \a size bytes of \a data, stored
+    in the arena. If this function was called before with the same bytes,
+    returns the same byte array as then; otherwise stores a copy. If \a size
+    is negative, \a data is assumed to be '\\0'-terminated.
+*/
+QByteArray QStringArena::intern(const char *data, int size)
+{
+    if (size < 0)
+        size = int(qstrlen(data));
+    if (size <= 0)
+        return QByteArray(data, 0);
+
+    QArrayData header = Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(size, 0);
+    header.offset = data - reinterpret_cast<const char *>(&header);
+    QByteArrayDataPtr keyPtr = { static_cast<QByteArrayData *>(&header) };
+    const QByteArray key(keyPtr);
+
+    QFlatSet<QByteArray>::const_iterator it = d->byteArrays.constFind(key);
+    if (it == d->byteArrays.constEnd())
+        it = d->byteArrays.insert(byteArray(data, size));
+    return *it;
+}
+
+/*!
+    \fn QByteArray QStringArena::intern(const QByteArray &ba)
+    \overload
+
+    Returns a byte array equal to \a ba, stored in the arena.
+*/
+
+/*!
+    Returns the number of distinct strings and byte arrays interned so far.
+
+    \sa intern()
+*/
+int QStringArena::internedCount() const
+{
+    return d->strings.size() + d->byteArrays.size();
+}
+
+/*!
+    Returns the number of bytes of memory the arena has allocated to store
+    strings, including space not used yet.
+*/
+qint64 QStringArena::bytesAllocated() const
+{
+    return d->allocated;
+}
+
+/*!
+    Frees all the memory of the arena, which can then be used again. Strings
+    created by it before must have been destroyed; debug builds assert this.
+*/
+void QStringArena::clear()
+{
+    d->strings.clear();
+    d->byteArrays.clear();
+    d->freeBlocks();
+}
+
+QT_END_NAMESPACE
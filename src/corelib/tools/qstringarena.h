@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGARENA_H
+#define QSTRINGARENA_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+class QStringArenaPrivate;
+
+class Q_CORE_EXPORT QStringArena
+{
+public:
+    enum { DefaultBlockSize = 4096 };
+
+    explicit QStringArena(int blockSize = DefaultBlockSize);
+    ~QStringArena();
+
+    QString string(const QChar *unicode, int size);
+    inline QString string(const QString &str) { return str.isEmpty() ? str : string(str.constData(), str.size()); }
+    QString string(QLatin1String str);
+    QByteArray byteArray(const char *data, int size);
+    inline QByteArray byteArray(const QByteArray &ba) { return ba.isEmpty() ? ba : byteArray(ba.constData(), ba.size()); }
+
+    QString intern(const QChar *unicode, int size);
+    inline QString intern(const QString &str) { return str.isEmpty() ? str : intern(str.constData(), str.size()); }
+    QByteArray intern(const char *data, int size);
+    inline QByteArray intern(const QByteArray &ba) { return ba.isEmpty() ? ba : intern(ba.constData(), ba.size()); }
+
+    int internedCount() const;
+    qint64 bytesAllocated() const;
+    void clear();
+
+private:
+    Q_DISABLE_COPY(QStringArena)
+    QStringArenaPrivate *d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGARENA_H
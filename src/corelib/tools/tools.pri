@@ -24,6 +24,7 @@ HEADERS +=  \
         tools/qdatetimeparser_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -59,6 +60,7 @@ HEADERS +=  \
         tools/qstack.h \
         tools/qstring.h \
         tools/qstringalgorithms_p.h \
+        tools/qstringarena.h \
         tools/qstringbuilder.h \
         tools/qstringiterator_p.h \
         tools/qstringlist.h \
@@ -105,6 +107,7 @@ SOURCES += \
         tools/qsimd.cpp \
         tools/qsize.cpp \
         tools/qstring.cpp \
+        tools/qstringarena.cpp \
         tools/qstringbuilder.cpp \
         tools/qstringlist.cpp \
         tools/qtextboundaryfinder.cpp \
@@ -70,6 +70,8 @@ public:
     virtual void _q_receiveReply() = 0;
     virtual void _q_readyRead() = 0;
     virtual bool sendRequest() = 0;
+    // Requests in flight on a multiplexing (SPDY, HTTP/2) connection:
+    virtual int activeStreamCount() const { return 0; }
     void setReply(QHttpNetworkReply *reply);
 
 protected:
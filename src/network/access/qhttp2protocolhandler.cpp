@@ -185,6 +185,8 @@ void QHttp2ProtocolHandler::_q_uploadDataReadyRead()
         sendRST_STREAM(streamID, INTERNAL_ERROR);
         markAsReset(streamID);
         deleteActiveStream(streamID);
+    } else if (!suspendedStreams.empty()) {
+        QMetaObject::invokeMethod(this, "resumeSuspendedStreams", Qt::QueuedConnection);
     }
 }
 
@@ -325,6 +327,10 @@ bool QHttp2ProtocolHandler::sendRequest()
         }
     }
 
+    // Streams that used up their turn continue once everybody had a chance:
+    if (!suspendedStreams.empty())
+        QMetaObject::invokeMethod(this, "resumeSuspendedStreams", Qt::QueuedConnection);
+
     m_channel->state = QHttpNetworkConnectionChannel::IdleState;
 
     return true;
@@ -421,7 +427,12 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
     const auto replyPrivate = reply->d_func();
     Q_ASSERT(replyPrivate);
 
-    auto slot = std::min<qint32>(sessionSendWindowSize, stream.sendWindow);
+    // Weighted round-robin: a stream sends at most one frame per turn for
+    // the lowest weight up to eight for the highest, then lets the others
+    // (see resumeSuspendedStreams) have theirs, so that a large upload
+    // cannot monopolize the connection.
+    qint32 quantum = qint32(maxFrameSize) * (1 + stream.weight() / 32);
+    auto slot = std::min({sessionSendWindowSize, stream.sendWindow, quantum});
     while (!stream.data()->atEnd() && slot) {
         qint64 chunkSize = 0;
         const uchar *src =
@@ -445,10 +456,11 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.data()->advanceReadPointer(bytesWritten);
         stream.sendWindow -= bytesWritten;
         sessionSendWindowSize -= bytesWritten;
+        quantum -= bytesWritten;
         replyPrivate->totallyUploadedData += bytesWritten;
         emit reply->dataSendProgress(replyPrivate->totallyUploadedData,
                                      request.contentLength());
-        slot = std::min(sessionSendWindowSize, stream.sendWindow);
+        slot = std::min({sessionSendWindowSize, stream.sendWindow, quantum});
     }
 
     if (replyPrivate->totallyUploadedData == request.contentLength()) {
@@ -1173,11 +1185,14 @@ quint32 QHttp2ProtocolHandler::createNewStream(const HttpMessagePair &message)
 
 void QHttp2ProtocolHandler::addToSuspended(Stream &stream)
 {
+    if (std::find(suspendedStreams.begin(), suspendedStreams.end(),
+                  stream.streamID) != suspendedStreams.end()) {
+        return;
+    }
+
     qCDebug(QT_HTTP2) << "stream" << stream.streamID
-                      << "suspended by flow control";
-    const auto priority = stream.priority();
-    Q_ASSERT(int(priority) >= 0 && int(priority) < 3);
-    suspendedStreams[priority].push_back(stream.streamID);
+                      << "suspended by flow control or scheduling";
+    suspendedStreams.push_back(stream.streamID);
 }
 
 void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
@@ -1204,40 +1219,25 @@ void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
 
 quint32 QHttp2ProtocolHandler::popStreamToResume()
 {
-    quint32 streamID = connectionStreamID;
-    const int nQ = sizeof suspendedStreams / sizeof suspendedStreams[0];
-    using QNR = QHttpNetworkRequest;
-    const QNR::Priority ranks[nQ] = {QNR::HighPriority,
-                                     QNR::NormalPriority,
-                                     QNR::LowPriority};
-
-    for (int i = 0; i < nQ; ++i) {
-        auto &queue = suspendedStreams[ranks[i]];
-        auto it = queue.begin();
-        for (; it != queue.end(); ++it) {
-            if (!activeStreams.contains(*it))
-                continue;
-            if (activeStreams[*it].sendWindow > 0)
-                break;
-        }
-
-        if (it != queue.end()) {
-            streamID = *it;
-            queue.erase(it);
-            break;
+    // The first stream in line that is not blocked by its own window:
+    for (auto it = suspendedStreams.begin(); it != suspendedStreams.end(); ++it) {
+        if (!activeStreams.contains(*it))
+            continue;
+        if (activeStreams[*it].sendWindow > 0) {
+            const quint32 streamID = *it;
+            suspendedStreams.erase(it);
+            return streamID;
         }
     }
 
-    return streamID;
+    return connectionStreamID;
 }
 
 void QHttp2ProtocolHandler::removeFromSuspended(quint32 streamID)
 {
-    const int nQ = sizeof suspendedStreams / sizeof suspendedStreams[0];
-    for (int i = 0; i < nQ; ++i) {
-        auto &q = suspendedStreams[i];
-        q.erase(std::remove(q.begin(), q.end(), streamID), q.end());
-    }
+    suspendedStreams.erase(std::remove(suspendedStreams.begin(), suspendedStreams.end(),
+                                       streamID),
+                           suspendedStreams.end());
 }
 
 void QHttp2ProtocolHandler::deleteActiveStream(quint32 streamID)
@@ -1428,8 +1428,7 @@ void QHttp2ProtocolHandler::connectionError(Http2::Http2Error errorCode,
 void QHttp2ProtocolHandler::closeSession()
 {
     activeStreams.clear();
-    for (auto &q: suspendedStreams)
-        q.clear();
+    suspendedStreams.clear();
     recycledStreams.clear();
 
     m_channel->close();
@@ -100,6 +100,7 @@ private:
     void _q_readyRead() override;
     void _q_receiveReply() override;
     Q_INVOKABLE bool sendRequest() override;
+    int activeStreamCount() const override { return activeStreams.size(); }
 
     bool sendClientPreface();
     bool sendSETTINGS_ACK();
@@ -157,7 +158,9 @@ private:
     HPack::Encoder encoder;
 
     QHash<quint32, Stream> activeStreams;
-    std::deque<quint32> suspendedStreams[3]; // 3 for priorities: High, Normal, Low.
+    // Streams with DATA to send, served round-robin; how much a stream
+    // may send per turn depends on its weight (see sendDATA).
+    std::deque<quint32> suspendedStreams;
     static const std::deque<quint32>::size_type maxRecycledStreams;
     std::deque<quint32> recycledStreams;
 
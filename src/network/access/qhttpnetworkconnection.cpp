@@ -75,6 +75,24 @@ const int QHttpNetworkConnectionPrivate::defaultPipelineLength = 3;
 // This means that there are 2 requests in flight and 2 slots free that will be re-filled.
 const int QHttpNetworkConnectionPrivate::defaultRePipelineLength = 2;
 
+// HTTP/2 multiplexes all requests to a host over a single connection by default.
+// QT_HTTP2_CONNECTIONS_PER_HOST allows a small pool instead, so that bulk transfers
+// do not head-of-line block other requests at the TCP level; requests can also ask
+// for one with QNetworkRequest::HTTP2ConnectionsPerHostAttribute.
+int QHttpNetworkConnectionPrivate::defaultChannelCount(QHttpNetworkConnection::ConnectionType type)
+{
+    switch (type) {
+    case QHttpNetworkConnection::ConnectionTypeSPDY:
+        return 1;
+    case QHttpNetworkConnection::ConnectionTypeHTTP2: {
+        bool ok = false;
+        const int count = qEnvironmentVariableIntValue("QT_HTTP2_CONNECTIONS_PER_HOST", &ok);
+        return ok ? qBound(1, count, defaultHttpChannelCount) : 1;
+    }
+    default:
+        return defaultHttpChannelCount;
+    }
+}
 
 QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName,
                                                              quint16 port, bool encrypt,
@@ -82,12 +100,7 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
 : state(RunningState),
   networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true)
-#ifndef QT_NO_SSL
-, channelCount((type == QHttpNetworkConnection::ConnectionTypeSPDY || type == QHttpNetworkConnection::ConnectionTypeHTTP2)
-              ? 1 : defaultHttpChannelCount)
-#else
-, channelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2 ? 1 : defaultHttpChannelCount)
-#endif // QT_NO_SSL
+, channelCount(defaultChannelCount(type))
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -622,7 +635,9 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
     else { // SPDY, HTTP/2
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].spdyRequestsToSend.insertMulti(request.priority(), pair);
+        QHttpNetworkConnectionChannel &channel = channels[leastLoadedChannel()];
+        reply->d_func()->connectionChannel = &channel;
+        channel.spdyRequestsToSend.insertMulti(request.priority(), pair);
     }
 
     // For Happy Eyeballs the networkLayerState is set to Unknown
@@ -1020,18 +1035,21 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
     }
     case QHttpNetworkConnection::ConnectionTypeHTTP2:
     case QHttpNetworkConnection::ConnectionTypeSPDY: {
+        // Requests were assigned to a channel in queueRequest(); connect
+        // the channels that have some and let them multiplex their own.
+        for (int i = 0; i < channelCount; ++i) {
+            if (channels[i].spdyRequestsToSend.isEmpty())
+                continue;
 
-        if (channels[0].spdyRequestsToSend.isEmpty())
-            return;
-
-        if (networkLayerState == IPv4)
-            channels[0].networkLayerPreference = QAbstractSocket::IPv4Protocol;
-        else if (networkLayerState == IPv6)
-            channels[0].networkLayerPreference = QAbstractSocket::IPv6Protocol;
-        channels[0].ensureConnection();
-        if (channels[0].socket && channels[0].socket->state() == QAbstractSocket::ConnectedState
-                && !channels[0].pendingEncrypt)
-            channels[0].sendRequest();
+            if (networkLayerState == IPv4)
+                channels[i].networkLayerPreference = QAbstractSocket::IPv4Protocol;
+            else if (networkLayerState == IPv6)
+                channels[i].networkLayerPreference = QAbstractSocket::IPv6Protocol;
+            channels[i].ensureConnection();
+            if (channels[i].socket && channels[i].socket->state() == QAbstractSocket::ConnectedState
+                    && !channels[i].pendingEncrypt)
+                channels[i].sendRequest();
+        }
         break;
     }
     }
@@ -1090,6 +1108,29 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
 }
 
 
+// Returns the channel a new SPDY or HTTP/2 request should be multiplexed on:
+// the one with the fewest queued and in-flight requests, preferring the
+// lowest index so that extra connections are only opened under load.
+int QHttpNetworkConnectionPrivate::leastLoadedChannel() const
+{
+    const auto load = [this](int i) {
+        const QHttpNetworkConnectionChannel &channel = channels[i];
+        return channel.spdyRequestsToSend.size()
+               + (channel.protocolHandler ? channel.protocolHandler->activeStreamCount() : 0);
+    };
+
+    int best = 0;
+    int bestLoad = load(0);
+    for (int i = 1; i < channelCount && bestLoad; ++i) {
+        const int channelLoad = load(i);
+        if (channelLoad < bestLoad) {
+            best = i;
+            bestLoad = channelLoad;
+        }
+    }
+    return best;
+}
+
 void QHttpNetworkConnectionPrivate::readMoreLater(QHttpNetworkReply *reply)
 {
     for (int i = 0 ; i < channelCount; ++i) {
@@ -1186,16 +1227,20 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(const QHostInfo &info)
             emitReplyError(channels[0].socket, channels[0].reply, QNetworkReply::HostNotFoundError);
             networkLayerState = QHttpNetworkConnectionPrivate::Unknown;
         }
+        else if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
 #ifndef QT_NO_SSL
-        else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY) {
-            for (const HttpMessagePair &spdyPair : qAsConst(channels[0].spdyRequestsToSend)) {
-                // emit error for all replies
-                QHttpNetworkReply *currentReply = spdyPair.second;
-                Q_ASSERT(currentReply);
-                emitReplyError(channels[0].socket, currentReply, QNetworkReply::HostNotFoundError);
+                 || connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+#endif // QT_NO_SSL
+                 ) {
+            for (int i = 0; i < channelCount; ++i) {
+                for (const HttpMessagePair &spdyPair : qAsConst(channels[i].spdyRequestsToSend)) {
+                    // emit error for all replies
+                    QHttpNetworkReply *currentReply = spdyPair.second;
+                    Q_ASSERT(currentReply);
+                    emitReplyError(channels[i].socket, currentReply, QNetworkReply::HostNotFoundError);
+                }
             }
         }
-#endif // QT_NO_SSL
         else {
             // Should not happen
             qWarning("QHttpNetworkConnectionPrivate::_q_hostLookupFinished could not de-queue request");
@@ -1211,7 +1256,9 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(const QHostInfo &info)
 // connection will then be disconnected.
 void QHttpNetworkConnectionPrivate::startNetworkLayerStateLookup()
 {
-    if (channelCount > 1) {
+    // SPDY and HTTP/2 channels each carry their own requests, so they
+    // cannot race each other for the first one; use a single channel.
+    if (channelCount > 1 && connectionType == QHttpNetworkConnection::ConnectionTypeHTTP) {
         // At this time all channels should be unconnected.
         Q_ASSERT(!channels[0].isSocketBusy());
         Q_ASSERT(!channels[1].isSocketBusy());
@@ -177,6 +177,8 @@ public:
     static const int defaultPipelineLength;
     static const int defaultRePipelineLength;
 
+    static int defaultChannelCount(QHttpNetworkConnection::ConnectionType type);
+
     enum ConnectionState {
         RunningState = 0,
         PausedState = 1
@@ -213,6 +215,8 @@ public:
     void updateChannel(int i, const HttpMessagePair &messagePair);
     QHttpNetworkRequest predictNextRequest() const;
 
+    int leastLoadedChannel() const;
+
     void fillPipeline(QAbstractSocket *socket);
     bool fillPipeline(QList<HttpMessagePair> &queue, QHttpNetworkConnectionChannel &channel);
 
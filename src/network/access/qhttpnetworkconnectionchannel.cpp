@@ -797,6 +797,9 @@ void QHttpNetworkConnectionChannel::_q_connected()
                 connection->d_func()->networkLayerState = QHttpNetworkConnectionPrivate::IPv4;
             else
                 connection->d_func()->networkLayerState = QHttpNetworkConnectionPrivate::IPv6;
+            // Remember what we got, so that this channel is not mistaken for
+            // the loser of a Happy Eyeballs race once more channels are used.
+            networkLayerPreference = socket->peerAddress().protocol();
         }
         connection->d_func()->networkLayerDetected(networkLayerPreference);
     } else {
@@ -819,6 +822,11 @@ void QHttpNetworkConnectionChannel::_q_connected()
     // However, this code is currently not in Qt, so we rely on the kernel combining
     // the requests into one TCP packet.
 
+    // HTTP/2 does combine its frames into few writes, and it must not have
+    // WINDOW_UPDATEs or a small request held back behind unacknowledged data:
+    if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeHTTP2)
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
     // not sure yet if it helps, but it makes sense
     socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
 
@@ -48,7 +48,7 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Oper
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
       autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false), http2Allowed(false),
-      withCredentials(true), preConnect(false), followRedirect(false), redirectCount(0)
+      http2ConnectionsPerHost(0), withCredentials(true), preConnect(false), followRedirect(false), redirectCount(0)
 {
 }
 
@@ -62,6 +62,7 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
       pipeliningAllowed(other.pipeliningAllowed),
       spdyAllowed(other.spdyAllowed),
       http2Allowed(other.http2Allowed),
+      http2ConnectionsPerHost(other.http2ConnectionsPerHost),
       withCredentials(other.withCredentials),
       ssl(other.ssl),
       preConnect(other.preConnect),
@@ -84,6 +85,7 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
         && (pipeliningAllowed == other.pipeliningAllowed)
         && (spdyAllowed == other.spdyAllowed)
         && (http2Allowed == other.http2Allowed)
+        && (http2ConnectionsPerHost == other.http2ConnectionsPerHost)
         // we do not clear the customVerb in setOperation
         && (operation != QHttpNetworkRequest::Custom || (customVerb == other.customVerb))
         && (withCredentials == other.withCredentials)
@@ -343,6 +345,16 @@ void QHttpNetworkRequest::setHTTP2Allowed(bool b)
     d->http2Allowed = b;
 }
 
+int QHttpNetworkRequest::http2ConnectionsPerHost() const
+{
+    return d->http2ConnectionsPerHost;
+}
+
+void QHttpNetworkRequest::setHTTP2ConnectionsPerHost(int count)
+{
+    d->http2ConnectionsPerHost = count;
+}
+
 bool QHttpNetworkRequest::withCredentials() const
 {
     return d->withCredentials;
@@ -120,6 +120,9 @@ public:
     bool isHTTP2Allowed() const;
     void setHTTP2Allowed(bool b);
 
+    int http2ConnectionsPerHost() const;
+    void setHTTP2ConnectionsPerHost(int count);
+
     bool withCredentials() const;
     void setWithCredentials(bool b);
 
@@ -170,6 +173,7 @@ public:
     bool pipeliningAllowed;
     bool spdyAllowed;
     bool http2Allowed;
+    int http2ConnectionsPerHost;
     bool withCredentials;
     bool ssl;
     bool preConnect;
@@ -178,15 +178,15 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
-                                       QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt, QHttpNetworkConnection::ConnectionType connectionType)
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0, connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
-                                       QHttpNetworkConnection::ConnectionType connectionType,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt, QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/0,
-                                 qMove(networkSession))
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0,
+                                 qMove(networkSession), connectionType)
 #endif
     {
         setExpires(true);
@@ -314,6 +314,17 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, 0);
 
+    int connectionCount = QHttpNetworkConnectionPrivate::defaultChannelCount(connectionType);
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
+        && httpRequest.http2ConnectionsPerHost() > 0) {
+        const int count = qMin(httpRequest.http2ConnectionsPerHost(),
+                               QHttpNetworkConnectionPrivate::defaultHttpChannelCount);
+        if (count != connectionCount) {
+            // do not share the connections with requests asking for a pool of another size
+            connectionCount = count;
+            cacheKey += "#http2-connections=" + QByteArray::number(count);
+        }
+    }
 
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
@@ -321,11 +332,11 @@ void QHttpThreadDelegate::startRequest()
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType);
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl, connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl, connectionType,
                                                                 networkSession);
 #endif
 #ifndef QT_NO_SSL
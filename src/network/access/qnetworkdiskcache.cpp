@@ -49,14 +49,18 @@
 #include <qdatastream.h>
 #include <qdatetime.h>
 #include <qdiriterator.h>
+#include <qvector.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
 #include <qdebug.h>
 
+#include <algorithm>
+
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -64,6 +68,13 @@
 
 QT_BEGIN_NAMESPACE
 
+enum
+{
+    IndexMagic = 0x51dc1d8,
+    IndexVersion = 1,
+    InitialIndexCapacity = 1024
+};
+
 /*!
     \class QNetworkDiskCache
     \since 4.5
@@ -82,6 +93,10 @@ QT_BEGIN_NAMESPACE
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
 
+    For caches holding many entries, setIndexEnabled() makes QNetworkDiskCache
+    keep a memory-mapped index of the cache files, so that lookups of uncached
+    urls and expire() do not need to access the file system.
+
     Note you have to set the cache directory before it will work.
 
     A network disk cache can be enabled by:
@@ -115,6 +130,7 @@ QNetworkDiskCache::~QNetworkDiskCache()
 {
     Q_D(QNetworkDiskCache);
     qDeleteAll(d->inserting);
+    d->closeIndex();
 }
 
 /*!
@@ -144,6 +160,8 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
     Q_D(QNetworkDiskCache);
     if (cacheDir.isEmpty())
         return;
+    d->closeIndex();
+    d->currentCacheSize = -1;
     d->cacheDirectory = cacheDir;
     QDir dir(d->cacheDirectory);
     d->cacheDirectory = dir.absolutePath();
@@ -152,6 +170,8 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    if (d->indexEnabled)
+        d->openIndex();
 }
 
 /*!
@@ -273,7 +293,7 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
     Q_ASSERT(!fileName.isEmpty());
 
     if (QFile::exists(fileName)) {
-        if (!QFile::remove(fileName)) {
+        if (!removeFile(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
@@ -296,10 +316,19 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
+        if (cacheItem->file->rename(fileName)) {
             currentCacheSize += cacheItem->file->size();
-        else
+            if (indexMemory) {
+                const QDateTime expiration = cacheItem->metaData.expirationDate();
+                addToIndex(indexKey(fileName), cacheItem->file->size(),
+                           expiration.isValid() ? expiration.toMSecsSinceEpoch() : 0,
+                           QDateTime::currentMSecsSinceEpoch());
+                if (indexMemory)
+                    currentCacheSize = indexHeader()->totalSize;
+            }
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
@@ -347,6 +376,10 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     qint64 size = info.size();
     if (QFile::remove(file)) {
         currentCacheSize -= size;
+        if (indexMemory && file.startsWith(dataDirectory)) {
+            removeFromIndex(indexKey(fileName));
+            currentCacheSize = indexHeader()->totalSize;
+        }
         return true;
     }
     return false;
@@ -363,7 +396,10 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    const QString fileName = d->cacheFileName(url);
+    if (d->indexMemory && !d->indexSlots.contains(d->indexKey(fileName)))
+        return QNetworkCacheMetaData();
+    return fileMetaData(fileName);
 }
 
 /*!
@@ -404,9 +440,17 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        const QString fileName = d->cacheFileName(url);
+        if (d->indexMemory && !d->indexSlots.contains(d->indexKey(fileName)))
+            return 0;
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            if (d->indexMemory)
+                d->removeFromIndex(d->indexKey(fileName));
             return 0;
+        }
+        if (d->indexMemory)
+            d->touchIndex(d->indexKey(fileName));
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
@@ -497,6 +541,57 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
         d->currentCacheSize = expire();
 }
 
+/*!
+    \since 5.9
+
+    Returns \c true if the cache keeps an index of its files.
+
+    \sa setIndexEnabled()
+ */
+bool QNetworkDiskCache::isIndexEnabled() const
+{
+    Q_D(const QNetworkDiskCache);
+    return d->indexEnabled;
+}
+
+/*!
+    \since 5.9
+
+    Sets whether the cache keeps an index of its files to \a enable.
+    The default is \c false.
+
+    The index is a memory-mapped file in the cache directory recording
+    the size, last access time and expiration date of every cache file.
+    With it, looking up an url that is not cached does not touch the
+    file system, the cache size is known without scanning the cache
+    directory, and expire() removes the least recently used files,
+    starting with those already expired, without listing the directory.
+
+    The index is rebuilt from the cache directory if it is missing or
+    was not closed properly. Enabling it is recommended for caches with
+    many entries; note that a reimplementation of expire() which removes
+    files by itself should call remove() so that the index stays accurate.
+
+    \sa isIndexEnabled(), expire()
+ */
+void QNetworkDiskCache::setIndexEnabled(bool enable)
+{
+    Q_D(QNetworkDiskCache);
+    if (d->indexEnabled == enable)
+        return;
+    d->indexEnabled = enable;
+    if (d->cacheDirectory.isEmpty())
+        return;
+    if (enable) {
+        d->openIndex();
+    } else {
+        // the index would go stale while the cache is used without it
+        d->closeIndex();
+        QFile::remove(d->dataDirectory + INDEX_FILE);
+        d->currentCacheSize = -1;
+    }
+}
+
 /*!
     Cleans the cache so that its size is under the maximum cache size.
     Returns the current size of the cache.
@@ -529,6 +624,9 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
+    if (d->indexMemory)
+        return d->expireIndexed();
+
     QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
     QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
 
@@ -633,6 +731,239 @@ QString QNetworkDiskCachePrivate::cacheFileName(const QUrl &url) const
     return  fullpath;
 }
 
+/*!
+    Returns the key of the cache file \a fileName in the index: its
+    up to 8 character name packed into an integer.
+ */
+quint64 QNetworkDiskCachePrivate::indexKey(const QString &fileName)
+{
+    const int start = fileName.lastIndexOf(QLatin1Char('/')) + 1;
+    const int length = qMin(fileName.size() - start - int(CACHE_POSTFIX.size()), 8);
+    quint64 key = 0;
+    for (int i = 0; i < length; ++i)
+        key |= quint64(fileName.at(start + i).toLatin1()) << (8 * i);
+    return key;
+}
+
+/*!
+    Returns the fully qualified path of the cache file with index \a key.
+ */
+QString QNetworkDiskCachePrivate::indexedFileName(quint64 key) const
+{
+    QByteArray id;
+    for (; key; key >>= 8)
+        id += char(key & 0xff);
+    if (id.isEmpty())
+        return QString();
+    uint code = (uint)id.at(id.length()-1) % 16;
+    return dataDirectory + QString::number(code, 16) + QLatin1Char('/')
+            + QLatin1String(id) + CACHE_POSTFIX;
+}
+
+/*!
+    Maps the index of the cache directory into memory, rebuilding it if
+    it does not exist or was not closed properly. Returns \c false if
+    the index cannot be used.
+ */
+bool QNetworkDiskCachePrivate::openIndex()
+{
+    closeIndex();
+
+    indexFile = new QFile(dataDirectory + INDEX_FILE);
+    if (!indexFile->open(QIODevice::ReadWrite)) {
+        qWarning() << "QNetworkDiskCache: couldn't open the index" << indexFile->fileName();
+        closeIndex();
+        return false;
+    }
+
+    const qint64 fileSize = indexFile->size();
+    if (fileSize >= qint64(sizeof(QNetworkDiskCacheIndexHeader)))
+        indexMemory = indexFile->map(0, fileSize);
+    const QNetworkDiskCacheIndexHeader *existing = indexHeader();
+    const bool valid = existing
+            && existing->magic == quint32(IndexMagic)
+            && existing->version == quint32(IndexVersion)
+            && !existing->dirty
+            && existing->count <= existing->capacity
+            && fileSize == qint64(sizeof(QNetworkDiskCacheIndexHeader)
+                                  + existing->capacity * sizeof(QNetworkDiskCacheIndexEntry));
+
+    if (valid) {
+        const QNetworkDiskCacheIndexEntry *entries = indexEntries();
+        indexSlots.reserve(existing->count);
+        for (quint32 i = 0; i < existing->count; ++i)
+            indexSlots.insert(entries[i].key, i);
+    } else {
+        if (!resizeIndex(InitialIndexCapacity)) {
+            closeIndex();
+            return false;
+        }
+        QNetworkDiskCacheIndexHeader *header = indexHeader();
+        header->magic = IndexMagic;
+        header->version = IndexVersion;
+        header->count = 0;
+        header->reserved = 0;
+        header->totalSize = 0;
+        rebuildIndex();
+        if (!indexMemory)
+            return false;
+    }
+
+    // cleared again by closeIndex(), so that a crash forces a rebuild
+    indexHeader()->dirty = 1;
+    currentCacheSize = indexHeader()->totalSize;
+    return true;
+}
+
+/*!
+    Unmaps the index, marking it as consistent with the cache directory.
+ */
+void QNetworkDiskCachePrivate::closeIndex()
+{
+    if (indexMemory) {
+        indexHeader()->dirty = 0;
+        indexFile->unmap(indexMemory);
+        indexMemory = 0;
+    }
+    delete indexFile;
+    indexFile = 0;
+    indexSlots.clear();
+}
+
+/*!
+    Resizes the index file to hold \a capacity entries and maps it again.
+ */
+bool QNetworkDiskCachePrivate::resizeIndex(quint32 capacity)
+{
+    if (indexMemory) {
+        indexFile->unmap(indexMemory);
+        indexMemory = 0;
+    }
+    const qint64 size = sizeof(QNetworkDiskCacheIndexHeader)
+            + qint64(capacity) * sizeof(QNetworkDiskCacheIndexEntry);
+    if (!indexFile->resize(size) || !(indexMemory = indexFile->map(0, size))) {
+        qWarning() << "QNetworkDiskCache: couldn't map the index" << indexFile->fileName();
+        return false;
+    }
+    indexHeader()->capacity = capacity;
+    return true;
+}
+
+/*!
+    Adds every file in the cache directory to the empty index.
+ */
+void QNetworkDiskCachePrivate::rebuildIndex()
+{
+    QDirIterator it(dataDirectory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext() && indexMemory) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (!info.fileName().endsWith(CACHE_POSTFIX))
+            continue;
+        addToIndex(indexKey(info.fileName()), info.size(), 0,
+                   info.lastModified().toMSecsSinceEpoch());
+    }
+}
+
+/*!
+    Records the cache file with index \a key, of \a size bytes, expiring
+    at \a expiration and last accessed at \a lastAccess. Stops using the
+    index if it cannot grow.
+ */
+void QNetworkDiskCachePrivate::addToIndex(quint64 key, qint64 size, qint64 expiration,
+                                          qint64 lastAccess)
+{
+    int slot = indexSlots.value(key, -1);
+    if (slot < 0) {
+        QNetworkDiskCacheIndexHeader *header = indexHeader();
+        if (header->count == header->capacity) {
+            if (!resizeIndex(header->capacity * 2)) {
+                // left marked dirty, so it gets rebuilt when opened again
+                closeIndex();
+                currentCacheSize = -1;
+                return;
+            }
+            header = indexHeader();
+        }
+        slot = header->count++;
+        indexSlots.insert(key, slot);
+        indexEntries()[slot].key = key;
+        indexEntries()[slot].size = 0;
+    }
+
+    QNetworkDiskCacheIndexEntry &entry = indexEntries()[slot];
+    indexHeader()->totalSize += size - entry.size;
+    entry.size = size;
+    entry.lastAccess = lastAccess;
+    entry.expiration = expiration;
+}
+
+void QNetworkDiskCachePrivate::removeFromIndex(quint64 key)
+{
+    const int slot = indexSlots.value(key, -1);
+    if (slot < 0)
+        return;
+    indexSlots.remove(key);
+
+    QNetworkDiskCacheIndexHeader *header = indexHeader();
+    QNetworkDiskCacheIndexEntry *entries = indexEntries();
+    header->totalSize -= entries[slot].size;
+    const int last = --header->count;
+    if (slot != last) {
+        entries[slot] = entries[last];
+        indexSlots.insert(entries[slot].key, slot);
+    }
+}
+
+void QNetworkDiskCachePrivate::touchIndex(quint64 key)
+{
+    const int slot = indexSlots.value(key, -1);
+    if (slot >= 0)
+        indexEntries()[slot].lastAccess = QDateTime::currentMSecsSinceEpoch();
+}
+
+/*!
+    The indexed counterpart of QNetworkDiskCache::expire(): removes
+    expired files first, then the least recently used ones.
+ */
+qint64 QNetworkDiskCachePrivate::expireIndexed()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const QNetworkDiskCacheIndexHeader *header = indexHeader();
+    const QNetworkDiskCacheIndexEntry *entries = indexEntries();
+
+    QVector<QPair<qint64, quint64> > candidates;
+    candidates.reserve(header->count);
+    for (quint32 i = 0; i < header->count; ++i) {
+        const QNetworkDiskCacheIndexEntry &entry = entries[i];
+        const bool expired = entry.expiration && entry.expiration < now;
+        candidates.append(qMakePair(expired ? Q_INT64_C(0) : entry.lastAccess, entry.key));
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    int removedFiles = 0;
+    const qint64 goal = (maximumCacheSize * 9) / 10;
+    for (const auto &candidate : qAsConst(candidates)) {
+        if (indexHeader()->totalSize < goal)
+            break;
+        const QString fileName = indexedFileName(candidate.second);
+        if (QFile::remove(fileName) || !QFile::exists(fileName)) {
+            removeFromIndex(candidate.second);
+            ++removedFiles;
+        }
+    }
+#if defined(QNETWORKDISKCACHE_DEBUG)
+    if (removedFiles > 0) {
+        qDebug() << "QNetworkDiskCache::expire()"
+                << "Removed:" << removedFiles
+                << "Kept:" << candidates.count() - removedFiles;
+    }
+#else
+    Q_UNUSED(removedFiles);
+#endif
+    return indexHeader()->totalSize;
+}
+
 /*!
     We compress small text and JavaScript files.
  */
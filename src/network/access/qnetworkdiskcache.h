@@ -63,6 +63,9 @@ public:
     qint64 maximumCacheSize() const;
     void setMaximumCacheSize(qint64 size);
 
+    bool isIndexEnabled() const;
+    void setIndexEnabled(bool enable);
+
     qint64 cacheSize() const Q_DECL_OVERRIDE;
     QNetworkCacheMetaData metaData(const QUrl &url) Q_DECL_OVERRIDE;
     void updateMetaData(const QNetworkCacheMetaData &metaData) Q_DECL_OVERRIDE;
@@ -94,6 +94,27 @@ public:
     bool canCompress() const;
 };
 
+// Layout of the memory-mapped index file: a header followed by
+// 'capacity' entries, the first 'count' of which are in use.
+struct QNetworkDiskCacheIndexHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+    quint32 capacity;
+    quint32 dirty;
+    quint32 reserved;
+    qint64 totalSize;
+};
+
+struct QNetworkDiskCacheIndexEntry
+{
+    quint64 key;
+    qint64 size;
+    qint64 lastAccess;  // msecs since epoch
+    qint64 expiration;  // msecs since epoch, 0 if unknown
+};
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -101,6 +122,9 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , indexEnabled(false)
+        , indexFile(0)
+        , indexMemory(0)
         {}
 
     static QString uniqueFileName(const QUrl &url);
@@ -111,12 +135,32 @@ public:
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    static quint64 indexKey(const QString &fileName);
+    QString indexedFileName(quint64 key) const;
+    bool openIndex();
+    void closeIndex();
+    bool resizeIndex(quint32 capacity);
+    void rebuildIndex();
+    void addToIndex(quint64 key, qint64 size, qint64 expiration, qint64 lastAccess);
+    void removeFromIndex(quint64 key);
+    void touchIndex(quint64 key);
+    qint64 expireIndexed();
+    QNetworkDiskCacheIndexHeader *indexHeader() const
+        { return reinterpret_cast<QNetworkDiskCacheIndexHeader *>(indexMemory); }
+    QNetworkDiskCacheIndexEntry *indexEntries() const
+        { return reinterpret_cast<QNetworkDiskCacheIndexEntry *>(indexMemory + sizeof(QNetworkDiskCacheIndexHeader)); }
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
 
+    bool indexEnabled;
+    QFile *indexFile;
+    uchar *indexMemory;
+    QHash<quint64, int> indexSlots;
+
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
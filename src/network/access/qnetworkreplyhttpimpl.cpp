@@ -739,6 +739,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     if (request.attribute(QNetworkRequest::HTTP2AllowedAttribute).toBool())
         httpRequest.setHTTP2Allowed(true);
 
+    const QVariant http2ConnectionsPerHost = request.attribute(QNetworkRequest::HTTP2ConnectionsPerHostAttribute);
+    if (http2ConnectionsPerHost.isValid())
+        httpRequest.setHTTP2ConnectionsPerHost(http2ConnectionsPerHost.toInt());
+
     if (static_cast<QNetworkRequest::LoadControl>
         (newHttpRequest.attribute(QNetworkRequest::AuthenticationReuseAttribute,
                              QNetworkRequest::Automatic).toInt()) == QNetworkRequest::Manual)
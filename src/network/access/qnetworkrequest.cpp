@@ -289,6 +289,17 @@ QT_BEGIN_NAMESPACE
         marked to be decompressed automatically.
         (This value was introduced in 5.9.)
 
+    \value HTTP2ConnectionsPerHostAttribute
+        Requests only, type: QMetaType::Int (default: 1)
+        Holds the number of connections, between 1 and 6, that HTTP/2 requests
+        to the same host are spread over. A single connection multiplexes all
+        the requests, but a large transfer can then delay the others; more
+        connections are only opened when requests are pending on the
+        existing ones. Requests asking for different numbers of connections
+        do not share them. The default can be changed with the
+        QT_HTTP2_CONNECTIONS_PER_HOST environment variable.
+        (This value was introduced in 5.9.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
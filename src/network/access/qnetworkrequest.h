@@ -92,6 +92,7 @@ public:
         HTTP2AllowedAttribute,
         HTTP2WasUsedAttribute,
         OriginalContentLengthAttribute,
+        HTTP2ConnectionsPerHostAttribute,
 
         User = 1000,
         UserMax = 32767
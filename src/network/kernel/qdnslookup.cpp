@@ -39,6 +39,7 @@
 
 #include "qdnslookup.h"
 #include "qdnslookup_p.h"
+#include "qhostinfo_p.h"
 
 #include <qcoreapplication.h>
 #include <qdatetime.h>
@@ -991,6 +992,16 @@ void QDnsLookupPrivate::_q_lookupFinished(const QDnsLookupReply &_reply)
         reply = _reply;
         runnable = 0;
         isFinished = true;
+
+        // let QHostInfo's cache keep the addresses for as long as DNS says
+        if (nameserver.isNull() && (type == QDnsLookup::A || type == QDnsLookup::AAAA)
+            && reply.error == QDnsLookup::NoError && !reply.hostAddressRecords.isEmpty()) {
+            quint32 ttl = reply.hostAddressRecords.first().timeToLive();
+            for (const QDnsHostAddressRecord &record : qAsConst(reply.hostAddressRecords))
+                ttl = qMin(ttl, record.timeToLive());
+            qt_qhostinfo_cache_set_ttl(name, int(qMin<quint32>(ttl, INT_MAX)));
+        }
+
         emit q->finished();
     }
 }
@@ -146,13 +146,24 @@ std::pair<OutputIt1, OutputIt2> separate_if(InputIt first, InputIt last, OutputI
     but also changes the order of signal emissions when using lookupHost()
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
-    for performance improvements.
+    for performance improvements. Since Qt 5.9, failed lookups are cached for
+    a few seconds too, entries that are in use are looked up again in the
+    background shortly before they expire, and an entry lives as long as the
+    DNS records' time to live when a QDnsLookup for its addresses was made.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492}
 */
 
 static QBasicAtomicInt theIdCounter = Q_BASIC_ATOMIC_INITIALIZER(1);
 
+// Looks up \a name again for the cache, without anyone waiting for the result.
+static void scheduleRefresh(QHostInfoLookupManager *manager, const QString &name)
+{
+    QHostInfoRunnable *runnable = new QHostInfoRunnable(name, theIdCounter.fetchAndAddRelaxed(1));
+    runnable->refresh = true;
+    manager->scheduleLookup(runnable);
+}
+
 /*!
     Looks up the IP address(es) associated with host name \a name, and
     returns an ID for the lookup. When the result of the lookup is
@@ -220,7 +231,10 @@ int QHostInfo::lookupHost(const QString &name, QObject *receiver,
         if (manager->cache.isEnabled()) {
             // check cache first
             bool valid = false;
-            QHostInfo info = manager->cache.get(name, &valid);
+            bool refresh = false;
+            QHostInfo info = manager->cache.get(name, &valid, &refresh);
+            if (refresh)
+                scheduleRefresh(manager, name);
             if (valid) {
                 if (!receiver)
                     return -1;
@@ -487,7 +501,7 @@ QString QHostInfo::localHostName()
     \sa hostName()
 */
 
-QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i) : toBeLookedUp(hn), id(i)
+QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i) : toBeLookedUp(hn), id(i), refresh(false)
 {
     setAutoDelete(true);
 }
@@ -508,9 +522,10 @@ void QHostInfoRunnable::run()
     // it here too because it might have been cache saved by another QHostInfoRunnable
     // in the meanwhile while this QHostInfoRunnable was scheduled but not running
     if (manager->cache.isEnabled()) {
-        // check the cache first
+        // check the cache first, unless we are here to renew it
         bool valid = false;
-        hostInfo = manager->cache.get(toBeLookedUp, &valid);
+        if (!refresh)
+            hostInfo = manager->cache.get(toBeLookedUp, &valid);
         if (!valid) {
             // not in cache, we need to do the lookup and store the result in the cache
             hostInfo = QHostInfoAgent::fromName(toBeLookedUp);
@@ -705,9 +720,12 @@ QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char
     *id = -1;
 
     // check cache
-    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
     if (manager && manager->cache.isEnabled()) {
-        QHostInfo info = manager->cache.get(name, valid);
+        bool refresh = false;
+        QHostInfo info = manager->cache.get(name, valid, &refresh);
+        if (refresh)
+            scheduleRefresh(manager, name);
         if (*valid) {
             return info;
         }
@@ -747,9 +765,19 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 }
 #endif
 
-// cache for 60 seconds
-// cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+// called by QDnsLookup with the time to live of the A or AAAA records of \a hostname
+void qt_qhostinfo_cache_set_ttl(const QString &hostname, int seconds)
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (!manager || !manager->cache.isEnabled())
+        return;
+
+    manager->cache.setTimeToLive(hostname, seconds);
+}
+
+// cache for 60 seconds unless the DNS records say otherwise, failures for 5 seconds
+// cache 1024 items
+QHostInfoCache::QHostInfoCache() : max_age(60), negative_max_age(5), enabled(true)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled = false;
@@ -768,44 +796,100 @@ void QHostInfoCache::setEnabled(bool e)
     enabled = e;
 }
 
-
-QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
+// Sets *refresh when the entry is in use and about to expire; the caller
+// should then look the name up again in the background.
+QHostInfo QHostInfoCache::get(const QString &name, bool *valid, bool *refresh)
 {
-    QMutexLocker locker(&this->mutex);
+    Shard &shard = shardFor(name);
+    QMutexLocker locker(&shard.mutex);
 
     *valid = false;
-    if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
-            *valid = true;
-        return element->info;
-
-        // FIXME idea:
-        // if too old but not expired, trigger a new lookup
-        // to freshen our cache
+    if (refresh)
+        *refresh = false;
+    QHostInfoCacheElement *element = shard.cache.object(name);
+    if (!element || element->pending)
+        return QHostInfo();
+
+    const qint64 age = element->age.elapsed();
+    if (age < element->ttl) {
+        *valid = true;
+        ++element->hits;
+        // renew entries used more than once during the last tenth of their life
+        if (refresh && !element->refreshing && element->hits > 1
+            && element->info.error() == QHostInfo::NoError
+            && element->ttl - age < element->ttl / 10) {
+            element->refreshing = true;
+            *refresh = true;
+        }
     }
-
-    return QHostInfo();
+    return element->info;
 }
 
 void QHostInfoCache::put(const QString &name, const QHostInfo &info)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    // cache failures only if the name does not exist, others may be transient
+    const bool failed = info.error() != QHostInfo::NoError;
+    if (failed && info.error() != QHostInfo::HostNotFound)
         return;
 
+    Shard &shard = shardFor(name);
+    QMutexLocker locker(&shard.mutex);
+
+    qint64 ttlHint = 0;
+    if (QHostInfoCacheElement *existing = shard.cache.object(name)) {
+        // a failed refresh leaves a still valid entry alone
+        if (failed && !existing->pending && existing->info.error() == QHostInfo::NoError
+            && existing->age.elapsed() < existing->ttl) {
+            return;
+        }
+        ttlHint = existing->ttlHint;
+    }
+
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
-    element->age = QElapsedTimer();
     element->age.start();
+    element->ttlHint = ttlHint;
+    if (failed)
+        element->ttl = negative_max_age * 1000;
+    else
+        element->ttl = ttlHint ? ttlHint : max_age * 1000;
 
-    QMutexLocker locker(&this->mutex);
-    cache.insert(name, element); // cache will take ownership
+    shard.cache.insert(name, element); // cache will take ownership
+}
+
+void QHostInfoCache::setTimeToLive(const QString &name, int seconds)
+{
+    // at least a second, so that the cache stays useful; at most a day
+    const qint64 ttl = qBound(1, seconds, 24 * 60 * 60) * qint64(1000);
+
+    Shard &shard = shardFor(name);
+    QMutexLocker locker(&shard.mutex);
+
+    QHostInfoCacheElement *element = shard.cache.object(name);
+    if (!element) {
+        // remember it for when the result comes in
+        element = new QHostInfoCacheElement();
+        element->pending = true;
+        element->ttlHint = ttl;
+        shard.cache.insert(name, element);
+        return;
+    }
+
+    element->ttlHint = ttl;
+    if (!element->pending && element->info.error() == QHostInfo::NoError) {
+        // the records were fetched just now
+        element->age.start();
+        element->ttl = ttl;
+        element->refreshing = false;
+    }
 }
 
 void QHostInfoCache::clear()
 {
-    QMutexLocker locker(&this->mutex);
-    cache.clear();
+    for (Shard &shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.cache.clear();
+    }
 }
 
 QAbstractHostInfoLookupManager* QAbstractHostInfoLookupManager::globalInstance()
@@ -125,15 +125,18 @@ QHostInfo Q_NETWORK_EXPORT qt_qhostinfo_lookup(const QString &name, QObject *rec
 void Q_AUTOTEST_EXPORT qt_qhostinfo_clear_cache();
 void Q_AUTOTEST_EXPORT qt_qhostinfo_enable_cache(bool e);
 void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolution);
+void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_set_ttl(const QString &hostname, int seconds);
 
 class QHostInfoCache
 {
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    const int negative_max_age; // seconds
 
-    QHostInfo get(const QString &name, bool *valid);
+    QHostInfo get(const QString &name, bool *valid, bool *refresh = 0);
     void put(const QString &name, const QHostInfo &info);
+    void setTimeToLive(const QString &name, int seconds);
     void clear();
 
     bool isEnabled();
@@ -141,11 +144,24 @@ public:
 private:
     bool enabled;
     struct QHostInfoCacheElement {
+        QHostInfoCacheElement() : ttl(0), ttlHint(0), hits(0), pending(false), refreshing(false) {}
         QHostInfo info;
         QElapsedTimer age;
+        qint64 ttl; // msecs
+        qint64 ttlHint; // msecs, from a DNS record; 0 if unknown
+        int hits;
+        bool pending; // only carries ttlHint, no result yet
+        bool refreshing;
     };
-    QCache<QString,QHostInfoCacheElement> cache;
-    QMutex mutex;
+    // lookups of different names rarely contend for the same lock
+    enum { ShardCount = 16, ShardSize = 64 };
+    struct Shard {
+        Shard() : cache(ShardSize) {}
+        QCache<QString,QHostInfoCacheElement> cache;
+        QMutex mutex;
+    };
+    Shard &shardFor(const QString &name) { return shards[qHash(name) % ShardCount]; }
+    Shard shards[ShardCount];
 };
 
 // the following classes are used for the (normal) case: We use multiple threads to lookup DNS
@@ -158,6 +174,7 @@ public:
 
     QString toBeLookedUp;
     int id;
+    bool refresh; // bypasses the cache to renew its entry
     QHostInfoResult resultEmitter;
 };
 
@@ -491,6 +491,9 @@
 #ifndef QABSTRACTSOCKET_BUFFERSIZE
 #define QABSTRACTSOCKET_BUFFERSIZE 32768
 #endif
+#ifndef QABSTRACTSOCKET_MAXWRITEBLOCKS
+#define QABSTRACTSOCKET_MAXWRITEBLOCKS 16
+#endif
 #define QT_CONNECT_TIMEOUT 30000
 #define QT_TRANSFER_TIMEOUT 120000
 
@@ -846,11 +849,12 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
-
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    // Attempt to write it all at once, gathering the buffer's chunks.
+    const char *blocks[QABSTRACTSOCKET_MAXWRITEBLOCKS];
+    qint64 sizes[QABSTRACTSOCKET_MAXWRITEBLOCKS];
+    const int blockCount = writeBuffer.readPointers(blocks, sizes, QABSTRACTSOCKET_MAXWRITEBLOCKS);
+    qint64 written = blockCount ? socketEngine->writeBlocks(blocks, sizes, blockCount)
+                                : Q_INT64_C(0);
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -2542,7 +2546,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     // We just write to our write buffer and enable the write notifier
     // The write notifier then flush()es the buffer.
 
-    d->writeBuffer.append(data, size);
+    d->appendToWriteBuffer(data, size);
     qint64 written = size;
 
     if (d->socketEngine && !d->writeBuffer.isEmpty())
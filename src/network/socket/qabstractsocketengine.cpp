@@ -184,6 +184,82 @@ void QAbstractSocketEngine::connectionNotification()
         receiver->connectionNotification();
 }
 
+/*!
+    Writes the \a count blocks in \a data, of the sizes given by
+    \a lengths, to the socket in order. Returns the number of bytes
+    written, or -1 if an error occurred before anything was written.
+
+    The default implementation calls write() for each block and stops
+    at the first one that is not written completely; engines that can
+    hand all blocks to the operating system at once reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeBlocks(const char * const *data, const qint64 *lengths, int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(data[i], lengths[i]);
+        if (written < 0)
+            return total ? total : written;
+        total += written;
+        if (written < lengths[i])
+            break;
+    }
+    return total;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a count datagrams from the socket. Datagram \e i is
+    stored in \a data[i], which has room for \a maxlens[i] bytes; its
+    size is stored in \a lengths[i] and, if \a headers is not null, the
+    information selected by \a options in \a headers[i].
+
+    Returns the number of datagrams read, which is less than \a count if
+    no more were pending. If nothing could be read, returns the result of
+    readDatagram(): -2 if no datagram was pending and -1 on error.
+
+    The default implementation calls readDatagram() for each datagram;
+    engines that can receive several datagrams with one system call
+    reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(char * const *data, const qint64 *maxlens, qint64 *lengths,
+                                         QIpPacketHeader *headers, int count,
+                                         PacketHeaderOptions options)
+{
+    for (int i = 0; i < count; ++i) {
+        if (i && !hasPendingDatagrams())
+            return i;
+        const qint64 read = readDatagram(data[i], maxlens[i], headers ? headers + i : 0, options);
+        if (read < 0)
+            return i ? i : int(read);
+        lengths[i] = read;
+    }
+    return count;
+}
+
+/*!
+    Writes the \a count datagrams in \a data, of the sizes given by
+    \a lengths, to the destinations in \a headers. Returns the number of
+    datagrams written, which is less than \a count if the socket could
+    not take more. If nothing could be written, returns the result of
+    writeDatagram(): -2 if the operation would block and -1 on error.
+
+    The default implementation calls writeDatagram() for each datagram;
+    engines that can send several datagrams with one system call
+    reimplement it.
+*/
+int QAbstractSocketEngine::writeDatagrams(const char * const *data, const qint64 *lengths,
+                                          const QIpPacketHeader *headers, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint64 sent = writeDatagram(data[i], lengths[i], headers[i]);
+        if (sent < 0)
+            return i ? i : int(sent);
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 #ifndef QT_NO_NETWORKPROXY
 void QAbstractSocketEngine::proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator)
 {
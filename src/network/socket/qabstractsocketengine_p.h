@@ -139,6 +139,7 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeBlocks(const char * const *data, const qint64 *lengths, int count);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -157,6 +158,13 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = 0,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+#ifndef QT_NO_UDPSOCKET
+    virtual int readDatagrams(char * const *data, const qint64 *maxlens, qint64 *lengths,
+                              QIpPacketHeader *headers, int count,
+                              PacketHeaderOptions options = WantNone);
+    virtual int writeDatagrams(const char * const *data, const qint64 *lengths,
+                               const QIpPacketHeader *headers, int count);
+#endif
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
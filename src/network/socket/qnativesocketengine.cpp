@@ -870,6 +870,41 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+#if !defined(QT_NO_UDPSOCKET) && defined(QT_HAVE_RECVMMSG)
+/*!
+    \reimp
+
+    Receives up to \a count datagrams with a single recvmmsg() call.
+*/
+int QNativeSocketEngine::readDatagrams(char * const *data, const qint64 *maxlens, qint64 *lengths,
+                                       QIpPacketHeader *headers, int count,
+                                       PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeReceiveDatagrams(data, maxlens, lengths, headers, count, options);
+}
+
+/*!
+    \reimp
+
+    Sends the \a count datagrams with a single sendmmsg() call.
+*/
+int QNativeSocketEngine::writeDatagrams(const char * const *data, const qint64 *lengths,
+                                        const QIpPacketHeader *headers, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeSendDatagrams(data, lengths, headers, count);
+}
+#endif
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -886,6 +921,19 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Writes the \a count blocks in \a data, of the sizes given by
+    \a lengths, to the socket with a single system call. Returns the
+    number of bytes written, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::writeBlocks(const char * const *data, const qint64 *lengths, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeBlocks(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeBlocks(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWrite(data, lengths, count);
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
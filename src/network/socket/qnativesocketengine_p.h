@@ -67,6 +67,11 @@
 
 QT_BEGIN_NAMESPACE
 
+// recvmmsg() and sendmmsg() move several datagrams with one system call
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_LINUXBASE)
+#  define QT_HAVE_RECVMMSG
+#endif
+
 #ifdef Q_OS_WIN
 #  define QT_SOCKLEN_T int
 #  define QT_SOCKOPTLEN_T int
@@ -146,6 +151,7 @@ public:
 
     qint64 read(char *data, qint64 maxlen) Q_DECL_OVERRIDE;
     qint64 write(const char *data, qint64 len) Q_DECL_OVERRIDE;
+    qint64 writeBlocks(const char * const *data, const qint64 *lengths, int count) Q_DECL_OVERRIDE;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -164,6 +170,13 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = 0,
                         PacketHeaderOptions = WantNone) Q_DECL_OVERRIDE;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) Q_DECL_OVERRIDE;
+#if !defined(QT_NO_UDPSOCKET) && defined(QT_HAVE_RECVMMSG)
+    int readDatagrams(char * const *data, const qint64 *maxlens, qint64 *lengths,
+                      QIpPacketHeader *headers, int count,
+                      PacketHeaderOptions options = WantNone) Q_DECL_OVERRIDE;
+    int writeDatagrams(const char * const *data, const qint64 *lengths,
+                       const QIpPacketHeader *headers, int count) Q_DECL_OVERRIDE;
+#endif
     qint64 bytesToWrite() const Q_DECL_OVERRIDE;
 
     qint64 receiveBufferSize() const;
@@ -275,8 +288,16 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#ifdef QT_HAVE_RECVMMSG
+    int nativeReceiveDatagrams(char * const *data, const qint64 *maxLengths, qint64 *lengths,
+                               QIpPacketHeader *headers, int count,
+                               QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const char * const *data, const qint64 *lengths,
+                            const QIpPacketHeader *headers, int count);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeWrite(const char * const *data, const qint64 *lengths, int count);
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
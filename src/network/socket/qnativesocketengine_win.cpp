@@ -51,6 +51,7 @@
 #include <qdebug.h>
 #include <qdatetime.h>
 #include <qnetworkinterface.h>
+#include <qvarlengtharray.h>
 
 //#define QNATIVESOCKETENGINE_DEBUG
 #if defined(QNATIVESOCKETENGINE_DEBUG)
@@ -1461,6 +1462,47 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
     return ret;
 }
 
+qint64 QNativeSocketEnginePrivate::nativeWrite(const char * const *data, const qint64 *lengths, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    if (count == 1)
+        return nativeWrite(data[0], lengths[0]);
+
+    QVarLengthArray<WSABUF, 16> bufs(count);
+    for (int i = 0; i < count; ++i) {
+        bufs[i].buf = const_cast<char *>(data[i]);
+        bufs[i].len = ULONG(lengths[i]);
+    }
+
+    DWORD bytesWritten = 0;
+    qint64 ret = 0;
+    if (::WSASend(socketDescriptor, bufs.data(), DWORD(count), &bytesWritten, 0, 0, 0) != SOCKET_ERROR) {
+        ret = qint64(bytesWritten);
+    } else {
+        // Anything short of a broken connection just means nothing was
+        // written this time; the write notifier brings us back.
+        int err = WSAGetLastError();
+        WS_ERROR_DEBUG(err);
+        switch (err) {
+        case WSAECONNRESET:
+        case WSAECONNABORTED:
+            ret = -1;
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            q->close();
+            break;
+        default:
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWrite(%d blocks) == %li", count, (int)ret);
+#endif
+
+    return ret;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxLength)
 {
     qint64 ret = -1;
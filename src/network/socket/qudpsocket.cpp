@@ -102,11 +102,18 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
 #ifndef QT_NO_UDPSOCKET
 
+// receiveDatagrams() reads at most this many datagrams per call, which is
+// also the most recvmmsg() accepts on Linux (UIO_MAXIOV)
+static const int MaxDatagramsPerCall = 1024;
+// a UDP payload is never larger than this
+static const qint64 MaxDatagramSize = 65536;
+
 #define QT_CHECK_BOUND(function, a) do { \
     if (!isValid()) { \
         qWarning(function" called on a QUdpSocket when not in QUdpSocket::BoundState"); \
@@ -125,6 +132,9 @@ public:
 
     inline bool ensureInitialized(const QHostAddress &remoteAddress)
     { return doEnsureInitialized(QHostAddress(), 0, remoteAddress); }
+
+    // receiveDatagrams() reads datagrams of unknown size into this buffer
+    QByteArray receiveBuffer;
 };
 
 bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, quint16 bindPort,
@@ -420,6 +430,68 @@ qint64 QUdpSocket::writeDatagram(const QNetworkDatagram &datagram)
     return sent;
 }
 
+/*!
+    \since 5.9
+
+    Sends the datagrams in \a datagrams, each to the host address and port
+    numbers it contains, like writeDatagram() does. Where the operating
+    system supports it, as on Linux, the datagrams are handed to it with a
+    single system call, which is considerably faster than calling
+    writeDatagram() for each of them.
+
+    Returns the number of datagrams sent, which is less than the size of
+    \a datagrams if the socket's send buffer filled up, or -1 if an error
+    occurred before anything was sent. As with writeDatagram(), a send
+    buffer that is already full is reported as -1 with error() set to
+    QAbstractSocket::TemporaryError. bytesWritten() is emitted once with
+    the total size of the datagrams sent.
+
+    \sa receiveDatagrams(), writeDatagram()
+*/
+int QUdpSocket::writeDatagrams(const QVector<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%d)", datagrams.size());
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.first().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    const int count = datagrams.size();
+    QVarLengthArray<const char *, 64> data(count);
+    QVarLengthArray<qint64, 64> lengths(count);
+    QVarLengthArray<QIpPacketHeader, 64> headers(count);
+    for (int i = 0; i < count; ++i) {
+        const QNetworkDatagramPrivate *dd = datagrams.at(i).d;
+        data[i] = dd->data.constData();
+        lengths[i] = dd->data.size();
+        headers[i] = dd->header;
+    }
+
+    int sent = d->socketEngine->writeDatagrams(data.constData(), lengths.constData(),
+                                               headers.constData(), count);
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent >= 0) {
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += lengths[i];
+        emit bytesWritten(bytes);
+    } else if (sent == -2) {
+        // Socket engine reports EAGAIN. Treat as a temporary error.
+        d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                           tr("Unable to send a datagram"));
+        sent = -1;
+    } else {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    }
+    return sent;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and returns it in the
     QNetworkDatagram object, along with the sender's host address and port. If
@@ -461,6 +533,90 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 5.9
+
+    Receives up to \a maxCount pending datagrams, each no larger than
+    \a maxSize bytes, and returns them along with their sender's and
+    destination addresses and ports, like receiveDatagram() does. Where the
+    operating system supports it, as on Linux, the datagrams are read with
+    a single system call, which is considerably faster than calling
+    receiveDatagram() for each of them.
+
+    Returns fewer than \a maxCount datagrams if no more were pending, and
+    an empty vector if none was pending or an error occurred.
+
+    At most 1024 datagrams are read per call; a larger \a maxCount is
+    treated as 1024.
+
+    If \a maxSize is -1 (the default), datagrams of any size are read; this
+    uses a buffer of 64 KiB per datagram, which the socket keeps for later
+    calls. Otherwise datagrams larger than \a maxSize bytes are truncated.
+
+    \sa writeDatagrams(), receiveDatagram()
+*/
+QVector<QNetworkDatagram> QUdpSocket::receiveDatagrams(int maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%d, %lld)", maxCount, maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QVector<QNetworkDatagram>());
+
+    QVector<QNetworkDatagram> result;
+    if (maxCount <= 0)
+        return result;
+    maxCount = qMin(maxCount, MaxDatagramsPerCall);
+
+    // datagrams of unknown size are read into a scratch buffer and copied
+    const qint64 slotSize = maxSize < 0 ? MaxDatagramSize : qMin(maxSize, MaxDatagramSize);
+    char *scratch = 0;
+    if (maxSize < 0) {
+        const qint64 scratchSize = slotSize * maxCount;
+        if (d->receiveBuffer.size() < scratchSize)
+            d->receiveBuffer.resize(int(scratchSize));
+        scratch = d->receiveBuffer.data();
+    }
+
+    result.resize(maxCount);
+    QVarLengthArray<char *, 64> data(maxCount);
+    QVarLengthArray<qint64, 64> maxLengths(maxCount);
+    QVarLengthArray<qint64, 64> lengths(maxCount);
+    QVarLengthArray<QIpPacketHeader, 64> headers(maxCount);
+    for (int i = 0; i < maxCount; ++i) {
+        if (maxSize < 0) {
+            data[i] = scratch + i * slotSize;
+        } else {
+            result[i].d->data.resize(int(slotSize));
+            data[i] = result[i].d->data.data();
+        }
+        maxLengths[i] = slotSize;
+    }
+
+    int count = d->socketEngine->readDatagrams(data.constData(), maxLengths.constData(),
+                                               lengths.data(), headers.data(), maxCount,
+                                               QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (count < 0) {
+        if (count == -1)
+            d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        count = 0;
+    }
+
+    result.resize(count);
+    for (int i = 0; i < count; ++i) {
+        QNetworkDatagramPrivate *dd = result[i].d;
+        if (maxSize < 0)
+            dd->data = QByteArray(data[i], int(lengths[i]));
+        else if (lengths[i] != dd->data.size())
+            dd->data.truncate(int(lengths[i]));
+        dd->header = headers[i];
+    }
+    return result;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
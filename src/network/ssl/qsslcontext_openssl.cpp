@@ -42,6 +42,7 @@
 
 #include <QtNetwork/qsslsocket.h>
 #include <QtNetwork/qssldiffiehellmanparameters.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qmutex.h>
 
 #include "private/qssl_p.h"
@@ -57,6 +58,149 @@ QT_BEGIN_NAMESPACE
 extern int q_X509Callback(int ok, X509_STORE_CTX *ctx);
 extern QString getErrorsFromOpenSsl();
 
+Q_GLOBAL_STATIC_WITH_ARGS(QSslSessionCache, clientSessionCache, (256))
+Q_GLOBAL_STATIC_WITH_ARGS(QSslSessionCache, serverSessionCache, (4096))
+
+QSslSessionCache::QSslSessionCache(int maxSessions)
+    : sessions(maxSessions)
+{
+}
+
+QSslSessionCache *QSslSessionCache::clientSessions()
+{
+    return clientSessionCache();
+}
+
+QSslSessionCache *QSslSessionCache::serverSessions()
+{
+    return serverSessionCache();
+}
+
+void QSslSessionCache::insert(const QByteArray &key, SSL_SESSION *session)
+{
+    const int size = q_i2d_SSL_SESSION(session, 0);
+    if (size <= 0)
+        return;
+
+    Entry *entry = new Entry;
+    entry->asn1.resize(size);
+    unsigned char *data = reinterpret_cast<unsigned char *>(entry->asn1.data());
+    if (!q_i2d_SSL_SESSION(session, &data)) {
+        delete entry;
+        return;
+    }
+    // OpenSSL 1.0 has no accessor for the ticket lifetime hint; a server
+    // that no longer accepts the ticket just does a full handshake
+    entry->expiry.setRemainingTime(qint64(q_SSL_SESSION_get_timeout(session)) * 1000);
+
+    QMutexLocker locker(&mutex);
+    sessions.insert(key, entry);
+}
+
+SSL_SESSION *QSslSessionCache::find(const QByteArray &key)
+{
+    QByteArray asn1;
+    {
+        QMutexLocker locker(&mutex);
+        Entry *entry = sessions.object(key);
+        if (!entry)
+            return 0;
+        if (entry->expiry.hasExpired()) {
+            sessions.remove(key);
+            return 0;
+        }
+        asn1 = entry->asn1;
+    }
+
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(asn1.constData());
+    return q_d2i_SSL_SESSION(0, &data, asn1.size());
+}
+
+void QSslSessionCache::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    sessions.remove(key);
+}
+
+// A resumed session skips the verification of the peer, so it may only be
+// resumed with the certificate and the verification settings it was
+// established with.
+QByteArray QSslSessionCache::configurationDigest(const QSslConfiguration &configuration)
+{
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+    digest.addData(configuration.localCertificate().toDer());
+    digest.addData(QByteArray::number(int(configuration.protocol())));
+    digest.addData(QByteArray::number(int(configuration.peerVerifyMode())));
+    digest.addData(QByteArray::number(configuration.peerVerifyDepth()));
+    const QList<QSslCertificate> caCertificates = configuration.caCertificates();
+    for (const QSslCertificate &certificate : caCertificates)
+        digest.addData(certificate.toDer());
+    return digest.result();
+}
+
+static QByteArray sessionId(const SSL_SESSION *session)
+{
+    unsigned int length = 0;
+    const unsigned char *id = q_SSL_SESSION_get_id(session, &length);
+    return QByteArray(reinterpret_cast<const char *>(id), int(length));
+}
+
+// Server sockets each get an SSL_CTX of their own, so OpenSSL's session
+// cache and ticket keys, which live in the context, would never be reused.
+// Instead sessions go to a process-wide cache, and all contexts encrypt
+// tickets with the same keys.
+static int q_ssl_new_session_cb(SSL *, SSL_SESSION *session)
+{
+    QSslSessionCache::serverSessions()->insert(sessionId(session), session);
+    return 0; // we did not keep a reference to the session
+}
+
+static void q_ssl_remove_session_cb(SSL_CTX *, SSL_SESSION *session)
+{
+    QSslSessionCache::serverSessions()->remove(sessionId(session));
+}
+
+static SSL_SESSION *q_ssl_get_session_cb(SSL *, unsigned char *data, int len, int *copy)
+{
+    *copy = 0; // OpenSSL takes over our reference
+    return QSslSessionCache::serverSessions()->find(QByteArray::fromRawData(reinterpret_cast<const char *>(data), len));
+}
+
+#ifdef SSL_CTRL_SET_TLSEXT_TICKET_KEYS
+struct QSslTicketKeys
+{
+    QSslTicketKeys()
+    {
+        valid = q_RAND_bytes(keys, sizeof(keys)) > 0;
+    }
+
+    unsigned char keys[48];
+    bool valid;
+};
+Q_GLOBAL_STATIC(QSslTicketKeys, ticketKeys)
+#endif
+
+static void setupServerSessionCache(SSL_CTX *ctx, const QSslConfiguration &configuration)
+{
+    // Only resume sessions that were established with the same certificate
+    // and verification settings.
+    const QByteArray sidContext = QSslSessionCache::configurationDigest(configuration);
+    q_SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const unsigned char *>(sidContext.constData()),
+                                     sidContext.size());
+
+    q_SSL_CTX_ctrl(ctx, SSL_CTRL_SET_SESS_CACHE_MODE, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL, 0);
+    q_SSL_CTX_sess_set_new_cb(ctx, q_ssl_new_session_cb);
+    q_SSL_CTX_sess_set_remove_cb(ctx, q_ssl_remove_session_cb);
+    q_SSL_CTX_sess_set_get_cb(ctx, q_ssl_get_session_cb);
+
+#ifdef SSL_CTRL_SET_TLSEXT_TICKET_KEYS
+    if (!configuration.testSslOption(QSsl::SslOptionDisableSessionTickets) && ticketKeys()->valid) {
+        q_SSL_CTX_ctrl(ctx, SSL_CTRL_SET_TLSEXT_TICKET_KEYS, sizeof(ticketKeys()->keys),
+                       ticketKeys()->keys);
+    }
+#endif
+}
+
 QSslContext::QSslContext()
     : ctx(0),
     pkey(0),
@@ -310,6 +454,9 @@ init_context:
     if (!configuration.sessionTicket().isEmpty())
         sslContext->setSessionASN1(configuration.sessionTicket());
 
+    if (!client && !configuration.testSslOption(QSsl::SslOptionDisableSessionSharing))
+        setupServerSessionCache(sslContext->ctx, configuration);
+
     // Set temp DH params
     QSslDiffieHellmanParameters dhparams = configuration.diffieHellmanParameters();
 
@@ -55,6 +55,9 @@
 
 #include <QtNetwork/private/qtnetworkglobal_p.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmutex.h>
 #include <QtNetwork/qsslcertificate.h>
 #include <QtNetwork/qsslconfiguration.h>
 #include <openssl/ssl.h>
@@ -123,6 +126,32 @@ private:
 #endif // OPENSSL_VERSION_NUMBER >= 0x1000100fL ...
 };
 
+// Keeps TLS sessions for resumption by later connections. The sessions are
+// stored serialized, so that they can be handed out to any thread.
+class QSslSessionCache
+{
+public:
+    explicit QSslSessionCache(int maxSessions);
+
+    static QSslSessionCache *clientSessions();
+    static QSslSessionCache *serverSessions();
+    static QByteArray configurationDigest(const QSslConfiguration &configuration);
+
+    void insert(const QByteArray &key, SSL_SESSION *session);
+    SSL_SESSION *find(const QByteArray &key); // the caller owns the returned session
+    void remove(const QByteArray &key);
+
+private:
+    struct Entry
+    {
+        QByteArray asn1;
+        QDeadlineTimer expiry;
+    };
+
+    QMutex mutex;
+    QCache<QByteArray, Entry> sessions;
+};
+
 #endif // QT_NO_SSL
 
 QT_END_NAMESPACE
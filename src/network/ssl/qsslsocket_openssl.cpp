@@ -417,6 +417,16 @@ bool QSslSocketBackendPrivate::initSslContext()
         }
     }
 
+    // Resume a session another socket established with the same peer, unless
+    // the context already carries one.
+    if (mode == QSslSocket::SslClientMode && !q_SSL_get_session(ssl)
+        && !(configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+        if (SSL_SESSION *cached = QSslSessionCache::clientSessions()->find(clientSessionKey())) {
+            q_SSL_set_session(ssl, cached);
+            q_SSL_SESSION_free(cached);
+        }
+    }
+
     // Clear the session.
     errorList.clear();
 
@@ -456,6 +466,26 @@ bool QSslSocketBackendPrivate::initSslContext()
     return true;
 }
 
+/*!
+    \internal
+
+    Returns the key under which client sessions are shared between sockets:
+    a session is only resumed for the same peer and with the same settings
+    it was negotiated with.
+*/
+QByteArray QSslSocketBackendPrivate::clientSessionKey() const
+{
+    Q_Q(const QSslSocket);
+    QString peer = verificationPeerName.isEmpty() ? q->peerName() : verificationPeerName;
+    if (peer.isEmpty())
+        peer = hostName;
+
+    QByteArray key = peer.toUtf8();
+    key += ':' + QByteArray::number(q->peerPort());
+    key += ':' + QSslSessionCache::configurationDigest(q->sslConfiguration()).toHex();
+    return key;
+}
+
 void QSslSocketBackendPrivate::destroySslContext()
 {
     if (ssl) {
@@ -1582,6 +1612,14 @@ void QSslSocketBackendPrivate::continueHandshake()
 
     // Cache this SSL session inside the QSslContext
     if (!(configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+        // Offer the session to other sockets connecting to the same peer; a
+        // session established despite ignored errors is not worth sharing.
+        if (mode == QSslSocket::SslClientMode && sslErrors.isEmpty()
+            && !configuration.peerSessionShared) {
+            if (SSL_SESSION *session = q_SSL_get_session(ssl))
+                QSslSessionCache::clientSessions()->insert(clientSessionKey(), session);
+        }
+
         if (!sslContextPointer->cacheSession(ssl)) {
             sslContextPointer.clear(); // we could not cache the session
         } else {
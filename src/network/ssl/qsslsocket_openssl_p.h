@@ -122,6 +122,7 @@ public:
     // SSL context
     bool initSslContext();
     void destroySslContext();
+    QByteArray clientSessionKey() const;
     SSL *ssl;
     BIO *readBio;
     BIO *writeBio;
@@ -232,6 +232,7 @@ DEFINEFUNC2(int, PEM_write_bio_EC_PUBKEY, BIO *a, a, EC_KEY *b, b, return 0, ret
 #endif
 DEFINEFUNC2(void, RAND_seed, const void *a, a, int b, b, return, DUMMYARG)
 DEFINEFUNC(int, RAND_status, void, DUMMYARG, return -1, return)
+DEFINEFUNC2(int, RAND_bytes, unsigned char *buf, buf, int num, num, return -1, return)
 DEFINEFUNC(RSA *, RSA_new, DUMMYARG, DUMMYARG, return 0, return)
 DEFINEFUNC(void, RSA_free, RSA *a, a, return, DUMMYARG)
 DEFINEFUNC(int, sk_num, STACK *a, a, return -1, return)
@@ -300,6 +301,12 @@ DEFINEFUNC2(int, SSL_set_session, SSL* to, to, SSL_SESSION *session, session, re
 DEFINEFUNC(void, SSL_SESSION_free, SSL_SESSION *ses, ses, return, DUMMYARG)
 DEFINEFUNC(SSL_SESSION*, SSL_get1_session, SSL *ssl, ssl, return 0, return)
 DEFINEFUNC(SSL_SESSION*, SSL_get_session, const SSL *ssl, ssl, return 0, return)
+DEFINEFUNC(long, SSL_SESSION_get_timeout, const SSL_SESSION *session, session, return 0, return)
+DEFINEFUNC2(const unsigned char *, SSL_SESSION_get_id, const SSL_SESSION *session, session, unsigned int *len, len, return 0, return)
+DEFINEFUNC3(int, SSL_CTX_set_session_id_context, SSL_CTX *ctx, ctx, const unsigned char *sid_ctx, sid_ctx, unsigned int sid_ctx_len, sid_ctx_len, return 0, return)
+DEFINEFUNC2(void, SSL_CTX_sess_set_new_cb, SSL_CTX *ctx, ctx, int (*cb)(SSL *ssl, SSL_SESSION *session), cb, return, DUMMYARG)
+DEFINEFUNC2(void, SSL_CTX_sess_set_remove_cb, SSL_CTX *ctx, ctx, void (*cb)(SSL_CTX *ctx, SSL_SESSION *session), cb, return, DUMMYARG)
+DEFINEFUNC2(void, SSL_CTX_sess_set_get_cb, SSL_CTX *ctx, ctx, SSL_SESSION *(*cb)(SSL *ssl, unsigned char *data, int len, int *copy), cb, return, DUMMYARG)
 #if OPENSSL_VERSION_NUMBER >= 0x10001000L
 DEFINEFUNC5(int, SSL_get_ex_new_index, long argl, argl, void *argp, argp, CRYPTO_EX_new *new_func, new_func, CRYPTO_EX_dup *dup_func, dup_func, CRYPTO_EX_free *free_func, free_func, return -1, return)
 DEFINEFUNC3(int, SSL_set_ex_data, SSL *ssl, ssl, int idx, idx, void *arg, arg, return 0, return)
@@ -864,6 +871,7 @@ bool q_resolveOpenSslSymbols()
 #endif
     RESOLVEFUNC(RAND_seed)
     RESOLVEFUNC(RAND_status)
+    RESOLVEFUNC(RAND_bytes)
     RESOLVEFUNC(RSA_new)
     RESOLVEFUNC(RSA_free)
     RESOLVEFUNC(sk_new_null)
@@ -912,6 +920,12 @@ bool q_resolveOpenSslSymbols()
     RESOLVEFUNC(SSL_SESSION_free)
     RESOLVEFUNC(SSL_get1_session)
     RESOLVEFUNC(SSL_get_session)
+    RESOLVEFUNC(SSL_SESSION_get_timeout)
+    RESOLVEFUNC(SSL_SESSION_get_id)
+    RESOLVEFUNC(SSL_CTX_set_session_id_context)
+    RESOLVEFUNC(SSL_CTX_sess_set_new_cb)
+    RESOLVEFUNC(SSL_CTX_sess_set_remove_cb)
+    RESOLVEFUNC(SSL_CTX_sess_set_get_cb)
 #if OPENSSL_VERSION_NUMBER >= 0x10001000L
     RESOLVEFUNC(SSL_get_ex_new_index)
     RESOLVEFUNC(SSL_set_ex_data)
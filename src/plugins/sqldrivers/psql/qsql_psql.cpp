@@ -51,6 +51,7 @@
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
 #include <qmutex.h>
+#include <qqueue.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 
@@ -107,6 +108,14 @@
 
 #define VARHDRSZ 4
 
+// number of characters after which a batch is flushed to the server
+#define QPSQL_BATCH_QUERY_SIZE 65536
+
+// forward-only queries stream their rows if libpq supports single-row mode
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 90200
+#define QPSQL_SINGLE_ROW_MODE
+#endif
+
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
 template <typename T>
@@ -152,6 +161,8 @@ protected:
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
+    void detachFromResultSet() Q_DECL_OVERRIDE;
 };
 
 class QPSQLDriverPrivate : public QSqlDriverPrivate
@@ -164,7 +175,8 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        streamingResult(0)
     { dbmsType = QSqlDriver::PostgreSQL; }
 
     PGconn *connection;
@@ -174,10 +186,15 @@ public:
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    // the result whose rows are still arriving on the connection, if any
+    mutable QPSQLResultPrivate *streamingResult;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    bool sendQuery(const QString &stmt) const;
+    void checkPendingNotifications() const;
+    void finishStreaming() const;
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
@@ -210,12 +227,9 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
 
 PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
 {
-    Q_Q(const QPSQLDriver);
+    finishStreaming();
     PGresult *result = PQexec(connection, stmt);
-    if (seid.size() && !pendingNotifyCheck) {
-        pendingNotifyCheck = true;
-        QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
-    }
+    checkPendingNotifications();
     return result;
 }
 
@@ -224,6 +238,24 @@ PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
     return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
 }
 
+bool QPSQLDriverPrivate::sendQuery(const QString &stmt) const
+{
+    finishStreaming();
+    const bool ok = PQsendQuery(connection, isUtf8 ? stmt.toUtf8().constData()
+                                                   : stmt.toLocal8Bit().constData());
+    checkPendingNotifications();
+    return ok;
+}
+
+void QPSQLDriverPrivate::checkPendingNotifications() const
+{
+    Q_Q(const QPSQLDriver);
+    if (seid.size() && !pendingNotifyCheck) {
+        pendingNotifyCheck = true;
+        QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
+    }
+}
+
 class QPSQLResultPrivate : public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLResult)
@@ -233,18 +265,31 @@ public:
       : QSqlResultPrivate(q, drv),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        preparedQueriesEnabled(false),
+        streaming(false),
+        cancelable(false)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
     void deallocatePreparedStmt();
 
+    enum StreamEnd { BufferRows, DiscardRows, CancelQuery };
+
     PGresult *result;
     int currentSize;
     bool preparedQueriesEnabled;
     QString preparedStmtId;
+    // in single-row mode, result only holds the current row
+    bool streaming;
+    bool cancelable;
+    QQueue<PGresult *> bufferedResults;
 
     bool processResults();
+    bool execute(const QString &stmt);
+    bool startStreaming(const QString &stmt);
+    PGresult *nextStreamResult();
+    void endStreaming(StreamEnd how);
+    int currentRow() const { return streaming ? 0 : q_func()->at(); }
 };
 
 static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
@@ -267,6 +312,14 @@ bool QPSQLResultPrivate::processResults()
         return false;
 
     int status = PQresultStatus(result);
+#ifdef QPSQL_SINGLE_ROW_MODE
+    if (status == PGRES_SINGLE_TUPLE) {
+        q->setSelect(true);
+        q->setActive(true);
+        currentSize = -1;
+        return true;
+    }
+#endif
     if (status == PGRES_TUPLES_OK) {
         q->setSelect(true);
         q->setActive(true);
@@ -283,6 +336,103 @@ bool QPSQLResultPrivate::processResults()
     return false;
 }
 
+bool QPSQLResultPrivate::execute(const QString &stmt)
+{
+#ifdef QPSQL_SINGLE_ROW_MODE
+    Q_Q(QPSQLResult);
+    if (q->isForwardOnly())
+        return startStreaming(stmt);
+#endif
+    result = drv_d_func()->exec(stmt);
+    return processResults();
+}
+
+/*
+    Forward-only queries are sent asynchronously and switched to single-row
+    mode, so each row arrives in its own PGresult and only the current one is
+    held in memory. Results of leading statements that produce no rows are
+    skipped until rows arrive or the query is done, which matches what
+    PQexec() would have returned.
+*/
+bool QPSQLResultPrivate::startStreaming(const QString &stmt)
+{
+#ifdef QPSQL_SINGLE_ROW_MODE
+    Q_Q(QPSQLResult);
+    const QPSQLDriverPrivate *drv = drv_d_func();
+    drv->finishStreaming();
+    // cancelling a query inside a transaction block would abort the transaction
+    cancelable = PQtransactionStatus(drv->connection) == PQTRANS_IDLE;
+    if (!drv->sendQuery(stmt)) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to send query"), QSqlError::StatementError, drv));
+        return false;
+    }
+    PQsetSingleRowMode(drv->connection);
+    drv->streamingResult = this;
+
+    while (PGresult *next = nextStreamResult()) {
+        if (result)
+            PQclear(result);
+        result = next;
+        if (PQresultStatus(result) == PGRES_SINGLE_TUPLE) {
+            streaming = true;
+            break;
+        }
+    }
+    return processResults();
+#else
+    Q_UNUSED(stmt);
+    return false;
+#endif
+}
+
+PGresult *QPSQLResultPrivate::nextStreamResult()
+{
+    if (!bufferedResults.isEmpty())
+        return bufferedResults.dequeue();
+    const QPSQLDriverPrivate *drv = drv_d_func();
+    if (!drv || drv->streamingResult != this)
+        return 0;
+    PGresult *next = PQgetResult(drv->connection);
+    if (!next)
+        drv->streamingResult = 0;
+    return next;
+}
+
+/*
+    Releases the connection from a query whose results have not all been
+    read. Another query needs the connection, so the remaining rows are
+    either kept in memory for this result, dropped, or dropped after asking
+    the server to stop producing them.
+*/
+void QPSQLResultPrivate::endStreaming(StreamEnd how)
+{
+    const QPSQLDriverPrivate *drv = drv_d_func();
+    if (!drv || drv->streamingResult != this)
+        return;
+
+    if (how == CancelQuery && cancelable) {
+        if (PGcancel *cancel = PQgetCancel(drv->connection)) {
+            char errbuf[256];
+            PQcancel(cancel, errbuf, sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+    }
+    while (PGresult *next = PQgetResult(drv->connection)) {
+        if (how == BufferRows)
+            bufferedResults.enqueue(next);
+        else
+            PQclear(next);
+    }
+    drv->streamingResult = 0;
+}
+
+void QPSQLDriverPrivate::finishStreaming() const
+{
+    if (streamingResult)
+        streamingResult->endStreaming(QPSQLResultPrivate::BufferRows);
+}
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -365,6 +515,10 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+    d->endStreaming(QPSQLResultPrivate::CancelQuery);
+    while (!d->bufferedResults.isEmpty())
+        PQclear(d->bufferedResults.dequeue());
+    d->streaming = false;
     if (d->result)
         PQclear(d->result);
     d->result = 0;
@@ -375,15 +529,44 @@ void QPSQLResult::cleanup()
 
 bool QPSQLResult::fetch(int i)
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
     if (!isActive())
         return false;
     if (i < 0)
         return false;
-    if (i >= d->currentSize)
-        return false;
     if (at() == i)
         return true;
+    if (d->streaming) {
+        // rows can only be read in order; the first one is already there
+        if (i < at())
+            return false;
+        if (at() == QSql::BeforeFirstRow)
+            setAt(0);
+        while (at() < i) {
+            PGresult *next = d->nextStreamResult();
+            if (!next)
+                return false;
+            int status = PQresultStatus(next);
+#ifdef QPSQL_SINGLE_ROW_MODE
+            if (status == PGRES_SINGLE_TUPLE) {
+                PQclear(d->result);
+                d->result = next;
+                setAt(at() + 1);
+                continue;
+            }
+#endif
+            // the rows end with an empty PGRES_TUPLES_OK result or an error
+            if (status != PGRES_TUPLES_OK)
+                setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                             "Unable to fetch row"), QSqlError::StatementError, d->drv_d_func(), next));
+            PQclear(next);
+            d->endStreaming(QPSQLResultPrivate::DiscardRows);
+            return false;
+        }
+        return true;
+    }
+    if (i >= d->currentSize)
+        return false;
     setAt(i);
     return true;
 }
@@ -396,6 +579,11 @@ bool QPSQLResult::fetchFirst()
 bool QPSQLResult::fetchLast()
 {
     Q_D(const QPSQLResult);
+    if (d->streaming) {
+        while (fetch(at() + 1))
+            ;
+        return at() >= 0 && !lastError().isValid();
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
@@ -408,8 +596,9 @@ QVariant QPSQLResult::data(int i)
     }
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const int row = d->currentRow();
+    const char *val = PQgetvalue(d->result, row, i);
+    if (PQgetisnull(d->result, row, i))
         return QVariant(type);
     switch (type) {
     case QVariant::Bool:
@@ -494,8 +683,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int row = d->currentRow();
+    PQgetvalue(d->result, row, field);
+    return PQgetisnull(d->result, row, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -506,8 +696,7 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
-    d->result = d->drv_d_func()->exec(query);
-    return d->processResults();
+    return d->execute(query);
 }
 
 int QPSQLResult::size()
@@ -672,9 +861,76 @@ bool QPSQLResult::exec()
     else
         stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId).arg(params);
 
-    d->result = d->drv_d_func()->exec(stmt);
+    return d->execute(stmt);
+}
 
-    return d->processResults();
+void QPSQLResult::detachFromResultSet()
+{
+    Q_D(QPSQLResult);
+    d->endStreaming(QPSQLResultPrivate::CancelQuery);
+}
+
+/*
+    Sends the rows of a batch as a pipeline of EXECUTE commands in as few
+    simple queries as possible instead of one round trip per row. When the
+    batch needs more than one query and no transaction is open, the queries
+    are wrapped into one so that the batch still applies atomically.
+*/
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    if (!d->preparedQueriesEnabled || d->preparedStmtId.isEmpty())
+        return QSqlResult::execBatch(arrayBind);
+
+    const QVector<QVariant> values = boundValues();
+    if (values.isEmpty())
+        return false;
+
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (const QVariant &value : values) {
+        columns.append(value.toList());
+        if (columns.last().count() != columns.first().count()) {
+            setLastError(QSqlError(QCoreApplication::translate("QPSQLResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    cleanup();
+
+    const QPSQLDriverPrivate *drv = d->drv_d_func();
+    const QString execute = QLatin1String("EXECUTE ") + d->preparedStmtId + QLatin1String(" (");
+    const int rows = columns.first().count();
+    bool transaction = false;
+    QVector<QVariant> row(values.count());
+    QString stmt;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < row.count(); ++j)
+            row[j] = columns.at(j).at(i);
+        stmt += execute + qCreateParamString(row, driver()) + QLatin1String(");");
+
+        const bool last = i + 1 == rows;
+        if (!last && stmt.size() < QPSQL_BATCH_QUERY_SIZE)
+            continue;
+        if (!last && !transaction && PQtransactionStatus(drv->connection) == PQTRANS_IDLE) {
+            stmt.prepend(QLatin1String("BEGIN;"));
+            transaction = true;
+        }
+        if (last && transaction)
+            stmt += QLatin1String("COMMIT;");
+
+        if (d->result)
+            PQclear(d->result);
+        d->result = drv->exec(stmt);
+        stmt.clear();
+        if (!d->processResults()) {
+            if (transaction)
+                PQclear(drv->exec("ROLLBACK"));
+            return false;
+        }
+    }
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -855,8 +1111,8 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
         return true;
     case PreparedQueries:
     case PositionalPlaceholders:
-        return d->pro >= QPSQLDriver::Version82;
     case BatchOperations:
+        return d->pro >= QPSQLDriver::Version82;
     case NamedPlaceholders:
     case SimpleLocking:
     case FinishQuery:
@@ -945,6 +1201,8 @@ void QPSQLDriver::close()
             d->sn = 0;
         }
 
+        if (d->streamingResult)
+            d->streamingResult->endStreaming(QPSQLResultPrivate::DiscardRows);
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
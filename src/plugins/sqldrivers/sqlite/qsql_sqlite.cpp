@@ -39,6 +39,7 @@
 
 #include "qsql_sqlite_p.h"
 
+#include <qcache.h>
 #include <qcoreapplication.h>
 #include <qdatetime.h>
 #include <qvariant.h>
@@ -125,6 +126,7 @@ protected:
     bool reset(const QString &query) Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
     int size() Q_DECL_OVERRIDE;
     int numRowsAffected() Q_DECL_OVERRIDE;
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
@@ -133,6 +135,15 @@ protected:
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
 };
 
+// a prepared statement that is not used by any result
+struct QSQLiteCachedStatement
+{
+    explicit QSQLiteCachedStatement(sqlite3_stmt *stmt) : stmt(stmt) {}
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *stmt;
+};
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QSQLiteDriver)
@@ -142,6 +153,8 @@ public:
     sqlite3 *access;
     QList <QSQLiteResult *> results;
     QStringList notificationid;
+    // statements of finished queries, by query text, least recently used dropped first
+    QCache<QString, QSQLiteCachedStatement> statements;
 };
 
 
@@ -154,11 +167,14 @@ public:
     QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver *drv);
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    int bindValue(int pos, const QVariant &value);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
+    void release();
 
     sqlite3_stmt *stmt;
+    QString stmtQuery;
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
@@ -177,7 +193,7 @@ QSQLiteResultPrivate::QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver
 void QSQLiteResultPrivate::cleanup()
 {
     Q_Q(QSQLiteResult);
-    finalize();
+    release();
     rInf.clear();
     skippedStatus = false;
     skipRow = false;
@@ -195,6 +211,26 @@ void QSQLiteResultPrivate::finalize()
     stmt = 0;
 }
 
+/*
+    Hands the statement to the driver's cache, from where prepare() takes it
+    again for the same query text instead of compiling the query anew.
+*/
+void QSQLiteResultPrivate::release()
+{
+    if (!stmt)
+        return;
+
+    QSQLiteDriverPrivate *driverPrivate = const_cast<QSQLiteDriverPrivate *>(drv_d_func());
+    if (!driverPrivate || driverPrivate->statements.maxCost() <= 0) {
+        finalize();
+        return;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    driverPrivate->statements.insert(stmtQuery, new QSQLiteCachedStatement(stmt));
+    stmt = 0;
+}
+
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
 {
     Q_Q(QSQLiteResult);
@@ -247,6 +283,63 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     }
 }
 
+// binds \a value to the 1-based parameter \a pos of the current statement;
+// strings and byte arrays are bound without copying, so \a value must stay
+// alive until the statement has been stepped
+int QSQLiteResultPrivate::bindValue(int pos, const QVariant &value)
+{
+    int res = SQLITE_OK;
+    if (value.isNull()) {
+        res = sqlite3_bind_null(stmt, pos);
+    } else {
+        switch (value.type()) {
+        case QVariant::ByteArray: {
+            const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
+            res = sqlite3_bind_blob(stmt, pos, ba->constData(),
+                                    ba->size(), SQLITE_STATIC);
+            break; }
+        case QVariant::Int:
+        case QVariant::Bool:
+            res = sqlite3_bind_int(stmt, pos, value.toInt());
+            break;
+        case QVariant::Double:
+            res = sqlite3_bind_double(stmt, pos, value.toDouble());
+            break;
+        case QVariant::UInt:
+        case QVariant::LongLong:
+            res = sqlite3_bind_int64(stmt, pos, value.toLongLong());
+            break;
+        case QVariant::DateTime: {
+            const QDateTime dateTime = value.toDateTime();
+            const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, pos, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::Time: {
+            const QTime time = value.toTime();
+            const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, pos, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::String: {
+            // lifetime of string == lifetime of its qvariant
+            const QString *str = static_cast<const QString*>(value.constData());
+            res = sqlite3_bind_text16(stmt, pos, str->utf16(),
+                                      (str->size()) * sizeof(QChar), SQLITE_STATIC);
+            break; }
+        default: {
+            QString str = value.toString();
+            // SQLITE_TRANSIENT makes sure that sqlite buffers the data
+            res = sqlite3_bind_text16(stmt, pos, str.utf16(),
+                                      (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
+            break; }
+        }
+    }
+    return res;
+}
+
 bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch)
 {
     Q_Q(QSQLiteResult);
@@ -282,6 +375,10 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
         if (rInf.isEmpty())
             // must be first call.
             initColumns(false);
+        // sqlite3_step() recompiles the statement if the schema changed
+        // since it was prepared, which may change the number of columns
+        if (initialFetch)
+            firstRow.resize(rInf.count());
         if (idx < 0 && !initialFetch)
             return true;
         for (i = 0; i < rInf.count(); ++i) {
@@ -386,6 +483,15 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    QSQLiteDriverPrivate *driverPrivate = const_cast<QSQLiteDriverPrivate *>(d->drv_d_func());
+    if (QSQLiteCachedStatement *cached = driverPrivate->statements.take(query)) {
+        d->stmt = cached->stmt;
+        d->stmtQuery = query;
+        cached->stmt = 0;
+        delete cached;
+        return true;
+    }
+
     const void *pzTail = NULL;
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -407,6 +513,7 @@ bool QSQLiteResult::prepare(const QString &query)
         d->finalize();
         return false;
     }
+    d->stmtQuery = query;
     return true;
 }
 
@@ -431,57 +538,7 @@ bool QSQLiteResult::exec()
     int paramCount = sqlite3_bind_parameter_count(d->stmt);
     if (paramCount == values.count()) {
         for (int i = 0; i < paramCount; ++i) {
-            res = SQLITE_OK;
-            const QVariant value = values.at(i);
-
-            if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
-            } else {
-                switch (value.type()) {
-                case QVariant::ByteArray: {
-                    const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
-                                            ba->size(), SQLITE_STATIC);
-                    break; }
-                case QVariant::Int:
-                case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
-                    break;
-                case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
-                    break;
-                case QVariant::UInt:
-                case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
-                    break;
-                case QVariant::DateTime: {
-                    const QDateTime dateTime = value.toDateTime();
-                    const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::Time: {
-                    const QTime time = value.toTime();
-                    const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::String: {
-                    // lifetime of string == lifetime of its qvariant
-                    const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
-                                              (str->size()) * sizeof(QChar), SQLITE_STATIC);
-                    break; }
-                default: {
-                    QString str = value.toString();
-                    // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
-                    break; }
-                }
-            }
+            res = d->bindValue(i + 1, values.at(i));
             if (res != SQLITE_OK) {
                 setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
@@ -505,6 +562,95 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+/*
+    Runs the prepared statement once per row of the bound value lists,
+    rebinding the same sqlite3_stmt in place. Unless a transaction is already
+    open, the rows are wrapped in one so that SQLite does not sync the journal
+    after every single row.
+*/
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_UNUSED(arrayBind);
+    Q_D(QSQLiteResult);
+    const QVector<QVariant> values = boundValues();
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+    setSelect(false);
+    setActive(false);
+
+    if (!d->stmt || values.isEmpty())
+        return false;
+
+    const int paramCount = sqlite3_bind_parameter_count(d->stmt);
+    QVector<QVariantList> columns;
+    columns.reserve(values.count());
+    for (const QVariant &value : values) {
+        columns.append(value.toList());
+        if (columns.last().count() != columns.first().count())
+            break;
+    }
+    if (paramCount != values.count() || columns.count() != values.count()
+        || columns.last().count() != columns.first().count()) {
+        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                        "Parameter count mismatch"), QString(), QSqlError::StatementError));
+        return false;
+    }
+
+    sqlite3 *access = d->drv_d_func()->access;
+    const int rows = columns.first().count();
+    const bool implicitTransaction = rows > 1 && sqlite3_get_autocommit(access);
+    int res = SQLITE_OK;
+    if (implicitTransaction) {
+        res = sqlite3_exec(access, "BEGIN", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to begin transaction"), QSqlError::TransactionError, res));
+            return false;
+        }
+    }
+
+    for (int row = 0; row < rows; ++row) {
+        res = sqlite3_reset(d->stmt);
+        for (int i = 0; res == SQLITE_OK && i < paramCount; ++i)
+            res = d->bindValue(i + 1, columns.at(i).at(row));
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to bind parameters"), QSqlError::StatementError, res));
+            break;
+        }
+        res = sqlite3_step(d->stmt);
+        if (res != SQLITE_DONE && res != SQLITE_ROW) {
+            // sqlite3_reset() reports the specific error of the failed step
+            res = sqlite3_reset(d->stmt);
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to execute statement"), QSqlError::StatementError, res));
+            break;
+        }
+        res = SQLITE_OK;
+    }
+    sqlite3_reset(d->stmt);
+
+    if (implicitTransaction) {
+        if (res == SQLITE_OK) {
+            res = sqlite3_exec(access, "COMMIT", 0, 0, 0);
+            if (res != SQLITE_OK)
+                setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                             "Unable to commit transaction"), QSqlError::TransactionError, res));
+        }
+        if (res != SQLITE_OK)
+            sqlite3_exec(access, "ROLLBACK", 0, 0, 0);
+    }
+    if (res != SQLITE_OK)
+        return false;
+
+    setActive(true);
+    return true;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     Q_D(QSQLiteResult);
@@ -589,10 +735,10 @@ bool QSQLiteDriver::hasFeature(DriverFeature f) const
     case FinishQuery:
     case LowPrecisionNumbers:
     case EventNotifications:
+    case BatchOperations:
         return true;
     case QuerySize:
     case NamedPlaceholders:
-    case BatchOperations:
     case MultipleResultSets:
     case CancelQuery:
         return false;
@@ -612,6 +758,7 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
 
     int timeOut = 5000;
+    int statementCacheSize = 32;
     bool sharedCache = false;
     bool openReadOnlyOption = false;
     bool openUriOption = false;
@@ -627,6 +774,14 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
                 if (ok)
                     timeOut = nt;
             }
+        } else if (option.startsWith(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE"))) {
+            option = option.mid(28).trimmed();
+            if (option.startsWith(QLatin1Char('='))) {
+                bool ok;
+                const int size = option.mid(1).trimmed().toInt(&ok);
+                if (ok)
+                    statementCacheSize = size;
+            }
         } else if (option == QLatin1String("QSQLITE_OPEN_READONLY")) {
             openReadOnlyOption = true;
         } else if (option == QLatin1String("QSQLITE_OPEN_URI")) {
@@ -644,6 +799,13 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
     if (sqlite3_open_v2(db.toUtf8().constData(), &d->access, openMode, NULL) == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
+#if (SQLITE_VERSION_NUMBER >= 3003011)
+        // only statements from sqlite3_prepare16_v2() are recompiled after schema changes
+        d->statements.setMaxCost(qMax(0, statementCacheSize));
+#else
+        Q_UNUSED(statementCacheSize);
+        d->statements.setMaxCost(0);
+#endif
         setOpen(true);
         setOpenError(false);
         return true;
@@ -666,6 +828,7 @@ void QSQLiteDriver::close()
     if (isOpen()) {
         for (QSQLiteResult *result : qAsConst(d->results))
             result->d_func()->finalize();
+        d->statements.clear();
 
         if (d->access && (d->notificationid.count() > 0)) {
             d->notificationid.clear();
@@ -0,0 +1,416 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlasyncresult.h"
+#include "private/qsqlasyncresult_p.h"
+
+#include "qsqldriver.h"
+#include "qsqlquery.h"
+#include <qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QSqlAsyncResult
+    \brief The QSqlAsyncResult class holds the outcome of a query executed
+    with QSqlDatabase::execAsync().
+    \since 5.9
+
+    \ingroup database
+    \inmodule QtSql
+
+    A QSqlAsyncResult is delivered through the QFuture returned by
+    QSqlDatabase::execAsync() once the query has run on one of the
+    connection's worker threads. Unlike QSqlQuery it is a plain value: all
+    rows of a \c SELECT statement have been fetched into it, and it can be
+    copied and passed between threads freely.
+
+    \sa QSqlDatabase::execAsync(), QSqlQuery
+*/
+
+/*!
+    Creates an empty, inactive result.
+*/
+QSqlAsyncResult::QSqlAsyncResult()
+    : d(new QSqlAsyncResultPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSqlAsyncResult::QSqlAsyncResult(const QSqlAsyncResult &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this result and returns a reference to it.
+*/
+QSqlAsyncResult &QSqlAsyncResult::operator=(const QSqlAsyncResult &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QSqlAsyncResult &QSqlAsyncResult::operator=(QSqlAsyncResult &&other)
+
+    Move-assigns \a other to this QSqlAsyncResult instance.
+*/
+
+/*!
+    \fn void QSqlAsyncResult::swap(QSqlAsyncResult &other)
+
+    Swaps this result with \a other. This function is very fast and never
+    fails.
+*/
+
+/*!
+    Destroys the result.
+*/
+QSqlAsyncResult::~QSqlAsyncResult()
+{
+}
+
+/*!
+    Returns \c true if the query was executed successfully; otherwise
+    returns \c false and lastError() describes the problem.
+
+    \sa QSqlQuery::isActive()
+*/
+bool QSqlAsyncResult::isActive() const
+{
+    return d->active;
+}
+
+/*!
+    Returns \c true if the query was a \c SELECT statement; otherwise
+    returns \c false.
+*/
+bool QSqlAsyncResult::isSelect() const
+{
+    return d->select;
+}
+
+/*!
+    Returns the error the query ended with, if any.
+*/
+QSqlError QSqlAsyncResult::lastError() const
+{
+    return d->error;
+}
+
+/*!
+    Returns the number of rows affected by a statement that is not a
+    \c SELECT, or -1 if it cannot be determined.
+
+    \sa QSqlQuery::numRowsAffected()
+*/
+int QSqlAsyncResult::numRowsAffected() const
+{
+    return d->rowsAffected;
+}
+
+/*!
+    Returns the object ID of the most recently inserted row, if the
+    statement was not a \c SELECT and the database supports it.
+
+    \sa QSqlQuery::lastInsertId()
+*/
+QVariant QSqlAsyncResult::lastInsertId() const
+{
+    return d->lastInsertId;
+}
+
+/*!
+    Returns the number of rows the query returned.
+*/
+int QSqlAsyncResult::size() const
+{
+    return d->rows;
+}
+
+/*!
+    Returns the fields of the rows the query returned, without values.
+*/
+QSqlRecord QSqlAsyncResult::record() const
+{
+    return d->record;
+}
+
+/*!
+    \overload
+
+    Returns the fields and values of \a row, which must be a valid row
+    index (0 <= \a row < size()).
+*/
+QSqlRecord QSqlAsyncResult::record(int row) const
+{
+    QSqlRecord rec = d->record;
+    if (row < 0 || row >= d->rows)
+        return rec;
+    const int columns = rec.count();
+    for (int i = 0; i < columns; ++i)
+        rec.setValue(i, d->values.at(row * columns + i));
+    return rec;
+}
+
+/*!
+    Returns the value of \a column in \a row, or an invalid QVariant if
+    either is out of range.
+*/
+QVariant QSqlAsyncResult::value(int row, int column) const
+{
+    const int columns = d->record.count();
+    if (row < 0 || row >= d->rows || column < 0 || column >= columns)
+        return QVariant();
+    return d->values.at(row * columns + column);
+}
+
+#ifndef QT_NO_QFUTURE
+
+class QSqlAsyncWorker : public QThread
+{
+public:
+    explicit QSqlAsyncWorker(QSqlAsyncPool *pool) : pool(pool) {}
+    void run() Q_DECL_OVERRIDE { pool->work(); }
+
+private:
+    QSqlAsyncPool *pool;
+};
+
+QSqlAsyncPool::QSqlAsyncPool(int maxConnections)
+    : maxConnections(qMax(1, maxConnections)),
+      runningWorkers(0),
+      idleWorkers(0),
+      stopping(false)
+{
+    settings.port = -1;
+    settings.precisionPolicy = QSql::LowPrecisionDouble;
+}
+
+/*
+    Queries that have not started yet are canceled, the running ones are
+    waited for.
+*/
+QSqlAsyncPool::~QSqlAsyncPool()
+{
+    QMutexLocker locker(&mutex);
+    stopping = true;
+    while (!jobs.isEmpty()) {
+        Job job = jobs.dequeue();
+        job.future.reportCanceled();
+        job.future.reportFinished();
+    }
+    jobAvailable.wakeAll();
+    locker.unlock();
+
+    for (QThread *worker : qAsConst(workers)) {
+        worker->wait();
+        delete worker;
+    }
+}
+
+void QSqlAsyncPool::setMaxConnectionCount(int count)
+{
+    QMutexLocker locker(&mutex);
+    maxConnections = qMax(1, count);
+    // surplus workers exit once they are idle
+    if (runningWorkers > maxConnections)
+        jobAvailable.wakeAll();
+}
+
+QFuture<QSqlAsyncResult> QSqlAsyncPool::enqueue(const QSqlDatabase &db, const QString &query,
+                                                const QVariantList &values)
+{
+    Job job;
+    job.query = query;
+    job.values = values;
+    job.future.reportStarted();
+    const QFuture<QSqlAsyncResult> future = job.future.future();
+
+    QMutexLocker locker(&mutex);
+    // connections opened from now on use the current settings
+    settings.driverName = db.driverName();
+    settings.databaseName = db.databaseName();
+    settings.userName = db.userName();
+    settings.password = db.password();
+    settings.hostName = db.hostName();
+    settings.connectOptions = db.connectOptions();
+    settings.port = db.port();
+    settings.precisionPolicy = db.numericalPrecisionPolicy();
+
+    jobs.enqueue(job);
+    if (jobs.size() > idleWorkers && runningWorkers < maxConnections) {
+        for (int i = workers.size() - 1; i >= 0; --i) {
+            if (workers.at(i)->isFinished())
+                delete workers.takeAt(i);
+        }
+        QThread *worker = new QSqlAsyncWorker(this);
+        workers.append(worker);
+        ++runningWorkers;
+        worker->start();
+    } else {
+        jobAvailable.wakeOne();
+    }
+    return future;
+}
+
+// a finished future for a query that could not be queued
+QFuture<QSqlAsyncResult> QSqlAsyncPool::failed(const QSqlError &error)
+{
+    QSqlAsyncResult result;
+    result.d->error = error;
+    QFutureInterface<QSqlAsyncResult> future;
+    future.reportStarted();
+    future.reportResult(result);
+    future.reportFinished();
+    return future.future();
+}
+
+// the body of the worker threads
+void QSqlAsyncPool::work()
+{
+    QSqlDatabase db;
+    QMutexLocker locker(&mutex);
+    forever {
+        while (jobs.isEmpty() && !stopping && runningWorkers <= maxConnections) {
+            ++idleWorkers;
+            jobAvailable.wait(&mutex);
+            --idleWorkers;
+        }
+        if (stopping)
+            break;
+        if (runningWorkers > maxConnections) {
+            // only the remaining workers take jobs, so that a single
+            // connection executes them in order again
+            if (!jobs.isEmpty())
+                jobAvailable.wakeOne();
+            break;
+        }
+
+        Job job = jobs.dequeue();
+        if (job.future.isCanceled()) {
+            job.future.reportFinished();
+            continue;
+        }
+        const Settings current = settings;
+        locker.unlock();
+
+        if (!db.isValid())
+            db = createConnection(current);
+        job.future.reportResult(execute(db, job));
+        job.future.reportFinished();
+
+        locker.relock();
+    }
+    --runningWorkers;
+    locker.unlock();
+    db.close();
+}
+
+QSqlDatabase QSqlAsyncPool::createConnection(const Settings &settings)
+{
+    // not registered with a connection name, see the class description
+    QSqlDatabase db(settings.driverName);
+    db.setDatabaseName(settings.databaseName);
+    db.setUserName(settings.userName);
+    db.setPassword(settings.password);
+    db.setHostName(settings.hostName);
+    db.setConnectOptions(settings.connectOptions);
+    db.setPort(settings.port);
+    db.setNumericalPrecisionPolicy(settings.precisionPolicy);
+    return db;
+}
+
+QSqlAsyncResult QSqlAsyncPool::execute(QSqlDatabase &db, const Job &job)
+{
+    QSqlAsyncResult result;
+    QSqlAsyncResultPrivate *d = result.d.data();
+    if (!db.isOpen() && !db.open()) {
+        d->error = db.lastError();
+        return result;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    bool ok;
+    if (job.values.isEmpty()) {
+        ok = query.exec(job.query);
+    } else {
+        ok = query.prepare(job.query);
+        if (ok) {
+            for (const QVariant &value : job.values)
+                query.addBindValue(value);
+            ok = query.exec();
+        }
+    }
+    d->error = query.lastError();
+    if (!ok)
+        return result;
+
+    d->active = true;
+    d->select = query.isSelect();
+    if (!d->select) {
+        d->rowsAffected = query.numRowsAffected();
+        if (db.driver()->hasFeature(QSqlDriver::LastInsertId))
+            d->lastInsertId = query.lastInsertId();
+        return result;
+    }
+
+    d->record = query.record();
+    const int columns = d->record.count();
+    if (query.size() > 0)
+        d->values.reserve(query.size() * columns);
+    while (query.next()) {
+        for (int i = 0; i < columns; ++i)
+            d->values.append(query.value(i));
+        ++d->rows;
+    }
+    if (query.lastError().isValid()) {
+        d->active = false;
+        d->error = query.lastError();
+    }
+    return result;
+}
+
+#endif // QT_NO_QFUTURE
+
+QT_END_NAMESPACE
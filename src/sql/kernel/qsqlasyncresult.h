@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLASYNCRESULT_H
+#define QSQLASYNCRESULT_H
+
+#include <QtSql/qtsqlglobal.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlError;
+class QSqlRecord;
+class QVariant;
+class QSqlAsyncResultPrivate;
+
+class Q_SQL_EXPORT QSqlAsyncResult
+{
+public:
+    QSqlAsyncResult();
+    QSqlAsyncResult(const QSqlAsyncResult &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QSqlAsyncResult &operator=(QSqlAsyncResult &&other) Q_DECL_NOTHROW { swap(other); return *this; }
+#endif
+    QSqlAsyncResult &operator=(const QSqlAsyncResult &other);
+    ~QSqlAsyncResult();
+
+    void swap(QSqlAsyncResult &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool isActive() const;
+    bool isSelect() const;
+    QSqlError lastError() const;
+    int numRowsAffected() const;
+    QVariant lastInsertId() const;
+
+    int size() const;
+    QSqlRecord record() const;
+    QSqlRecord record(int row) const;
+    QVariant value(int row, int column) const;
+
+private:
+    friend class QSqlAsyncPool;
+    QSharedDataPointer<QSqlAsyncResultPrivate> d;
+};
+
+Q_DECLARE_SHARED(QSqlAsyncResult)
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QSqlAsyncResult)
+
+#endif // QSQLASYNCRESULT_H
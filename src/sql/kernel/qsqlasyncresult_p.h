@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLASYNCRESULT_P_H
+#define QSQLASYNCRESULT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QSqlDatabase class.  This header file may change from version
+// to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtSql/private/qtsqlglobal_p.h>
+#include "QtSql/qsqlasyncresult.h"
+#include "QtSql/qsqldatabase.h"
+#include "QtSql/qsqlerror.h"
+#include "QtSql/qsqlrecord.h"
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qwaitcondition.h>
+
+QT_BEGIN_NAMESPACE
+
+class QThread;
+
+class QSqlAsyncResultPrivate : public QSharedData
+{
+public:
+    QSqlAsyncResultPrivate() : active(false), select(false), rowsAffected(-1), rows(0) {}
+
+    bool active;
+    bool select;
+    int rowsAffected;
+    int rows;
+    QSqlError error;
+    QVariant lastInsertId;
+    QSqlRecord record;
+    // the values of all rows, row after row
+    QVector<QVariant> values;
+};
+
+#ifndef QT_NO_QFUTURE
+
+/*
+    Runs the queries passed to QSqlDatabase::execAsync() for one connection.
+    Every worker thread of the pool opens its own connection with the
+    settings of the QSqlDatabase; these connections are not registered under
+    a connection name, so they cannot be reached through the QSqlDatabase
+    API and do not block removeDatabase().
+*/
+class QSqlAsyncPool
+{
+public:
+    explicit QSqlAsyncPool(int maxConnections);
+    ~QSqlAsyncPool();
+
+    QFuture<QSqlAsyncResult> enqueue(const QSqlDatabase &db, const QString &query,
+                                     const QVariantList &values);
+    void setMaxConnectionCount(int count);
+
+    static QFuture<QSqlAsyncResult> failed(const QSqlError &error);
+
+    void work();
+
+private:
+    struct Settings
+    {
+        QString driverName;
+        QString databaseName;
+        QString userName;
+        QString password;
+        QString hostName;
+        QString connectOptions;
+        int port;
+        QSql::NumericalPrecisionPolicy precisionPolicy;
+    };
+    struct Job
+    {
+        QString query;
+        QVariantList values;
+        QFutureInterface<QSqlAsyncResult> future;
+    };
+
+    static QSqlDatabase createConnection(const Settings &settings);
+    static QSqlAsyncResult execute(QSqlDatabase &db, const Job &job);
+
+    QMutex mutex;
+    QWaitCondition jobAvailable;
+    QQueue<Job> jobs;
+    QVector<QThread *> workers;
+    Settings settings;
+    int maxConnections;
+    int runningWorkers;
+    int idleWorkers;
+    bool stopping;
+};
+
+#endif // QT_NO_QFUTURE
+
+QT_END_NAMESPACE
+
+#endif // QSQLASYNCRESULT_P_H
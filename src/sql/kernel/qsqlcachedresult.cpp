@@ -56,13 +56,267 @@ QT_BEGIN_NAMESPACE
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   gotoNext() always fills in a single row starting at index 0. For
+   scrollable results the row is then moved into a column-wise cache (see
+   QSqlCachedColumn), which keeps integers, doubles, dates and times in
+   typed arrays and strings in a shared arena instead of one QVariant per
+   value.
 */
 
-static const uint initial_cache_size = 128;
+// characters per string arena chunk; longer strings get a chunk of their own
+static const int arena_chunk_size = 16384;
+
+static const qint64 msecs_per_day = 86400000;
+
+QSqlCachedColumn::QSqlCachedColumn()
+    : kind(Empty),
+      valueType(QVariant::Invalid),
+      nullType(QVariant::LastType),
+      timeSpec(Qt::LocalTime),
+      rows(0)
+{
+}
+
+void QSqlCachedColumn::clear()
+{
+    *this = QSqlCachedColumn();
+}
+
+QSqlCachedColumn::Kind QSqlCachedColumn::kindOf(const QVariant &value)
+{
+    switch (value.type()) {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+        return Integer;
+    case QVariant::Double:
+        return Real;
+    case QVariant::Date:
+        return Date;
+    case QVariant::Time:
+        return Time;
+    case QVariant::DateTime: {
+        const QDateTime dt = value.toDateTime();
+        if (dt.isValid() && dt.date().toJulianDay() >= 0
+            && (dt.timeSpec() == Qt::LocalTime || dt.timeSpec() == Qt::UTC))
+            return DateTime;
+        return Generic;
+    }
+    case QVariant::String:
+        return String;
+    default:
+        return Generic;
+    }
+}
+
+// whether a non-null value can be stored in the column's typed array
+bool QSqlCachedColumn::fits(const QVariant &value) const
+{
+    if (value.type() != valueType)
+        return false;
+    return kind != DateTime
+        || (kindOf(value) == DateTime && value.toDateTime().timeSpec() == timeSpec);
+}
+
+void QSqlCachedColumn::setKind(Kind k, const QVariant &value)
+{
+    kind = k;
+    valueType = value.type();
+    if (kind == DateTime)
+        timeSpec = value.toDateTime().timeSpec();
+    // the rows stored so far were all null
+    for (int i = 0; i < rows; ++i)
+        appendPlaceholder();
+}
+
+void QSqlCachedColumn::appendPlaceholder()
+{
+    switch (kind) {
+    case Empty:
+    case Generic:
+        break;
+    case Real:
+        reals.append(0);
+        break;
+    case String: {
+        const StringRef ref = { 0, 0, 0 };
+        strings.append(ref);
+        break;
+    }
+    default:
+        integers.append(0);
+        break;
+    }
+}
+
+void QSqlCachedColumn::appendValue(const QVariant &value)
+{
+    // the type was checked before, so the values can be read without
+    // going through QVariant's conversions
+    const void *data = value.constData();
+    switch (kind) {
+    case Integer:
+        switch (valueType) {
+        case QVariant::Bool:
+            integers.append(*static_cast<const bool *>(data));
+            break;
+        case QVariant::Int:
+            integers.append(*static_cast<const int *>(data));
+            break;
+        case QVariant::UInt:
+            integers.append(*static_cast<const uint *>(data));
+            break;
+        default:
+            // LongLong and ULongLong have the same representation
+            integers.append(*static_cast<const qint64 *>(data));
+            break;
+        }
+        break;
+    case Real:
+        reals.append(*static_cast<const double *>(data));
+        break;
+    case Date:
+        integers.append(static_cast<const QDate *>(data)->toJulianDay());
+        break;
+    case Time:
+        integers.append(static_cast<const QTime *>(data)->msecsSinceStartOfDay());
+        break;
+    case DateTime: {
+        const QDateTime *dt = static_cast<const QDateTime *>(data);
+        integers.append(dt->date().toJulianDay() * msecs_per_day
+                        + dt->time().msecsSinceStartOfDay());
+        break;
+    }
+    case String: {
+        const QString *str = static_cast<const QString *>(data);
+        if (arena.isEmpty() || arena.last().size() + str->size() > arena_chunk_size) {
+            arena.append(QString());
+            arena.last().reserve(qMax(arena_chunk_size, str->size()));
+        }
+        QString &chunk = arena.last();
+        const StringRef ref = { arena.size() - 1, chunk.size(), str->size() };
+        chunk.append(*str);
+        strings.append(ref);
+        break;
+    }
+    case Empty:
+    case Generic:
+        Q_UNREACHABLE();
+        break;
+    }
+}
+
+void QSqlCachedColumn::convertToGeneric()
+{
+    QVector<QVariant> values;
+    values.reserve(rows + 1);
+    for (int i = 0; i < rows; ++i)
+        values.append(at(i));
+    const int count = rows;
+    clear();
+    kind = Generic;
+    rows = count;
+    variants = values;
+}
+
+void QSqlCachedColumn::append(const QVariant &value)
+{
+    if (kind != Generic) {
+        if (value.isNull()) {
+            // QVariant::LastType marks that no null value was seen yet
+            if (nullType == QVariant::LastType)
+                nullType = value.type();
+            else if (value.type() != nullType)
+                convertToGeneric();
+        } else if (kind == Empty) {
+            const Kind k = kindOf(value);
+            if (k == Generic)
+                convertToGeneric();
+            else
+                setKind(k, value);
+        } else if (!fits(value)) {
+            convertToGeneric();
+        }
+    }
+
+    if (kind == Generic) {
+        variants.append(value);
+    } else {
+        if (nulls.size() * 32 <= rows)
+            nulls.append(0);
+        if (value.isNull()) {
+            nulls[rows / 32] |= 1u << (rows % 32);
+            appendPlaceholder();
+        } else {
+            appendValue(value);
+        }
+    }
+    ++rows;
+}
+
+bool QSqlCachedColumn::isNull(int row) const
+{
+    if (kind == Generic)
+        return variants.at(row).isNull();
+    return nulls.at(row / 32) & (1u << (row % 32));
+}
+
+QVariant QSqlCachedColumn::at(int row) const
+{
+    if (kind == Generic)
+        return variants.at(row);
+    if (isNull(row))
+        return QVariant(nullType);
+
+    switch (kind) {
+    case Integer: {
+        const qint64 v = integers.at(row);
+        switch (valueType) {
+        case QVariant::Bool:
+            return QVariant(v != 0);
+        case QVariant::Int:
+            return QVariant(int(v));
+        case QVariant::UInt:
+            return QVariant(uint(v));
+        case QVariant::ULongLong:
+            return QVariant(qulonglong(v));
+        default:
+            return QVariant(qlonglong(v));
+        }
+    }
+    case Real:
+        return QVariant(reals.at(row));
+    case Date:
+        return QVariant(QDate::fromJulianDay(integers.at(row)));
+    case Time:
+        return QVariant(QTime::fromMSecsSinceStartOfDay(int(integers.at(row))));
+    case DateTime: {
+        const qint64 v = integers.at(row);
+        return QVariant(QDateTime(QDate::fromJulianDay(v / msecs_per_day),
+                                  QTime::fromMSecsSinceStartOfDay(int(v % msecs_per_day)),
+                                  timeSpec));
+    }
+    case String: {
+        const StringRef &ref = strings.at(row);
+        if (ref.size == 0)
+            return QVariant(QString(QLatin1String("")));
+        return QVariant(QString(arena.at(ref.chunk).constData() + ref.offset, ref.size));
+    }
+    case Empty:
+    case Generic:
+        break;
+    }
+    return QVariant();
+}
+
+//////////////
 
 QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSqlDriver *drv)
     : QSqlResultPrivate(q, drv),
-      rowCacheEnd(0),
+      rowCount(0),
       colCount(0),
       atEnd(false)
 {
@@ -71,9 +325,10 @@ QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSql
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.clear();
     atEnd = false;
     colCount = 0;
-    rowCacheEnd = 0;
+    rowCount = 0;
 }
 
 void QSqlCachedResultPrivate::init(int count, bool fo)
@@ -82,45 +337,30 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     cleanup();
     forwardOnly = fo;
     colCount = count;
-    if (fo) {
-        cache.resize(count);
-        rowCacheEnd = count;
-    } else {
-        cache.resize(initial_cache_size * count);
-    }
+    cache.resize(count);
+    if (!fo)
+        columns.resize(count);
 }
 
-int QSqlCachedResultPrivate::nextIndex()
+void QSqlCachedResultPrivate::storeRow()
 {
-    if (forwardOnly)
-        return 0;
-    int newIdx = rowCacheEnd;
-    if (newIdx + colCount > cache.size())
-        cache.resize(qMin(cache.size() * 2, cache.size() + 10000));
-    rowCacheEnd += colCount;
-
-    return newIdx;
+    for (int i = 0; i < colCount; ++i)
+        columns[i].append(cache.at(i));
+    ++rowCount;
 }
 
 bool QSqlCachedResultPrivate::canSeek(int i) const
 {
     if (forwardOnly || i < 0)
         return false;
-    return rowCacheEnd >= (i + 1) * colCount;
-}
-
-void QSqlCachedResultPrivate::revertLast()
-{
-    if (forwardOnly)
-        return;
-    rowCacheEnd -= colCount;
+    return i < rowCount;
 }
 
 inline int QSqlCachedResultPrivate::cacheCount() const
 {
     Q_ASSERT(!forwardOnly);
     Q_ASSERT(colCount);
-    return rowCacheEnd / colCount;
+    return rowCount;
 }
 
 //////////////
@@ -161,7 +401,7 @@ bool QSqlCachedResult::fetch(int i)
         setAt(i);
         return true;
     }
-    if (d->rowCacheEnd > 0)
+    if (d->rowCount > 0)
         setAt(d->cacheCount());
     while (at() < i + 1) {
         if (!cacheNext()) {
@@ -227,21 +467,27 @@ bool QSqlCachedResult::fetchLast()
 QVariant QSqlCachedResult::data(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return QVariant();
+    if (d->forwardOnly)
+        return d->cache.at(i);
+    if (at() >= d->rowCount)
         return QVariant();
 
-    return d->cache.at(idx);
+    return d->columns.at(i).at(at());
 }
 
 bool QSqlCachedResult::isNull(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return true;
+    if (d->forwardOnly)
+        return d->cache.at(i).isNull();
+    if (at() >= d->rowCount)
         return true;
 
-    return d->cache.at(idx).isNull();
+    return d->columns.at(i).isNull(at());
 }
 
 void QSqlCachedResult::cleanup()
@@ -256,7 +502,9 @@ void QSqlCachedResult::clearValues()
 {
     Q_D(QSqlCachedResult);
     setAt(QSql::BeforeFirstRow);
-    d->rowCacheEnd = 0;
+    for (int i = 0; i < d->columns.count(); ++i)
+        d->columns[i].clear();
+    d->rowCount = 0;
     d->atEnd = false;
 }
 
@@ -266,15 +514,14 @@ bool QSqlCachedResult::cacheNext()
     if (d->atEnd)
         return false;
 
-    if(isForwardOnly()) {
-        d->cache.resize(d->colCount);
-    }
+    d->cache.resize(d->colCount);
 
-    if (!gotoNext(d->cache, d->nextIndex())) {
-        d->revertLast();
+    if (!gotoNext(d->cache, 0)) {
         d->atEnd = true;
         return false;
     }
+    if (!d->forwardOnly)
+        d->storeRow();
     setAt(at() + 1);
     return true;
 }
@@ -54,12 +54,11 @@
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
-class QVariant;
-template <typename T> class QVector;
-
 class QSqlCachedResultPrivate;
 
 class Q_SQL_EXPORT QSqlCachedResult: public QSqlResult
@@ -96,6 +95,50 @@ private:
     bool cacheNext();
 };
 
+// One column of the rows cached by a scrollable QSqlCachedResult. As long
+// as all values of the column have the same type, fixed-width types are kept
+// in a plain array and strings in a chunked character arena; QVariants are
+// only created when a value is read. Columns with mixed types fall back to
+// storing QVariants.
+class Q_SQL_EXPORT QSqlCachedColumn
+{
+public:
+    QSqlCachedColumn();
+
+    void append(const QVariant &value);
+    QVariant at(int row) const;
+    bool isNull(int row) const;
+    int count() const { return rows; }
+    void clear();
+
+    struct StringRef { int chunk; int offset; int size; };
+
+private:
+    enum Kind { Empty, Integer, Real, Date, Time, DateTime, String, Generic };
+
+    static Kind kindOf(const QVariant &value);
+    void setKind(Kind k, const QVariant &value);
+    void appendValue(const QVariant &value);
+    void appendPlaceholder();
+    void convertToGeneric();
+    bool fits(const QVariant &value) const;
+
+    Kind kind;
+    QVariant::Type valueType;
+    QVariant::Type nullType;
+    Qt::TimeSpec timeSpec;
+    int rows;
+    QVector<quint32> nulls;
+    QVector<qint64> integers;
+    QVector<double> reals;
+    QVector<StringRef> strings;
+    QVector<QString> arena;
+    QVector<QVariant> variants;
+};
+
+Q_DECLARE_TYPEINFO(QSqlCachedColumn::StringRef, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QSqlCachedColumn, Q_MOVABLE_TYPE);
+
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlCachedResult)
@@ -106,11 +149,12 @@ public:
     inline int cacheCount() const;
     void init(int count, bool fo);
     void cleanup();
-    int nextIndex();
-    void revertLast();
+    void storeRow();
 
+    // the row gotoNext() fills in; in forward-only mode the only row kept
     QSqlCachedResult::ValueCache cache;
-    int rowCacheEnd;
+    QVector<QSqlCachedColumn> columns;
+    int rowCount;
     int colCount;
     bool atEnd;
 };
@@ -48,8 +48,18 @@
 #include "qsqlindex.h"
 #include "private/qfactoryloader_p.h"
 #include "private/qsqlnulldriver_p.h"
+#ifndef QT_NO_QFUTURE
+#include "qsqlasyncresult.h"
+#include "private/qsqlasyncresult_p.h"
+#endif
 #include "qmutex.h"
 #include "qhash.h"
+#include "qelapsedtimer.h"
+#include "qsharedpointer.h"
+#include "qthread.h"
+#include "qtimer.h"
+#include "qvector.h"
+#include "qwaitcondition.h"
 #include <stdlib.h>
 
 QT_BEGIN_NAMESPACE
@@ -66,6 +76,70 @@ char *QSqlDatabase::defaultConnection = const_cast<char *>("qt_sql_default_conne
 
 typedef QHash<QString, QSqlDriverCreatorBase*> DriverDict;
 
+class QSqlConnectionPoolStatisticsPrivate : public QSharedData
+{
+public:
+    QSqlConnectionPoolStatisticsPrivate()
+        : connectionCount(0), idleCount(0), checkoutCount(0), waitCount(0), timeoutCount(0),
+          totalWaitTime(0), maxWaitTime(0)
+    {
+    }
+
+    int connectionCount;
+    int idleCount;
+    int checkoutCount;
+    int waitCount;
+    int timeoutCount;
+    qint64 totalWaitTime;
+    qint64 maxWaitTime;
+};
+
+/*
+    The connections handed out by QSqlDatabase::acquireConnection() for one
+    connection name. They are not registered in the connection dictionary;
+    each of them is used by a single thread between acquireConnection() and
+    releaseConnection(), and has no thread affinity while it is idle.
+*/
+class QSqlConnectionPool
+{
+public:
+    struct Connection
+    {
+        QSqlDatabase db;
+        QElapsedTimer idleTimer;
+    };
+
+    QSqlConnectionPool()
+        : minimum(0), maximum(10), idleTimeout(60000), opening(0), removed(false),
+          expiryPending(false), expiryTimer(0)
+    {
+    }
+    ~QSqlConnectionPool()
+    {
+        if (expiryTimer)
+            expiryTimer->deleteLater();
+    }
+
+    int size() const { return idle.size() + busy.size() + opening; }
+    void expireIdle(QVector<QSqlDatabase> *expired);
+    static void scheduleExpiry(const QSharedPointer<QSqlConnectionPool> &pool);
+
+    QMutex mutex;
+    QWaitCondition released;
+    QVector<Connection> idle;               // least recently used first
+    QVector<QSqlDatabase> busy;
+    QString healthCheck;
+    int minimum;
+    int maximum;
+    int idleTimeout;
+    int opening;
+    bool removed;
+    bool expiryPending;
+    // lives in the thread of the application object
+    QTimer *expiryTimer;
+    QSqlConnectionPoolStatisticsPrivate statistics;
+};
+
 class QConnectionDict: public QHash<QString, QSqlDatabase>
 {
 public:
@@ -81,6 +155,8 @@ public:
     }
 
     mutable QReadWriteLock lock;
+    // guarded by lock as well
+    QHash<QString, QSharedPointer<QSqlConnectionPool> > pools;
 };
 Q_GLOBAL_STATIC(QConnectionDict, dbDict)
 
@@ -91,7 +167,9 @@ public:
         ref(1),
         q(d),
         driver(dr),
-        port(-1)
+        port(-1),
+        asyncPool(0),
+        maxAsyncConnections(1)
     {
         precisionPolicy = QSql::LowPrecisionDouble;
     }
@@ -113,6 +191,12 @@ public:
     QString connOptions;
     QString connName;
     QSql::NumericalPrecisionPolicy precisionPolicy;
+    // worker threads serving execAsync(), created on first use
+    QMutex asyncMutex;
+    QSqlAsyncPool *asyncPool;
+    int maxAsyncConnections;
+    // set on connections owned by a QSqlConnectionPool
+    QWeakPointer<QSqlConnectionPool> pool;
 
     static QSqlDatabasePrivate *shared_null();
     static QSqlDatabase database(const QString& name, bool open);
@@ -121,9 +205,16 @@ public:
     static void invalidateDb(const QSqlDatabase &db, const QString &name, bool doWarn = true);
     static DriverDict &driverDict();
     static void cleanConnections();
+    static QSharedPointer<QSqlConnectionPool> connectionPool(const QString &name, bool create);
+    static void removeConnectionPool(const QString &name);
+    static bool isPoolable(const QSqlDatabase &db, const char *function);
+    static QSqlDatabase createPooledConnection(const QSqlDatabase &reference,
+                                               const QSharedPointer<QSqlConnectionPool> &pool);
+    static void fillConnectionPool(const QString &name, const QSharedPointer<QSqlConnectionPool> &pool);
 };
 
-QSqlDatabasePrivate::QSqlDatabasePrivate(const QSqlDatabasePrivate &other) : ref(1)
+QSqlDatabasePrivate::QSqlDatabasePrivate(const QSqlDatabasePrivate &other)
+    : ref(1), asyncPool(0)
 {
     q = other.q;
     dbname = other.dbname;
@@ -135,10 +226,14 @@ QSqlDatabasePrivate::QSqlDatabasePrivate(const QSqlDatabasePrivate &other) : ref
     connOptions = other.connOptions;
     driver = other.driver;
     precisionPolicy = other.precisionPolicy;
+    maxAsyncConnections = other.maxAsyncConnections;
 }
 
 QSqlDatabasePrivate::~QSqlDatabasePrivate()
 {
+#ifndef QT_NO_QFUTURE
+    delete asyncPool;
+#endif
     if (driver != shared_null()->driver)
         delete driver;
 }
@@ -155,6 +250,14 @@ void QSqlDatabasePrivate::cleanConnections()
         ++it;
     }
     dict->clear();
+
+    for (const QSharedPointer<QSqlConnectionPool> &pool : qAsConst(dict->pools)) {
+        QMutexLocker poolLocker(&pool->mutex);
+        pool->removed = true;
+        pool->idle.clear();
+        pool->released.wakeAll();
+    }
+    dict->pools.clear();
 }
 
 static bool qDriverDictInit = false;
@@ -203,6 +306,175 @@ void QSqlDatabasePrivate::removeDatabase(const QString &name)
         return;
 
     invalidateDb(dict->take(name), name);
+    locker.unlock();
+    removeConnectionPool(name);
+}
+
+QSharedPointer<QSqlConnectionPool> QSqlDatabasePrivate::connectionPool(const QString &name, bool create)
+{
+    QConnectionDict *dict = dbDict();
+    Q_ASSERT(dict);
+
+    dict->lock.lockForRead();
+    QSharedPointer<QSqlConnectionPool> pool = dict->pools.value(name);
+    dict->lock.unlock();
+    if (pool || !create)
+        return pool;
+
+    QWriteLocker locker(&dict->lock);
+    QSharedPointer<QSqlConnectionPool> &entry = dict->pools[name];
+    if (!entry)
+        entry = QSharedPointer<QSqlConnectionPool>::create();
+    return entry;
+}
+
+void QSqlDatabasePrivate::removeConnectionPool(const QString &name)
+{
+    QConnectionDict *dict = dbDict();
+    Q_ASSERT(dict);
+
+    dict->lock.lockForWrite();
+    const QSharedPointer<QSqlConnectionPool> pool = dict->pools.take(name);
+    dict->lock.unlock();
+    if (!pool)
+        return;
+
+    // connections that are checked out are closed when they are released
+    QVector<QSqlDatabase> connections;
+    QMutexLocker locker(&pool->mutex);
+    pool->removed = true;
+    for (const QSqlConnectionPool::Connection &connection : qAsConst(pool->idle))
+        connections.append(connection.db);
+    pool->idle.clear();
+    pool->released.wakeAll();
+    locker.unlock();
+    for (QSqlDatabase &db : connections)
+        db.close();
+}
+
+/*
+    The pooled connections create their own driver with the name of the
+    driver of \a db, which is impossible if it was added with a driver instance.
+*/
+bool QSqlDatabasePrivate::isPoolable(const QSqlDatabase &db, const char *function)
+{
+    if (!db.d->drvName.isEmpty())
+        return true;
+    qWarning("QSqlDatabase::%s: connection '%s' was added with a driver instance and cannot be pooled",
+             function, db.d->connName.toLocal8Bit().constData());
+    return false;
+}
+
+QSqlDatabase QSqlDatabasePrivate::createPooledConnection(const QSqlDatabase &reference,
+                                                         const QSharedPointer<QSqlConnectionPool> &pool)
+{
+    QSqlDatabase db(reference.d->drvName);
+    db.d->copy(reference.d);
+    db.d->pool = pool;
+    return db;
+}
+
+/*
+    Opens connections until \a pool, the pool of \a name, has its minimum size.
+    They are opened in the calling thread, and become idle connections.
+*/
+void QSqlDatabasePrivate::fillConnectionPool(const QString &name, const QSharedPointer<QSqlConnectionPool> &pool)
+{
+    const QSqlDatabase reference = database(name, false);
+    if (!reference.isValid() || !isPoolable(reference, "setConnectionPoolLimits"))
+        return;
+
+    QMutexLocker locker(&pool->mutex);
+    const int missing = pool->minimum - pool->size();
+    if (pool->removed || missing <= 0)
+        return;
+    pool->opening += missing;
+    locker.unlock();
+
+    QVector<QSqlDatabase> opened;
+    for (int i = 0; i < missing; ++i) {
+        QSqlDatabase db = createPooledConnection(reference, pool);
+        if (!db.open()) {
+            qWarning() << "QSqlDatabase::setConnectionPoolLimits: unable to open database:"
+                       << db.lastError().text();
+            break;
+        }
+        db.driver()->moveToThread(0);
+        opened.append(db);
+    }
+
+    locker.relock();
+    pool->opening -= missing;
+    if (pool->removed) {
+        locker.unlock();
+        for (QSqlDatabase &db : opened)
+            db.close();
+        return;
+    }
+    for (const QSqlDatabase &db : qAsConst(opened)) {
+        QSqlConnectionPool::Connection connection;
+        connection.db = db;
+        connection.idleTimer.start();
+        pool->idle.append(connection);
+    }
+    pool->released.wakeAll();
+    QSqlConnectionPool::scheduleExpiry(pool);
+}
+
+/*
+    Moves the connections that have been idle for longer than the idle timeout
+    to \a expired, as long as more than the minimum number are open. They are
+    closed by the caller once the mutex has been released.
+*/
+void QSqlConnectionPool::expireIdle(QVector<QSqlDatabase> *expired)
+{
+    if (idleTimeout < 0)
+        return;
+    while (!idle.isEmpty() && size() > minimum
+           && idle.first().idleTimer.hasExpired(idleTimeout)) {
+        expired->append(idle.takeFirst().db);
+    }
+}
+
+/*
+    Makes sure that the least recently used idle connection of \a pool is
+    closed once it expires, even if nobody uses the pool in the meantime. This
+    relies on the event loop of the application object's thread; without one,
+    idle connections are only closed by the next call on the pool. Must be
+    called with the mutex locked.
+*/
+void QSqlConnectionPool::scheduleExpiry(const QSharedPointer<QSqlConnectionPool> &pool)
+{
+    // the first idle connection is the next one to expire, so a pending
+    // expiry is never late
+    if (pool->expiryPending || pool->removed || pool->idleTimeout < 0 || pool->idle.isEmpty()
+        || pool->size() <= pool->minimum) {
+        return;
+    }
+    QCoreApplication *application = QCoreApplication::instance();
+    if (!application)
+        return;
+
+    if (!pool->expiryTimer) {
+        const QWeakPointer<QSqlConnectionPool> weakPool = pool;
+        pool->expiryTimer = new QTimer;
+        pool->expiryTimer->setSingleShot(true);
+        QObject::connect(pool->expiryTimer, &QTimer::timeout, [weakPool]() {
+            const QSharedPointer<QSqlConnectionPool> pool = weakPool.toStrongRef();
+            if (!pool)
+                return;
+            QVector<QSqlDatabase> expired;
+            QMutexLocker locker(&pool->mutex);
+            pool->expiryPending = false;
+            pool->expireIdle(&expired);
+            scheduleExpiry(pool);
+        });
+        pool->expiryTimer->moveToThread(application->thread());
+    }
+    const qint64 remaining = pool->idleTimeout - pool->idle.first().idleTimer.elapsed();
+    pool->expiryPending = true;
+    QMetaObject::invokeMethod(pool->expiryTimer, "start", Qt::QueuedConnection,
+                              Q_ARG(int, int(qBound<qint64>(0, remaining, INT_MAX))));
 }
 
 void QSqlDatabasePrivate::addDatabase(const QSqlDatabase &db, const QString &name)
@@ -1152,6 +1424,7 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li QSQLITE_OPEN_READONLY
     \li QSQLITE_OPEN_URI
     \li QSQLITE_ENABLE_SHARED_CACHE
+    \li QSQLITE_STATEMENT_CACHE_SIZE
     \endlist
 
     \li
@@ -1389,6 +1662,476 @@ QSql::NumericalPrecisionPolicy QSqlDatabase::numericalPrecisionPolicy() const
         return d->precisionPolicy;
 }
 
+/*!
+    \since 5.9
+    \threadsafe
+
+    Checks out a connection for the calling thread from the connection
+    pool of \a connectionName, and returns it open.
+
+    Each pool keeps connections that are set up like the connection
+    registered with addDatabase() under \a connectionName, but that are
+    separate from it. An idle connection is reused if there is one;
+    otherwise a new one is opened, unless the maximum number of
+    connections set with setConnectionPoolLimits() is already open. In
+    that case the call blocks until a connection is released, or until
+    \a timeout milliseconds have passed. If \a timeout is -1 (the
+    default), it waits indefinitely.
+
+    If a health check query has been set with
+    setConnectionPoolHealthCheck(), it is executed on every reused
+    connection, and the connection is reopened if it fails.
+
+    Every call checks out a different connection, so a thread can hold
+    several connections at once; it must not wait for more connections
+    than the maximum, though. A connection may only be used by the thread
+    that acquired it, and it must be released with releaseConnection()
+    before that thread finishes.
+
+    Returns an invalid connection if \a connectionName has not been added,
+    if it was added with a QSqlDriver instance, if the timeout expires or
+    if no connection could be opened.
+
+    \sa releaseConnection(), connectionPoolStatistics(), {Threads and the SQL Module}
+*/
+QSqlDatabase QSqlDatabase::acquireConnection(const QString &connectionName, int timeout)
+{
+    const QSqlDatabase reference = QSqlDatabasePrivate::database(connectionName, false);
+    if (!reference.isValid()) {
+        qWarning("QSqlDatabase::acquireConnection: no connection named '%s'",
+                 connectionName.toLocal8Bit().constData());
+        return QSqlDatabase();
+    }
+    if (!QSqlDatabasePrivate::isPoolable(reference, "acquireConnection"))
+        return QSqlDatabase();
+    const QSharedPointer<QSqlConnectionPool> pool = QSqlDatabasePrivate::connectionPool(connectionName, true);
+    QVector<QSqlDatabase> expired;
+    QSqlDatabase db;
+    bool reused = false;
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&pool->mutex);
+    bool waited = false;
+    forever {
+        if (pool->removed)
+            return QSqlDatabase();
+        pool->expireIdle(&expired);
+        if (!pool->idle.isEmpty()) {
+            db = pool->idle.takeLast().db;
+            reused = true;
+            break;
+        }
+        if (pool->size() < pool->maximum)
+            break;
+
+        waited = true;
+        if (timeout < 0) {
+            pool->released.wait(&pool->mutex);
+            continue;
+        }
+        const qint64 remaining = timeout - timer.elapsed();
+        if (remaining <= 0 || !pool->released.wait(&pool->mutex, remaining)) {
+            ++pool->statistics.timeoutCount;
+            locker.unlock();
+            qWarning("QSqlDatabase::acquireConnection: timed out waiting for a connection to '%s'",
+                     connectionName.toLocal8Bit().constData());
+            return QSqlDatabase();
+        }
+    }
+    ++pool->opening;
+    const QString healthCheck = pool->healthCheck;
+    locker.unlock();
+    expired.clear();
+
+    if (reused) {
+        db.driver()->moveToThread(QThread::currentThread());
+        if (db.isOpen() && !healthCheck.isEmpty()) {
+            QSqlQuery query(db);
+            if (!query.exec(healthCheck)) {
+                query.clear();
+                db.close();
+            }
+        }
+    } else {
+        db = QSqlDatabasePrivate::createPooledConnection(reference, pool);
+    }
+    if (!db.isOpen() && !db.open()) {
+        qWarning() << "QSqlDatabase::acquireConnection: unable to open database:" << db.lastError().text();
+        locker.relock();
+        --pool->opening;
+        pool->released.wakeOne();
+        return QSqlDatabase();
+    }
+
+    const qint64 waitTime = timer.nsecsElapsed() / 1000;
+    locker.relock();
+    --pool->opening;
+    if (pool->removed) {
+        locker.unlock();
+        db.close();
+        return QSqlDatabase();
+    }
+    pool->busy.append(db);
+    ++pool->statistics.checkoutCount;
+    if (waited)
+        ++pool->statistics.waitCount;
+    pool->statistics.totalWaitTime += waitTime;
+    pool->statistics.maxWaitTime = qMax(pool->statistics.maxWaitTime, waitTime);
+    return db;
+}
+
+/*!
+    \since 5.9
+    \threadsafe
+
+    Returns \a db, which must have been checked out with
+    acquireConnection(), to its pool. Queries using the connection should
+    be finished before.
+
+    \sa acquireConnection()
+*/
+void QSqlDatabase::releaseConnection(const QSqlDatabase &db)
+{
+    const QSharedPointer<QSqlConnectionPool> pool = db.d->pool.toStrongRef();
+    if (!pool) {
+        qWarning("QSqlDatabase::releaseConnection: connection was not acquired from a pool");
+        return;
+    }
+    QVector<QSqlDatabase> expired;
+    QMutexLocker locker(&pool->mutex);
+    int index = pool->busy.size() - 1;
+    while (index >= 0 && pool->busy.at(index).d != db.d)
+        --index;
+    if (index < 0) {
+        qWarning("QSqlDatabase::releaseConnection: connection is not checked out");
+        return;
+    }
+
+    QSqlConnectionPool::Connection connection;
+    connection.db = pool->busy.takeAt(index);
+    if (pool->removed) {
+        locker.unlock();
+        connection.db.close();
+        return;
+    }
+    connection.db.driver()->moveToThread(0);
+    connection.idleTimer.start();
+    pool->idle.append(connection);
+    pool->expireIdle(&expired);
+    pool->released.wakeOne();
+    QSqlConnectionPool::scheduleExpiry(pool);
+}
+
+/*!
+    \since 5.9
+    \threadsafe
+
+    Sets the number of connections the pool of \a connectionName keeps
+    open to at least \a minimum and at most \a maximum. If fewer than
+    \a minimum connections are open, the missing ones are opened by this
+    call, provided that \a connectionName has been added. Idle connections
+    are only closed after the idle timeout while more than \a minimum are
+    open, and acquireConnection() waits once \a maximum connections are
+    checked out. The defaults are 0 and 10.
+
+    \sa setConnectionPoolIdleTimeout(), acquireConnection()
+*/
+void QSqlDatabase::setConnectionPoolLimits(const QString &connectionName, int minimum, int maximum)
+{
+    const QSharedPointer<QSqlConnectionPool> pool = QSqlDatabasePrivate::connectionPool(connectionName, true);
+    {
+        QVector<QSqlDatabase> expired;
+        QMutexLocker locker(&pool->mutex);
+        pool->minimum = qMax(0, minimum);
+        pool->maximum = qMax(qMax(1, minimum), maximum);
+        pool->released.wakeAll();
+        pool->expireIdle(&expired);
+        QSqlConnectionPool::scheduleExpiry(pool);
+    }
+    QSqlDatabasePrivate::fillConnectionPool(connectionName, pool);
+}
+
+/*!
+    \since 5.9
+    \threadsafe
+
+    Sets the time after which idle connections of the pool of
+    \a connectionName are closed to \a msecs milliseconds. Connections
+    are never closed for being idle if \a msecs is -1. The default is one
+    minute.
+
+    Idle connections are closed by a timer in the thread of the
+    QCoreApplication object, and otherwise whenever the pool is used.
+
+    \sa setConnectionPoolLimits()
+*/
+void QSqlDatabase::setConnectionPoolIdleTimeout(const QString &connectionName, int msecs)
+{
+    const QSharedPointer<QSqlConnectionPool> pool = QSqlDatabasePrivate::connectionPool(connectionName, true);
+    QVector<QSqlDatabase> expired;
+    QMutexLocker locker(&pool->mutex);
+    pool->idleTimeout = msecs;
+    pool->expireIdle(&expired);
+    // the pending expiry may be too late now
+    pool->expiryPending = false;
+    QSqlConnectionPool::scheduleExpiry(pool);
+}
+
+/*!
+    \since 5.9
+    \threadsafe
+
+    Sets the statement acquireConnection() executes to verify that an
+    idle connection of the pool of \a connectionName is still usable to
+    \a query, for example \c{SELECT 1}. By default no statement is
+    executed, and only connections that have been closed are reopened.
+
+    \sa acquireConnection()
+*/
+void QSqlDatabase::setConnectionPoolHealthCheck(const QString &connectionName, const QString &query)
+{
+    const QSharedPointer<QSqlConnectionPool> pool = QSqlDatabasePrivate::connectionPool(connectionName, true);
+    QMutexLocker locker(&pool->mutex);
+    pool->healthCheck = query;
+}
+
+/*!
+    \since 5.9
+    \threadsafe
+
+    Returns the usage statistics of the pool of \a connectionName.
+
+    \sa acquireConnection()
+*/
+QSqlConnectionPoolStatistics QSqlDatabase::connectionPoolStatistics(const QString &connectionName)
+{
+    QSqlConnectionPoolStatistics statistics;
+    const QSharedPointer<QSqlConnectionPool> pool = QSqlDatabasePrivate::connectionPool(connectionName, false);
+    if (!pool)
+        return statistics;
+    QVector<QSqlDatabase> expired;
+    QMutexLocker locker(&pool->mutex);
+    pool->expireIdle(&expired);
+    statistics.d = new QSqlConnectionPoolStatisticsPrivate(pool->statistics);
+    statistics.d->idleCount = pool->idle.size();
+    statistics.d->connectionCount = pool->idle.size() + pool->busy.size();
+    return statistics;
+}
+
+/*!
+    \class QSqlConnectionPoolStatistics
+    \brief The QSqlConnectionPoolStatistics class holds the usage statistics
+    of a connection pool.
+    \since 5.9
+
+    \ingroup database
+    \inmodule QtSql
+
+    \sa QSqlDatabase::connectionPoolStatistics()
+*/
+
+/*!
+    Creates statistics of an unused pool.
+*/
+QSqlConnectionPoolStatistics::QSqlConnectionPoolStatistics()
+    : d(new QSqlConnectionPoolStatisticsPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSqlConnectionPoolStatistics::QSqlConnectionPoolStatistics(const QSqlConnectionPoolStatistics &other)
+    : d(other.d)
+{
+}
+
+/*!
+    \fn QSqlConnectionPoolStatistics &QSqlConnectionPoolStatistics::operator=(QSqlConnectionPoolStatistics &&other)
+
+    Move-assigns \a other to this QSqlConnectionPoolStatistics instance.
+*/
+
+/*!
+    Assigns \a other to these statistics and returns a reference to them.
+*/
+QSqlConnectionPoolStatistics &QSqlConnectionPoolStatistics::operator=(const QSqlConnectionPoolStatistics &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the statistics.
+*/
+QSqlConnectionPoolStatistics::~QSqlConnectionPoolStatistics()
+{
+}
+
+/*!
+    \fn void QSqlConnectionPoolStatistics::swap(QSqlConnectionPoolStatistics &other)
+
+    Swaps these statistics with \a other. This function is very fast and
+    never fails.
+*/
+
+/*!
+    Returns the number of open connections, idle or checked out.
+*/
+int QSqlConnectionPoolStatistics::connectionCount() const
+{
+    return d->connectionCount;
+}
+
+/*!
+    Returns the number of idle connections.
+*/
+int QSqlConnectionPoolStatistics::idleCount() const
+{
+    return d->idleCount;
+}
+
+/*!
+    Returns the number of connections handed out by
+    QSqlDatabase::acquireConnection().
+*/
+int QSqlConnectionPoolStatistics::checkoutCount() const
+{
+    return d->checkoutCount;
+}
+
+/*!
+    Returns how many of the connections handed out had to wait for
+    another one to be released.
+*/
+int QSqlConnectionPoolStatistics::waitCount() const
+{
+    return d->waitCount;
+}
+
+/*!
+    Returns the number of QSqlDatabase::acquireConnection() calls that
+    timed out.
+*/
+int QSqlConnectionPoolStatistics::timeoutCount() const
+{
+    return d->timeoutCount;
+}
+
+/*!
+    Returns the total time in microseconds QSqlDatabase::acquireConnection()
+    took to hand out connections, including opening them or running the
+    health check.
+
+    \sa maxWaitTime()
+*/
+qint64 QSqlConnectionPoolStatistics::totalWaitTime() const
+{
+    return d->totalWaitTime;
+}
+
+/*!
+    Returns the longest time in microseconds QSqlDatabase::acquireConnection()
+    took to hand out a connection.
+
+    \sa totalWaitTime()
+*/
+qint64 QSqlConnectionPoolStatistics::maxWaitTime() const
+{
+    return d->maxWaitTime;
+}
+
+#ifndef QT_NO_QFUTURE
+/*!
+    \since 5.9
+
+    Executes the SQL statement \a query in the background and returns a
+    QFuture that reports the outcome as a QSqlAsyncResult. The calling
+    thread is not blocked; use a QFutureWatcher to be notified when the
+    result is available, or QFuture::result() to wait for it. If the
+    connection is not valid, the future has already finished, with a
+    result that holds the error.
+
+    The statement does not run on this connection, but on one of up to
+    maxAsyncConnectionCount() connections that are opened with the same
+    settings (driver, database name, host name, user name, password,
+    port, connect options and precision policy) in dedicated worker
+    threads. Statements are queued and handed to the first idle worker,
+    so with the default of a single connection they run in the order in
+    which they were queued. The workers keep their connections open
+    until this connection and all of its copies have been destroyed, at
+    which point statements that have not started yet are canceled.
+
+    Since the statements run on separate connections, they do not see
+    uncommitted changes made through this connection, and an in-memory
+    SQLite database (\c{:memory:}) is a different, empty database for
+    every worker. Connections added with a custom QSqlDriver instance
+    cannot be used, as the workers cannot create such a driver.
+
+    \sa exec(), setMaxAsyncConnectionCount(), QSqlAsyncResult
+*/
+QFuture<QSqlAsyncResult> QSqlDatabase::execAsync(const QString &query) const
+{
+    return execAsync(query, QVariantList());
+}
+
+/*!
+    \since 5.9
+    \overload
+
+    Prepares \a query, binds \a values to its positional placeholders
+    in order and executes it in the background.
+
+    \sa QSqlQuery::addBindValue()
+*/
+QFuture<QSqlAsyncResult> QSqlDatabase::execAsync(const QString &query, const QVariantList &values) const
+{
+    if (!isValid())
+        return QSqlAsyncPool::failed(lastError());
+
+    QMutexLocker locker(&d->asyncMutex);
+    if (!d->asyncPool)
+        d->asyncPool = new QSqlAsyncPool(d->maxAsyncConnections);
+    return d->asyncPool->enqueue(*this, query, values);
+}
+
+/*!
+    \since 5.9
+
+    Sets the maximum number of connections, each with its own worker
+    thread, that execAsync() opens to \a count. Connections are only
+    opened when there are more queued statements than idle workers.
+    When the count is lowered, surplus connections are closed as soon as
+    their worker threads become idle. This function does nothing if the
+    connection is not valid.
+
+    \sa maxAsyncConnectionCount()
+*/
+void QSqlDatabase::setMaxAsyncConnectionCount(int count)
+{
+    if (!isValid())
+        return;
+
+    QMutexLocker locker(&d->asyncMutex);
+    d->maxAsyncConnections = qMax(1, count);
+    if (d->asyncPool)
+        d->asyncPool->setMaxConnectionCount(d->maxAsyncConnections);
+}
+
+/*!
+    \since 5.9
+
+    Returns the maximum number of connections used by execAsync(). The
+    default is 1.
+
+    \sa setMaxAsyncConnectionCount()
+*/
+int QSqlDatabase::maxAsyncConnectionCount() const
+{
+    return d->maxAsyncConnections;
+}
+#endif // QT_NO_QFUTURE
 
 #ifndef QT_NO_DEBUG_STREAM
 QDebug operator<<(QDebug dbg, const QSqlDatabase &d)
@@ -42,9 +42,12 @@
 
 #include <QtSql/qtsqlglobal.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qcontainerfwd.h>
+#include <QtCore/qshareddata.h>
 
 QT_BEGIN_NAMESPACE
 
+template <typename T> class QFuture;
 
 class QSqlError;
 class QSqlDriver;
@@ -52,6 +55,9 @@ class QSqlIndex;
 class QSqlRecord;
 class QSqlQuery;
 class QSqlDatabasePrivate;
+class QSqlConnectionPoolStatisticsPrivate;
+class QSqlAsyncResult;
+class QVariant;
 
 class Q_SQL_EXPORT QSqlDriverCreatorBase
 {
@@ -67,6 +73,35 @@ public:
     QSqlDriver *createObject() const Q_DECL_OVERRIDE { return new T; }
 };
 
+class Q_SQL_EXPORT QSqlConnectionPoolStatistics
+{
+public:
+    QSqlConnectionPoolStatistics();
+    QSqlConnectionPoolStatistics(const QSqlConnectionPoolStatistics &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QSqlConnectionPoolStatistics &operator=(QSqlConnectionPoolStatistics &&other) Q_DECL_NOTHROW
+    { swap(other); return *this; }
+#endif
+    QSqlConnectionPoolStatistics &operator=(const QSqlConnectionPoolStatistics &other);
+    ~QSqlConnectionPoolStatistics();
+
+    void swap(QSqlConnectionPoolStatistics &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    int connectionCount() const;
+    int idleCount() const;
+    int checkoutCount() const;
+    int waitCount() const;
+    int timeoutCount() const;
+    qint64 totalWaitTime() const;
+    qint64 maxWaitTime() const;
+
+private:
+    friend class QSqlDatabase;
+    QSharedDataPointer<QSqlConnectionPoolStatisticsPrivate> d;
+};
+
+Q_DECLARE_SHARED(QSqlConnectionPoolStatistics)
+
 class Q_SQL_EXPORT QSqlDatabase
 {
 public:
@@ -111,6 +146,13 @@ public:
 
     QSqlDriver* driver() const;
 
+#ifndef QT_NO_QFUTURE
+    QFuture<QSqlAsyncResult> execAsync(const QString &query) const;
+    QFuture<QSqlAsyncResult> execAsync(const QString &query, const QList<QVariant> &values) const;
+    void setMaxAsyncConnectionCount(int count);
+    int maxAsyncConnectionCount() const;
+#endif
+
     static
 #if !defined(Q_CC_MSVC) || _MSC_VER >= 1900
     // ### Qt6: remove the #ifdef
@@ -132,12 +174,21 @@ public:
     static void registerSqlDriver(const QString &name, QSqlDriverCreatorBase *creator);
     static bool isDriverAvailable(const QString &name);
 
+    static QSqlDatabase acquireConnection(const QString &connectionName = QLatin1String(defaultConnection),
+                                          int timeout = -1);
+    static void releaseConnection(const QSqlDatabase &db);
+    static void setConnectionPoolLimits(const QString &connectionName, int minimum, int maximum);
+    static void setConnectionPoolIdleTimeout(const QString &connectionName, int msecs);
+    static void setConnectionPoolHealthCheck(const QString &connectionName, const QString &query);
+    static QSqlConnectionPoolStatistics connectionPoolStatistics(const QString &connectionName = QLatin1String(defaultConnection));
+
 protected:
     explicit QSqlDatabase(const QString& type);
     explicit QSqlDatabase(QSqlDriver* driver);
 
 private:
     friend class QSqlDatabasePrivate;
+    friend class QSqlAsyncPool;
     QSqlDatabasePrivate *d;
 };
 
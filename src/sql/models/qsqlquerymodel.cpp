@@ -40,14 +40,158 @@
 #include "qsqlquerymodel.h"
 #include "qsqlquerymodel_p.h"
 
+#include <qcoreapplication.h>
 #include <qdebug.h>
+#include <qmutex.h>
+#include <qqueue.h>
 #include <qsqldriver.h>
 #include <qsqlfield.h>
+#include <qthread.h>
+#include <qwaitcondition.h>
 
 QT_BEGIN_NAMESPACE
 
 #define QSQL_PREFETCH 255
 
+static QEvent::Type rowsFetchedEventType()
+{
+    static const int type = QEvent::registerEventType();
+    return QEvent::Type(type);
+}
+
+/*
+    Executes the query of a model that fetches in the background on a
+    connection of its own, and hands the rows over to the model in batches.
+    The rows are delivered by an event to this object, which lives in the
+    model's thread. The fetcher reads at most one batch more than the model
+    has requested, and otherwise waits with the query open, so that a large
+    result is only read as far as it is looked at. A canceled fetcher is not
+    waited for; it deletes itself once the query it is running returns.
+*/
+class QSqlQueryModelFetcher : public QThread
+{
+public:
+    QSqlQueryModelFetcher(QSqlQueryModelPrivate *d, const QString &query,
+                          const QString &connectionName, int batchSize)
+        : connectionName(connectionName), d(d), requested(batchSize), finished(false),
+          notified(false), query(query), batchSize(batchSize)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE;
+    bool event(QEvent *e) Q_DECL_OVERRIDE;
+
+    const QString connectionName;
+    QAtomicInt canceled;
+    QSqlQueryModelPrivate *d;
+
+    // guarded by mutex
+    QMutex mutex;
+    QWaitCondition rowsRequested;
+    int requested; // rows the model wants, including those it has
+    QSqlRecord record;
+    QQueue<QVector<QVariant> > batches;
+    QSqlError error;
+    bool finished;
+    bool notified;
+
+private:
+    void fetch();
+    void deliver(QVector<QVariant> *batch, bool last, const QSqlError &lastError);
+
+    const QString query;
+    const int batchSize;
+};
+
+void QSqlQueryModelFetcher::run()
+{
+    fetch();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void QSqlQueryModelFetcher::fetch()
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.open()) {
+        QVector<QVariant> none;
+        deliver(&none, true, db.lastError());
+        return;
+    }
+    {
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        if (!q.exec(query)) {
+            QVector<QVariant> none;
+            deliver(&none, true, q.lastError());
+        } else {
+            const QSqlRecord rec = q.record();
+            mutex.lock();
+            record = rec;
+            mutex.unlock();
+
+            const int columns = rec.count();
+            int delivered = 0;
+            QVector<QVariant> batch;
+            batch.reserve(batchSize * columns);
+            while (!canceled.load()) {
+                const bool more = q.next();
+                if (more) {
+                    for (int i = 0; i < columns; ++i)
+                        batch.append(q.value(i));
+                }
+                if (!more || batch.size() >= batchSize * columns) {
+                    deliver(&batch, !more, q.lastError());
+                    if (!more)
+                        break;
+                    delivered += batchSize;
+
+                    QMutexLocker locker(&mutex);
+                    while (!canceled.load() && delivered >= requested + batchSize)
+                        rowsRequested.wait(&mutex);
+                }
+            }
+        }
+    }
+    db.close();
+}
+
+void QSqlQueryModelFetcher::deliver(QVector<QVariant> *batch, bool last, const QSqlError &lastError)
+{
+    QMutexLocker locker(&mutex);
+    if (!batch->isEmpty()) {
+        batches.enqueue(QVector<QVariant>());
+        batches.last().swap(*batch);
+    }
+    if (last) {
+        finished = true;
+        error = lastError;
+    }
+    if (!notified) {
+        notified = true;
+        QCoreApplication::postEvent(this, new QEvent(rowsFetchedEventType()));
+    }
+}
+
+bool QSqlQueryModelFetcher::event(QEvent *e)
+{
+    if (e->type() == rowsFetchedEventType()) {
+        if (d)
+            d->takeFetchedRows();
+        return true;
+    }
+    return QThread::event(e);
+}
+
+QSqlQueryModelPrivate::QSqlQueryModelPrivate()
+    : atEnd(false),
+      nestedResetLevel(0),
+      batchSize(QSQL_PREFETCH),
+      backgroundFetch(false),
+      fetchedColumns(0),
+      fetcher(0)
+{
+}
+
 void QSqlQueryModelPrivate::prefetch(int limit)
 {
     Q_Q(QSqlQueryModel);
@@ -87,6 +231,106 @@ QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
 
+void QSqlQueryModelPrivate::startFetch(const QString &query, const QSqlDatabase &db)
+{
+    static QBasicAtomicInt connectionId = Q_BASIC_ATOMIC_INITIALIZER(0);
+    const QString name = QLatin1String("qt_sql_model_fetch_")
+            + QString::number(connectionId.fetchAndAddRelaxed(1));
+
+    const QSqlDatabase clone = QSqlDatabase::cloneDatabase(db, name);
+    fetcher = new QSqlQueryModelFetcher(this, query, name, batchSize);
+    clone.driver()->moveToThread(fetcher);
+    atEnd = false;
+    fetcher->start();
+}
+
+void QSqlQueryModelPrivate::stopFetch()
+{
+    if (!fetcher)
+        return;
+
+    // don't block on a query that is still executing: the fetcher checks
+    // the flag between rows, removes its connection and is deleted when
+    // its thread has finished
+    fetcher->canceled.store(1);
+    fetcher->mutex.lock();
+    fetcher->rowsRequested.wakeAll();
+    fetcher->mutex.unlock();
+    // we may be called from the fetcher's own event handler
+    fetcher->d = 0;
+    QObject::connect(fetcher, &QThread::finished, fetcher, &QObject::deleteLater);
+    if (fetcher->isFinished())
+        fetcher->deleteLater();
+    fetcher = 0;
+}
+
+/*
+    Asks the background fetcher for another batch of rows beyond those the
+    model has, and inserts it if it has already been read.
+*/
+void QSqlQueryModelPrivate::requestFetchedRows()
+{
+    fetcher->mutex.lock();
+    fetcher->requested = qMax(fetcher->requested, bottom.row() + 1 + batchSize);
+    fetcher->rowsRequested.wakeAll();
+    fetcher->mutex.unlock();
+    takeFetchedRows();
+}
+
+/*
+    Moves the next batch of rows the background fetcher has read into the
+    model, if the model has requested it. If more requested rows are
+    pending, another event is posted for them, so that the event loop gets
+    to run between batches.
+*/
+void QSqlQueryModelPrivate::takeFetchedRows()
+{
+    Q_Q(QSqlQueryModel);
+    if (!fetcher)
+        return;
+
+    QMutexLocker locker(&fetcher->mutex);
+    const QSqlRecord newRec = fetcher->record;
+    QVector<QVariant> values;
+    int rows = bottom.row() + 1;
+    if (rows < fetcher->requested && !fetcher->batches.isEmpty()) {
+        values = fetcher->batches.dequeue();
+        rows += values.size() / newRec.count();
+    }
+    const bool finished = fetcher->finished && fetcher->batches.isEmpty();
+    const QSqlError fetchError = fetcher->error;
+    fetcher->notified = rows < fetcher->requested && !fetcher->batches.isEmpty();
+    if (fetcher->notified)
+        QCoreApplication::postEvent(fetcher, new QEvent(rowsFetchedEventType()));
+    locker.unlock();
+
+    if (rec.isEmpty() && !newRec.isEmpty()) {
+        q->beginInsertColumns(QModelIndex(), 0, newRec.count() - 1);
+        rec = newRec;
+        fetchedColumns = newRec.count();
+        initColOffsets(rec.count());
+        bottom = q->createIndex(-1, rec.count() - 1);
+        q->endInsertColumns();
+    }
+    if (!values.isEmpty() && fetchedColumns > 0) {
+        const int first = bottom.row() + 1;
+        const int last = first + values.size() / fetchedColumns - 1;
+        q->beginInsertRows(QModelIndex(), first, last);
+        if (fetchedValues.isEmpty())
+            fetchedValues.swap(values);
+        else
+            fetchedValues += values;
+        bottom = q->createIndex(last, bottom.column());
+        q->endInsertRows();
+    }
+    if (finished) {
+        if (fetchError.isValid())
+            error = fetchError;
+        atEnd = true;
+        stopFetch();
+    }
+}
+
 void QSqlQueryModelPrivate::initColOffsets(int size)
 {
     colOffsets.resize(size);
@@ -144,6 +388,38 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
     a query, the model will fetch rows incrementally.
     See fetchMore() for more information.
 
+    \section1 Fetching in the Background
+
+    For large results, the rows can also be fetched on a separate thread,
+    so that executing the query and reading the rows never blocks the
+    thread the model lives in. When setBackgroundFetchEnabled() has been
+    called, setQuery() with a query string opens a copy of the given
+    connection on a worker thread, executes the query there and returns
+    immediately with an empty model. The columns are inserted once the
+    query has been executed, and the rows are inserted in batches of
+    fetchBatchSize() rows; views update themselves through the usual
+    rowsInserted() signals.
+
+    Only the first batch is inserted on its own. Each further batch is
+    inserted when fetchMore() is called, as views do when they are
+    scrolled to the last row, and the worker thread reads at most one
+    batch ahead of that; otherwise it waits with the query open. So a
+    large result is only read as far as it is looked at. canFetchMore()
+    returns \c true until the last row has been inserted; fetchMore()
+    never waits for the worker thread, the requested batch is inserted
+    once it has been read.
+
+    The rows are kept in the model, so query() does not give access to
+    them. Rows are never dropped from the model again: everything that
+    has been fetched stays in memory until the next setQuery() or clear(),
+    so reading a whole result, for example by calling fetchMore() until
+    canFetchMore() returns \c false, holds all of its rows in memory.
+
+    Setting a new query, calling clear() or destroying the model stops a
+    fetch that is still in progress without waiting for it; a query that
+    is still executing on the worker thread runs to completion there, and
+    its rows are discarded.
+
     \sa QSqlTableModel, QSqlRelationalTableModel, QSqlQuery,
         {Model/View Programming}, {Query Model Example}
 */
@@ -170,6 +446,8 @@ QSqlQueryModel::QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent)
 */
 QSqlQueryModel::~QSqlQueryModel()
 {
+    Q_D(QSqlQueryModel);
+    d->stopFetch();
 }
 
 /*!
@@ -185,14 +463,24 @@ QSqlQueryModel::~QSqlQueryModel()
 
     \a parent should always be an invalid QModelIndex.
 
-    \sa canFetchMore()
+    While rows are fetched in the background, this function requests the
+    next batch of rows from the fetching thread without waiting for it.
+    The batch is inserted right away if it has already been read, and
+    otherwise when control returns to the event loop after it has been
+    read.
+
+    \sa canFetchMore(), setFetchBatchSize(), setBackgroundFetchEnabled()
 */
 void QSqlQueryModel::fetchMore(const QModelIndex &parent)
 {
     Q_D(QSqlQueryModel);
     if (parent.isValid())
         return;
-    d->prefetch(qMax(d->bottom.row(), 0) + QSQL_PREFETCH);
+    if (d->fetcher) {
+        d->requestFetchedRows();
+        return;
+    }
+    d->prefetch(qMax(d->bottom.row(), 0) + d->batchSize);
 }
 
 /*!
@@ -212,6 +500,67 @@ bool QSqlQueryModel::canFetchMore(const QModelIndex &parent) const
     return (!parent.isValid() && !d->atEnd);
 }
 
+/*!
+    \since 5.9
+
+    Sets the number of rows fetchMore() reads at a time, and the number of
+    rows a background fetch inserts at a time and reads ahead, to \a size.
+    The default is 255.
+
+    \sa fetchBatchSize(), fetchMore()
+*/
+void QSqlQueryModel::setFetchBatchSize(int size)
+{
+    Q_D(QSqlQueryModel);
+    d->batchSize = qMax(1, size);
+}
+
+/*!
+    \since 5.9
+
+    Returns the number of rows fetched at a time.
+
+    \sa setFetchBatchSize()
+*/
+int QSqlQueryModel::fetchBatchSize() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->batchSize;
+}
+
+/*!
+    \since 5.9
+
+    If \a enable is true, queries passed to setQuery() as a string are
+    executed and fetched on a worker thread from then on; otherwise they
+    are executed on the calling thread. The default is \c false.
+
+    The worker thread uses its own copy of the connection, so the query
+    does not see uncommitted changes made through the connection, and
+    it cannot be used with an in-memory SQLite database.
+
+    \sa isBackgroundFetchEnabled(), {Fetching in the Background}
+*/
+void QSqlQueryModel::setBackgroundFetchEnabled(bool enable)
+{
+    Q_D(QSqlQueryModel);
+    d->backgroundFetch = enable;
+}
+
+/*!
+    \since 5.9
+
+    Returns \c true if queries set as a string are fetched in the
+    background.
+
+    \sa setBackgroundFetchEnabled()
+*/
+bool QSqlQueryModel::isBackgroundFetchEnabled() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->backgroundFetch;
+}
+
 /*! \internal
  */
 void QSqlQueryModel::beginInsertRows(const QModelIndex &parent, int first, int last)
@@ -351,6 +700,12 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+    if (d->fetchedColumns > 0) {
+        if (dItem.row() < 0 || dItem.row() > d->bottom.row()
+            || dItem.column() < 0 || dItem.column() >= d->fetchedColumns)
+            return v;
+        return d->fetchedValues.at(dItem.row() * d->fetchedColumns + dItem.column());
+    }
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -411,6 +766,10 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     Q_D(QSqlQueryModel);
     beginResetModel();
 
+    d->stopFetch();
+    d->fetchedValues.clear();
+    d->fetchedColumns = 0;
+
     QSqlRecord newRec = query.record();
     bool columnsChanged = (newRec != d->rec);
 
@@ -461,14 +820,37 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     lastError() can be used to retrieve verbose information if there
     was an error setting the query.
 
+    If background fetching is enabled, the query is executed on a worker
+    thread, and errors are only reported by lastError() once the fetch
+    has ended.
+
     Example:
     \snippet code/src_sql_models_qsqlquerymodel.cpp 1
 
-    \sa query(), queryChange(), lastError()
+    \sa query(), queryChange(), lastError(), setBackgroundFetchEnabled()
 */
 void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
 {
-    setQuery(QSqlQuery(query, db));
+    Q_D(QSqlQueryModel);
+    const QSqlDatabase source = db.isValid()
+            ? db : QSqlDatabase::database(QLatin1String(QSqlDatabase::defaultConnection), false);
+    if (!d->backgroundFetch || !source.isValid()) {
+        setQuery(QSqlQuery(query, db));
+        return;
+    }
+
+    beginResetModel();
+    d->stopFetch();
+    d->fetchedValues.clear();
+    d->fetchedColumns = 0;
+    d->error = QSqlError();
+    d->query.clear();
+    d->rec.clear();
+    d->colOffsets.clear();
+    d->bottom = QModelIndex();
+    d->startFetch(query, source);
+    endResetModel();
+    queryChange();
 }
 
 /*!
@@ -478,6 +860,9 @@ void QSqlQueryModel::clear()
 {
     Q_D(QSqlQueryModel);
     beginResetModel();
+    d->stopFetch();
+    d->fetchedValues.clear();
+    d->fetchedColumns = 0;
     d->error = QSqlError();
     d->atEnd = true;
     d->query.clear();
@@ -86,6 +86,11 @@ public:
     void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
 
+    void setFetchBatchSize(int size);
+    int fetchBatchSize() const;
+    void setBackgroundFetchEnabled(bool enable);
+    bool isBackgroundFetchEnabled() const;
+
 protected:
     void beginInsertRows(const QModelIndex &parent, int first, int last);
     void endInsertRows();
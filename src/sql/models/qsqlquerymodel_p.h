@@ -62,16 +62,22 @@
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQueryModelFetcher;
+
 class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate();
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
+    void startFetch(const QString &query, const QSqlDatabase &db);
+    void stopFetch();
+    void requestFetchedRows();
+    void takeFetchedRows();
 
     mutable QSqlQuery query;
     mutable QSqlError error;
@@ -81,6 +87,12 @@ public:
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
+    int batchSize;
+    bool backgroundFetch;
+    // rows read by the background fetcher, row-major
+    QVector<QVariant> fetchedValues;
+    int fetchedColumns;
+    QSqlQueryModelFetcher *fetcher;
 };
 
 // helpers for building SQL expressions
@@ -61,6 +61,11 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void longText_data();
+    void longText();
+    void longTextEncoding_data();
+    void longTextEncoding();
 };
 
 void tst_Utf8::initTestCase()
@@ -297,5 +302,157 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+// Reference encoder for valid text, independent of the codec's own code
+static QByteArray encodeUtf8(const QVector<uint> &ucs4)
+{
+    QByteArray result;
+    for (uint uc : ucs4) {
+        if (uc < 0x80) {
+            result += char(uc);
+        } else if (uc < 0x800) {
+            result += char(0xc0 | (uc >> 6));
+            result += char(0x80 | (uc & 0x3f));
+        } else if (uc < 0x10000) {
+            result += char(0xe0 | (uc >> 12));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        } else {
+            result += char(0xf0 | (uc >> 18));
+            result += char(0x80 | ((uc >> 12) & 0x3f));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        }
+    }
+    return result;
+}
+
+static QVector<uint> longTextContext(const char *name)
+{
+    // long enough to go through the vectorized code many times
+    QVector<uint> text;
+    for (uint i = 0; i < 64; ++i) {
+        if (qstrcmp(name, "greek") == 0)
+            text << 0x391 + (i % 25);
+        else if (qstrcmp(name, "cjk") == 0)
+            text << 0x4e00 + i * 37;
+        else if (i % 7 == 0)
+            text << ' ';
+        else if (i % 7 == 3)
+            text << 0x1f600 + i;
+        else
+            text << (i % 2 ? 0xe9 : 0x6c34 + i);
+    }
+    return text;
+}
+
+void tst_Utf8::longText_data()
+{
+    QTest::addColumn<QByteArray>("context");
+    QTest::addColumn<QByteArray>("snippet");
+
+    const char *contexts[] = { "greek", "cjk", "mixed" };
+    for (const char *context : contexts) {
+        const auto addRow = [context](const char *name, const QByteArray &snippet) {
+            QTest::newRow(qPrintable(QString::fromLatin1("%1-%2").arg(QLatin1String(context), QLatin1String(name))))
+                    << QByteArray(context) << snippet;
+        };
+        addRow("ascii", "a");
+        addRow("two-bytes", "\xc3\xa9");
+        addRow("three-bytes", "\xe6\xb0\xb4");
+        addRow("four-bytes", "\xf0\x9f\x98\x80");
+        addRow("last-bmp", "\xef\xbf\xbf");
+        addRow("before-surrogates", "\xed\x9f\xbf");
+        addRow("after-surrogates", "\xee\x80\x80");
+        addRow("overlong-2", "\xc1\xbf");
+        addRow("overlong-3", "\xe0\x9f\xbf");
+        addRow("overlong-4", "\xf0\x8f\xbf\xbf");
+        addRow("surrogate", "\xed\xa0\x80");
+        addRow("too-large", "\xf4\x90\x80\x80");
+        addRow("invalid-lead", "\xf8\x88\x80\x80\x80");
+        addRow("stray-continuation", "\x80");
+        addRow("stray-continuations", "\xbf\x80\xbf");
+        addRow("truncated-2", "\xc3");
+        addRow("truncated-3", "\xe6\xb0");
+        addRow("truncated-4", "\xf0\x9f\x98");
+        addRow("nul", QByteArray("\0", 1));
+    }
+}
+
+void tst_Utf8::longText()
+{
+    QFETCH(QByteArray, context);
+    QFETCH(QByteArray, snippet);
+
+    const QVector<uint> ucs4 = longTextContext(context);
+    // the snippet is short enough for the decoder to handle it alone
+    const QString decodedSnippet = from8Bit(snippet);
+
+    for (int i = 0; i <= ucs4.size(); ++i) {
+        const QByteArray prefix = encodeUtf8(ucs4.mid(0, i));
+        const QByteArray suffix = encodeUtf8(ucs4.mid(i));
+        const QByteArray utf8 = prefix + snippet + suffix;
+        const QString expected = QString::fromUcs4(ucs4.constData(), i) + decodedSnippet
+                + QString::fromUcs4(ucs4.constData() + i, ucs4.size() - i);
+
+        QCOMPARE(from8Bit(utf8), expected);
+
+        // a decoder keeps an unfinished sequence at the end for the next call
+        if (i == ucs4.size())
+            continue;
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        QCOMPARE(decoder->toUnicode(utf8), expected);
+        if (decodedSnippet.contains(QChar(QChar::ReplacementCharacter)))
+            QVERIFY(decoder->hasFailure());
+        else
+            QVERIFY(!decoder->hasFailure());
+    }
+}
+
+void tst_Utf8::longTextEncoding_data()
+{
+    QTest::addColumn<QByteArray>("context");
+    QTest::addColumn<QString>("snippet");
+
+    const char *contexts[] = { "greek", "cjk", "mixed" };
+    for (const char *context : contexts) {
+        const auto addRow = [context](const char *name, const QString &snippet) {
+            QTest::newRow(qPrintable(QString::fromLatin1("%1-%2").arg(QLatin1String(context), QLatin1String(name))))
+                    << QByteArray(context) << snippet;
+        };
+        addRow("ascii", QStringLiteral("a"));
+        addRow("two-bytes", QString(QChar(0xe9)));
+        addRow("three-bytes", QString(QChar(0x6c34)));
+        addRow("surrogate-pair", QString::fromUtf16(u"\U0001F600"));
+        addRow("last-bmp", QString(QChar(0xffff)));
+        addRow("lone-high-surrogate", QString(QChar(0xd83d)));
+        addRow("lone-low-surrogate", QString(QChar(0xde00)));
+        addRow("swapped-surrogates", QString(QChar(0xde00)) + QChar(0xd83d));
+    }
+}
+
+void tst_Utf8::longTextEncoding()
+{
+    QFETCH(QByteArray, context);
+    QFETCH(QString, snippet);
+
+    const QVector<uint> ucs4 = longTextContext(context);
+    // the snippet is short enough for the encoder to handle it alone
+    const QByteArray encodedSnippet = to8Bit(snippet);
+
+    for (int i = 0; i <= ucs4.size(); ++i) {
+        const QString utf16 = QString::fromUcs4(ucs4.constData(), i) + snippet
+                + QString::fromUcs4(ucs4.constData() + i, ucs4.size() - i);
+        const QByteArray expected = encodeUtf8(ucs4.mid(0, i)) + encodedSnippet + encodeUtf8(ucs4.mid(i));
+
+        QCOMPARE(to8Bit(utf16), expected);
+
+        // an encoder keeps a surrogate at the end for the next call
+        if (i == ucs4.size())
+            continue;
+        const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+        QCOMPARE(encoder->fromUnicode(utf16), expected);
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
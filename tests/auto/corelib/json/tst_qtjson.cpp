@@ -32,6 +32,8 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
+#include "qjsonlazyvalue.h"
 #include <limits>
 
 #define INVALID_UNICODE "\xCE\xBA\xE1"
@@ -97,6 +99,17 @@ private Q_SLOTS:
     void parseStrings();
     void parseDuplicateKeys();
     void testParser();
+    void lazyParsing();
+    void lazyParsingErrors();
+    void streamReader();
+    void streamReaderIncremental();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderNumbers_data();
+    void streamReaderNumbers();
+    void streamReaderLargeDocument();
+    void streamWriter();
+    void streamWriterCopy();
 
     void compactArray();
     void compactObject();
@@ -1942,6 +1955,368 @@ void tst_QtJson::testParser()
     QVERIFY(!doc.isEmpty());
 }
 
+void tst_QtJson::lazyParsing()
+{
+    QFile file(testDataDir + "/test.json");
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    const QJsonArray array = QJsonDocument::fromJson(testJson).array();
+    QJsonLazyValue lazy(testJson);
+    QVERIFY(lazy.isArray());
+    QCOMPARE(lazy.size(), array.size());
+    QCOMPARE(lazy.toValue(), QJsonValue(array));
+
+    for (int i = 0; i < array.size(); ++i) {
+        const QJsonValue value = array.at(i);
+        const QJsonLazyValue lazyValue = lazy.at(i);
+        QCOMPARE(lazyValue.type(), value.type());
+        QCOMPARE(lazyValue.toValue(), value);
+        if (value.isObject()) {
+            const QJsonObject object = value.toObject();
+            QCOMPARE(lazyValue.keys().toSet(), object.keys().toSet());
+            for (auto it = object.begin(); it != object.end(); ++it)
+                QCOMPARE(lazyValue.value(it.key()).toValue(), it.value());
+        }
+    }
+    QVERIFY(lazy.at(array.size()).isUndefined());
+    QVERIFY(lazy.value("key").isUndefined());
+
+    // escaped and non-ASCII keys, the last duplicate key wins
+    const QByteArray json = "\xef\xbb\xbf { \"\\u00e9t\\u00e9\": 1, \"\xc3\xa9t\xc3\xa9\": [ true, \"a\\\"]\" ],"
+                            " \"x\": {}, \"x\": { \"y\": null } } ";
+    QJsonLazyValue object(json);
+    QCOMPARE(object.size(), 4);
+    QCOMPARE(object.keys(), QStringList() << QString::fromUtf8("\xc3\xa9t\xc3\xa9")
+             << QString::fromUtf8("\xc3\xa9t\xc3\xa9") << "x" << "x");
+    QJsonLazyValue ete = object.value(QString::fromUtf8("\xc3\xa9t\xc3\xa9"));
+    QVERIFY(ete.isArray());
+    QCOMPARE(ete.at(1).toValue(), QJsonValue(QLatin1String("a\"]")));
+    QCOMPARE(ete.rawJson(), QByteArray("[ true, \"a\\\"]\" ]"));
+    QCOMPARE(object["x"]["y"].type(), QJsonValue::Null);
+    QCOMPARE(object.toValue(), QJsonValue(QJsonDocument::fromJson(json).object()));
+
+    QJsonLazyValue x = object["x"];
+    QJsonLazyValue none;
+    x.swap(none);
+    QVERIFY(x.isUndefined());
+    QCOMPARE(none.keys(), QStringList() << "y");
+    QCOMPARE(QJsonLazyValue(QByteArray("[.5]"))[0].type(), QJsonValue::Double);
+    QCOMPARE(QJsonLazyValue(QByteArray("[.5]"))[0].toValue(), QJsonValue(0.5));
+
+    // containers are skipped in blocks; move escapes and brackets in strings across their boundaries
+    for (int padding = 0; padding < 40; ++padding) {
+        const QByteArray nested = "{ \"a\": [" + QByteArray(padding, ' ')
+                + "\"\\\\\", \"\\\"]}\", { \"b\": \"{[\" } ], \"c\": 2 }";
+        QJsonLazyValue lazyNested(nested);
+        QCOMPARE(lazyNested.size(), 2);
+        QCOMPARE(lazyNested["a"].size(), 3);
+        QCOMPARE(lazyNested["a"][1].toValue(), QJsonValue(QLatin1String("\"]}")));
+        QCOMPARE(lazyNested["c"].toValue(), QJsonValue(2));
+    }
+}
+
+void tst_QtJson::lazyParsingErrors()
+{
+    QJsonParseError error;
+
+    QJsonLazyValue unterminated(QByteArray("{ \"a\": [1, 2, 3], \"b\": { \"c\": [] "));
+    QVERIFY(unterminated["a"].isUndefined());
+    QCOMPARE(unterminated.size(), 1);
+    QCOMPARE(unterminated.at(0).type(), QJsonValue::Undefined);
+    QVERIFY(unterminated.toValue(&error).isUndefined());
+    QCOMPARE(error.error, QJsonParseError::UnterminatedObject);
+
+    // the skipped parts are not validated, but the materialized ones are
+    QJsonLazyValue invalid(QByteArray("{ \"a\": [1, 2, +], \"b\": truth }"));
+    QVERIFY(invalid["a"].isArray());
+    QVERIFY(invalid["a"].toValue(&error).isUndefined());
+    QCOMPARE(error.error, QJsonParseError::IllegalNumber);
+    QCOMPARE(error.offset, 14);
+    QVERIFY(invalid["b"].toValue(&error).isUndefined());
+    QCOMPARE(error.error, QJsonParseError::IllegalValue);
+
+    QVERIFY(QJsonLazyValue(QByteArray()).isUndefined());
+    QVERIFY(QJsonLazyValue(QByteArray("  ")).toValue(&error).isUndefined());
+    QCOMPARE(error.error, QJsonParseError::IllegalValue);
+}
+
+void tst_QtJson::streamReader()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.seek(0);
+
+    QJsonStreamReader reader(&file);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readCurrentValue(), QJsonValue(doc.array()));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.characterOffset(), file.size());
+
+    const QByteArray json = "{ \"a\": [ 1.5, \"x\\ty\", true, null ], \"\": { \"b\": false }, \"c\": -2e3 }";
+    reader.clear();
+    reader.addData(json);
+    QStringList tokens;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        QString token = reader.tokenString();
+        if (!reader.name().isNull())
+            token += ':' + reader.name();
+        if (reader.isString() || reader.isNumber() || reader.isBool())
+            token += '=' + reader.value().toVariant().toString();
+        tokens << token;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(tokens, QStringList() << "StartDocument" << "StartObject" << "StartArray:a" << "Number=1.5"
+                                   << "String=x\ty" << "Bool=true" << "Null" << "EndArray"
+                                   << "StartObject:" << "Bool:b=false" << "EndObject"
+                                   << "Number:c=-2000" << "EndObject" << "EndDocument");
+
+    // any value is a valid document
+    QJsonStreamReader scalar(QByteArray(" 42 "));
+    QCOMPARE(scalar.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(scalar.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(scalar.toDouble(), 42.);
+    QCOMPARE(scalar.readNext(), QJsonStreamReader::EndDocument);
+
+    // skipping
+    reader.clear();
+    reader.addData(json);
+    reader.readNext();
+    reader.readNext();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.name(), QString(""));
+    reader.raiseError("custom");
+    QCOMPARE(reader.error(), QJsonStreamReader::CustomError);
+    QCOMPARE(reader.errorString(), QString("custom"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    QJsonStreamReader whole(json);
+    QList<QJsonStreamReader::TokenType> expected;
+    while (!whole.atEnd())
+        expected << whole.readNext();
+    QVERIFY(!whole.hasError());
+
+    // feed the data a byte at a time, going through every possible split
+    QJsonStreamReader reader;
+    QList<QJsonStreamReader::TokenType> tokens;
+    for (int i = 0; i < json.size(); ++i) {
+        reader.addData(json.mid(i, 1));
+        while (!reader.atEnd()) {
+            const QJsonStreamReader::TokenType token = reader.readNext();
+            if (token == QJsonStreamReader::Invalid)
+                QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+            else
+                tokens << token;
+        }
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(tokens, expected);
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("parseError");
+
+    QTest::newRow("empty") << QByteArray("") << int(QJsonStreamReader::PrematureEndOfDocumentError) << 0;
+    QTest::newRow("unterminated") << QByteArray("{ \"a\": [1, 2") << int(QJsonStreamReader::PrematureEndOfDocumentError) << 0;
+    QTest::newRow("string") << QByteArray("[\"abc") << int(QJsonStreamReader::PrematureEndOfDocumentError) << 0;
+    QTest::newRow("separator") << QByteArray("[1 2]") << int(QJsonStreamReader::NotWellFormedError)
+                               << int(QJsonParseError::MissingValueSeparator);
+    QTest::newRow("name separator") << QByteArray("{\"a\" 1}") << int(QJsonStreamReader::NotWellFormedError)
+                                    << int(QJsonParseError::MissingNameSeparator);
+    QTest::newRow("trailing comma") << QByteArray("{\"a\": 1,}") << int(QJsonStreamReader::NotWellFormedError)
+                                    << int(QJsonParseError::MissingObject);
+    QTest::newRow("value") << QByteArray("[1, ]") << int(QJsonStreamReader::NotWellFormedError)
+                           << int(QJsonParseError::IllegalValue);
+    QTest::newRow("literal") << QByteArray("[truth]") << int(QJsonStreamReader::NotWellFormedError)
+                             << int(QJsonParseError::IllegalValue);
+    QTest::newRow("number") << QByteArray("[1e+]") << int(QJsonStreamReader::NotWellFormedError)
+                            << int(QJsonParseError::IllegalNumber);
+    QTest::newRow("escape") << QByteArray("[\"\\u12x4\"]") << int(QJsonStreamReader::NotWellFormedError)
+                            << int(QJsonParseError::IllegalEscapeSequence);
+    QTest::newRow("utf8") << QByteArray("[\"\xff\"]") << int(QJsonStreamReader::NotWellFormedError)
+                          << int(QJsonParseError::IllegalUTF8String);
+    QTest::newRow("garbage") << QByteArray("[] []") << int(QJsonStreamReader::NotWellFormedError)
+                             << int(QJsonParseError::GarbageAtEnd);
+    QTest::newRow("nesting") << QByteArray(2048, '[') << int(QJsonStreamReader::NotWellFormedError)
+                             << int(QJsonParseError::DeepNesting);
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, error);
+    QFETCH(int, parseError);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(int(reader.tokenType()), int(QJsonStreamReader::Invalid));
+    QCOMPARE(int(reader.error()), error);
+    if (error == QJsonStreamReader::NotWellFormedError) {
+        QJsonParseError expected;
+        expected.error = QJsonParseError::ParseError(parseError);
+        QCOMPARE(reader.errorString(), expected.errorString());
+    }
+}
+
+void tst_QtJson::streamReaderNumbers_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("zero") << QByteArray("[0]") << true;
+    QTest::newRow("minus zero") << QByteArray("[-0]") << true;
+    QTest::newRow("integer") << QByteArray("[-1234567890]") << true;
+    QTest::newRow("large integer") << QByteArray("[12345678901234567890]") << true;
+    QTest::newRow("fraction") << QByteArray("[0.25]") << true;
+    QTest::newRow("exponent") << QByteArray("[1.5E-3, 2e+2, 3e4]") << true;
+    QTest::newRow("no integer part") << QByteArray("[.5]") << true;
+    QTest::newRow("minus no integer part") << QByteArray("[-.5]") << true;
+    QTest::newRow("leading zero") << QByteArray("[01]") << false;
+    QTest::newRow("minus leading zero") << QByteArray("[-01]") << false;
+    QTest::newRow("two zeros") << QByteArray("[00]") << false;
+    QTest::newRow("two points") << QByteArray("[1.2.3]") << false;
+    QTest::newRow("two exponents") << QByteArray("[1e2e3]") << false;
+    QTest::newRow("minus only") << QByteArray("[-]") << false;
+    QTest::newRow("plus") << QByteArray("[+1]") << false;
+    QTest::newRow("empty exponent") << QByteArray("[1e]") << false;
+}
+
+void tst_QtJson::streamReaderNumbers()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, valid);
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    QCOMPARE(parseError.error == QJsonParseError::NoError, valid);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    const QJsonValue value = reader.readCurrentValue();
+    QCOMPARE(!reader.hasError(), valid);
+    if (valid)
+        QCOMPARE(value, QJsonValue(document.array()));
+    else
+        QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+}
+
+void tst_QtJson::streamReaderLargeDocument()
+{
+    // larger than what the reader reads from the device at a time
+    QJsonArray records;
+    for (int i = 0; i < 5000; ++i) {
+        QJsonObject record;
+        record.insert("id", i);
+        record.insert("name", QString("record %1 \"\xc3\xa9\"").arg(i));
+        records.append(record);
+    }
+    QByteArray json = QJsonDocument(records).toJson();
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QJsonStreamReader reader(&buffer);
+    reader.readNext();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        QCOMPARE(reader.readCurrentValue(), QJsonValue(records.at(count)));
+        ++count;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, records.size());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+}
+
+void tst_QtJson::streamWriter()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+
+    QByteArray compact;
+    QJsonStreamWriter writer(&compact);
+    QVERIFY(!writer.autoFormatting());
+    writer.writeValue(doc.array());
+    QVERIFY(!writer.hasError());
+    QCOMPARE(compact, doc.toJson(QJsonDocument::Compact));
+
+    QByteArray indented;
+    writer.setDevice(0);
+    QBuffer buffer(&indented);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    writer.setDevice(&buffer);
+    writer.setAutoFormatting(true);
+    writer.writeValue(doc.array());
+    QCOMPARE(indented, doc.toJson(QJsonDocument::Indented));
+
+    // building the document piece by piece
+    QByteArray json;
+    QJsonStreamWriter pieces(&json);
+    pieces.setAutoFormatting(true);
+    pieces.writeStartObject();
+    pieces.writeValue("a", 1);
+    pieces.writeStartArray("b");
+    pieces.writeValue(QString("\"x\"\n"));
+    pieces.writeStartObject();
+    pieces.writeEndObject();
+    pieces.writeValue(QJsonValue::Null);
+    pieces.writeEndArray();
+    pieces.writeStartObject("c");
+    pieces.writeEndDocument();
+
+    QJsonObject object;
+    object.insert("a", 1);
+    object.insert("b", QJsonArray() << QString("\"x\"\n") << QJsonObject() << QJsonValue());
+    object.insert("c", QJsonObject());
+    QCOMPARE(json, QJsonDocument(object).toJson());
+}
+
+void tst_QtJson::streamWriterCopy()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.seek(0);
+
+    QByteArray json;
+    QJsonStreamReader reader(&file);
+    QJsonStreamWriter writer(&json);
+    while (!reader.atEnd()) {
+        reader.readNext();
+        writer.writeCurrentToken(reader);
+    }
+    QVERIFY(!reader.hasError());
+
+    // members stay in document order, where QJsonObject sorts them
+    QVERIFY(json.startsWith("[\"JSON Test Pattern pass1\""));
+    QCOMPARE(QJsonDocument::fromJson(json), doc);
+}
+
 void tst_QtJson::compactArray()
 {
     QJsonArray array;
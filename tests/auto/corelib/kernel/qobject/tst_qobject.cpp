@@ -79,6 +79,7 @@ private slots:
     void thread0();
     void moveToThread();
     void senderTest();
+    void senderDirectConnectionFromOtherThread();
     void declareInterface();
     void qpointerResetBeforeDestroyedSignal();
     void testUserData();
@@ -90,6 +91,7 @@ private slots:
     void recursiveSignalEmission();
     void signalBlocking();
     void blockingQueuedConnection();
+    void batchedConnection();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -2282,6 +2284,59 @@ void tst_QObject::senderTest()
     }
 }
 
+class DirectConnectingThread : public QThread
+{
+public:
+    QObject *sender;
+    QObject *receiver;
+
+    DirectConnectingThread(QObject *sender, QObject *receiver) : sender(sender), receiver(receiver) { }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        QObject::connect(sender, SIGNAL(theSignal()), receiver, SLOT(rememberSender()),
+                         Qt::DirectConnection);
+    }
+};
+
+void tst_QObject::senderDirectConnectionFromOtherThread()
+{
+    {
+        // connected from a thread the receiver does not live in
+        SuperObject sender;
+        SuperObject receiver;
+        DirectConnectingThread thread(&sender, &receiver);
+        thread.start();
+        QVERIFY(thread.wait(10000));
+
+        emit sender.theSignal();
+        QCOMPARE(receiver.theSender, (QObject *)&sender);
+        QCOMPARE(receiver.theSignalId, sender.metaObject()->indexOfSignal("theSignal()"));
+        QCOMPARE(receiver.sender(), (QObject *)0);
+    }
+
+    {
+        // connected before the receiver was moved to the thread that emits
+        SuperObject *sender = new SuperObject;
+        SuperObject *receiver = new SuperObject;
+        connect(sender, SIGNAL(theSignal()), receiver, SLOT(rememberSender()), Qt::DirectConnection);
+
+        QThread thread;
+        sender->moveToThread(&thread);
+        receiver->moveToThread(&thread);
+        thread.start();
+        QVERIFY(QMetaObject::invokeMethod(sender, "theSignal", Qt::BlockingQueuedConnection));
+        QCOMPARE(receiver->theSender, (QObject *)sender);
+        QCOMPARE(receiver->theSignalId, sender->metaObject()->indexOfSignal("theSignal()"));
+
+        thread.quit();
+        QVERIFY(thread.wait(10000));
+        delete receiver;
+        delete sender;
+    }
+}
+
 namespace Foo
 {
     struct Bar
@@ -3070,6 +3125,117 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+struct BatchedUnregistered { };
+
+class BatchedEmitter : public QThread
+{
+    Q_OBJECT
+public:
+    explicit BatchedEmitter(int count) : count(count) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            emit value(i);
+    }
+
+signals:
+    void value(int);
+    void unregistered(BatchedUnregistered);
+
+private:
+    int count;
+};
+
+class BatchedReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QMap<QObject *, QVector<int> > values;
+    QAtomicInt received;
+
+public slots:
+    void value(int i)
+    {
+        values[sender()].append(i);
+        received.ref();
+    }
+    void unregistered(BatchedUnregistered) { }
+};
+
+void tst_QObject::batchedConnection()
+{
+    const int count = 1000;
+    QVector<int> expected;
+    for (int i = 0; i < count; ++i)
+        expected << i;
+
+    {
+        BatchedReceiver receiver;
+        QVector<BatchedEmitter *> emitters;
+        for (int i = 0; i < 4; ++i) {
+            emitters << new BatchedEmitter(count);
+            QVERIFY(connect(emitters.last(), &BatchedEmitter::value, &receiver, &BatchedReceiver::value,
+                            Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+        }
+        for (BatchedEmitter *emitter : qAsConst(emitters))
+            emitter->start();
+        for (BatchedEmitter *emitter : qAsConst(emitters))
+            QVERIFY(emitter->wait());
+
+        // nothing is delivered until the receiver's thread processes its events
+        QVERIFY(receiver.values.isEmpty());
+        QCoreApplication::sendPostedEvents();
+        QCOMPARE(receiver.values.size(), emitters.size());
+        for (BatchedEmitter *emitter : qAsConst(emitters))
+            QCOMPARE(receiver.values.value(emitter), expected);
+        qDeleteAll(emitters);
+    }
+
+    {
+        // the calls still pending when the receiver is destroyed are dropped
+        BatchedEmitter emitter(count);
+        BatchedReceiver *receiver = new BatchedReceiver;
+        QVERIFY(connect(&emitter, &BatchedEmitter::value, receiver, &BatchedReceiver::value,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        emitter.start();
+        QVERIFY(emitter.wait());
+        delete receiver;
+        QCoreApplication::sendPostedEvents();
+    }
+
+    {
+        // the calls pending when the receiver moves to another thread follow it
+        BatchedEmitter emitter(count);
+        BatchedReceiver receiver;
+        QVERIFY(receiver.connect(&emitter, SIGNAL(value(int)), SLOT(value(int)),
+                                 Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        emitter.start();
+        QVERIFY(emitter.wait());
+
+        MoveToThreadThread thread;
+        thread.start();
+        receiver.moveToThread(&thread);
+        QCoreApplication::sendPostedEvents();
+        QTRY_COMPARE(receiver.received.load(), count);
+        thread.quit();
+        QVERIFY(thread.wait());
+        QCOMPARE(receiver.values.size(), 1);
+        QCOMPARE(receiver.values.value(&emitter), expected);
+    }
+
+    {
+        // as with queued connections, the arguments must be registered
+        BatchedEmitter emitter(count);
+        BatchedReceiver receiver;
+        QTest::ignoreMessage(QtWarningMsg, "QObject::connect: Cannot queue arguments of type 'BatchedUnregistered'\n"
+                                           "(Make sure 'BatchedUnregistered' is registered using qRegisterMetaType().)");
+        QVERIFY(!receiver.connect(&emitter, SIGNAL(unregistered(BatchedUnregistered)),
+                                  SLOT(unregistered(BatchedUnregistered)),
+                                  Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+    }
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
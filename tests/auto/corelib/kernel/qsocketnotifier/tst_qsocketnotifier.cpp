@@ -32,6 +32,8 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
 #include <QtCore/QSocketNotifier>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
@@ -44,6 +46,7 @@
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
 #include <private/qnet_unix_p.h>
+#include <private/qeventdispatcher_unix_p.h>
 #include <sys/select.h>
 #endif
 #include <limits>
@@ -61,6 +64,9 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+#endif
+#if QT_CONFIG(epoll)
+    void epollClosedDescriptor();
 #endif
     void asyncMultipleDatagram();
 
@@ -325,6 +331,60 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#if QT_CONFIG(epoll)
+class EpollClosedDescriptorThread : public QThread
+{
+public:
+    int invalidatedCount = -1;
+    int staleIterations = -1;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+            return;
+        qt_safe_write(fds[1], "x", 1);
+
+        // a closed descriptor whose file lives on in a copy is still watched by
+        // epoll; its notifier is disabled as poll() would do it for POLLNVAL
+        const int copy = qt_safe_dup(fds[0]);
+        {
+            QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+            qt_safe_close(fds[0]);
+            QCoreApplication::processEvents();
+            invalidatedCount = notifier.isEnabled() ? 0 : 1;
+        }
+
+        // the notifier is gone now, but epoll still reports the file; this
+        // must neither crash nor keep the event loop spinning
+        QSocketNotifier other(fds[1], QSocketNotifier::Read);
+        QEventLoop loop;
+        bool timedOut = false;
+        QTimer::singleShot(50, &loop, [&timedOut]() { timedOut = true; });
+        for (staleIterations = 0; !timedOut && staleIterations < 1000; ++staleIterations)
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+
+        qt_safe_close(copy);
+        qt_safe_close(fds[1]);
+    }
+};
+
+void tst_QSocketNotifier::epollClosedDescriptor()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    EpollClosedDescriptorThread thread;
+    thread.setEventDispatcher(new QEventDispatcherUNIX);
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("QSocketNotifier: Invalid socket \\d+ with type Read, disabling..."));
+    thread.start();
+    QVERIFY(thread.wait(5000));
+    QCOMPARE(thread.invalidatedCount, 1);
+    QVERIFY(thread.staleIterations < 1000);
+}
+#endif
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
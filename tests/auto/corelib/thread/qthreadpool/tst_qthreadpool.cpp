@@ -91,6 +91,11 @@ private slots:
     void cancel();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
+    void startFromPoolThread();
+    void startSameRunnableFromPoolThreads();
+    void tryStartFromPoolThread();
+    void localTaskPriority();
+    void clearAndCancelLocalTasks();
     void stressTest();
 
 private:
@@ -1037,6 +1042,251 @@ void tst_QThreadPool::destroyingWaitsForTasksToFinish()
     }
 }
 
+void tst_QThreadPool::startFromPoolThread()
+{
+    class SpawningTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        int depth;
+        QAtomicInt &runs;
+        QAtomicInt &deletions;
+        SpawningTask(QThreadPool *pool, int depth, QAtomicInt &runs, QAtomicInt &deletions)
+            : pool(pool), depth(depth), runs(runs), deletions(deletions) {}
+        ~SpawningTask() { deletions.ref(); }
+        void run()
+        {
+            runs.ref();
+            if (depth > 0) {
+                for (int i = 0; i < 10; ++i)
+                    pool->start(new SpawningTask(pool, depth - 1, runs, deletions));
+            }
+        }
+    };
+
+    QAtomicInt runs;
+    QAtomicInt deletions;
+    {
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(4);
+        for (int i = 0; i < 4; ++i)
+            threadPool.start(new SpawningTask(&threadPool, 3, runs, deletions));
+        QVERIFY(threadPool.waitForDone(20000));
+    }
+    // 4 * (1 + 10 + 100 + 1000)
+    QCOMPARE(runs.load(), 4444);
+    QCOMPARE(deletions.load(), 4444);
+}
+
+// an auto-deleted runnable is started from several pool threads while
+// other copies of it run and finish, so its reference count changes
+// concurrently on all of them
+void tst_QThreadPool::startSameRunnableFromPoolThreads()
+{
+    class SharedTask : public QRunnable
+    {
+    public:
+        QAtomicInt blocked;
+        QSemaphore allStarted;
+        QAtomicInt &runs;
+        QAtomicInt &deletions;
+        SharedTask(QAtomicInt &runs, QAtomicInt &deletions) : runs(runs), deletions(deletions) {}
+        ~SharedTask() { deletions.ref(); }
+        void run()
+        {
+            // the first copy keeps the runnable alive until all are started
+            if (blocked.testAndSetRelaxed(0, 1))
+                allStarted.acquire();
+            runs.ref();
+        }
+    };
+    class StartingTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        SharedTask *shared;
+        QSemaphore &done;
+        StartingTask(QThreadPool *pool, SharedTask *shared, QSemaphore &done)
+            : pool(pool), shared(shared), done(done) {}
+        void run()
+        {
+            for (int i = 0; i < 100; ++i)
+                pool->start(shared);
+            done.release();
+        }
+    };
+
+    const int starters = 3;
+    QAtomicInt runs;
+    QAtomicInt deletions;
+    QSemaphore startersDone;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(starters + 1);
+
+    SharedTask *shared = new SharedTask(runs, deletions);
+    threadPool.start(shared);
+    for (int i = 0; i < starters; ++i)
+        threadPool.start(new StartingTask(&threadPool, shared, startersDone));
+    QVERIFY(startersDone.tryAcquire(starters, 20000));
+    shared->allStarted.release();
+
+    QVERIFY(threadPool.waitForDone(20000));
+    QCOMPARE(runs.load(), 1 + starters * 100);
+    QCOMPARE(deletions.load(), 1);
+}
+
+void tst_QThreadPool::tryStartFromPoolThread()
+{
+    class ChildTask : public QRunnable
+    {
+    public:
+        QSemaphore started;
+        QSemaphore finish;
+        ChildTask() { setAutoDelete(false); }
+        void run()
+        {
+            started.release();
+            finish.acquire();
+        }
+    };
+    class ParentTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        ChildTask *child;
+        bool firstStarted = false;
+        bool childRan = false;
+        bool secondStarted = true;
+        ParentTask(QThreadPool *pool, ChildTask *child) : pool(pool), child(child) { setAutoDelete(false); }
+        void run()
+        {
+            // one thread is still available
+            firstStarted = pool->tryStart(child);
+            // and runs the child while this one is still running
+            childRan = child->started.tryAcquire(1, 10000);
+            // now there is none
+            secondStarted = pool->tryStart(child);
+            child->finish.release();
+        }
+    };
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(2);
+    ChildTask child;
+    ParentTask parent(&threadPool, &child);
+    threadPool.start(&parent);
+    QVERIFY(threadPool.waitForDone(20000));
+    QVERIFY(parent.firstStarted);
+    QVERIFY(parent.childRan);
+    QVERIFY(!parent.secondStarted);
+
+    // the pool accepts work again once the threads are idle
+    QVERIFY(threadPool.tryStart(&child));
+    QVERIFY(child.started.tryAcquire(1, 10000));
+    child.finish.release();
+    QVERIFY(threadPool.waitForDone(20000));
+}
+
+void tst_QThreadPool::localTaskPriority()
+{
+    class RecordingTask : public QRunnable
+    {
+    public:
+        QMutex &mutex;
+        QStringList &order;
+        QString name;
+        RecordingTask(QMutex &mutex, QStringList &order, const QString &name)
+            : mutex(mutex), order(order), name(name) {}
+        void run()
+        {
+            QMutexLocker locker(&mutex);
+            order << name;
+        }
+    };
+    class ParentTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        QRunnable *child;
+        QSemaphore childStarted;
+        QSemaphore finish;
+        ParentTask(QThreadPool *pool, QRunnable *child) : pool(pool), child(child) {}
+        void run()
+        {
+            pool->start(child);
+            childStarted.release();
+            finish.acquire();
+        }
+    };
+
+    QMutex mutex;
+    QStringList order;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    ParentTask *parent = new ParentTask(&threadPool, new RecordingTask(mutex, order, "local"));
+    parent->setAutoDelete(false);
+    threadPool.start(parent);
+    QVERIFY(parent->childStarted.tryAcquire(1, 10000));
+
+    // a task of higher priority in the pool's queue goes before the one
+    // queued on the thread
+    threadPool.start(new RecordingTask(mutex, order, "important"), 10);
+    parent->finish.release();
+    QVERIFY(threadPool.waitForDone(20000));
+    delete parent;
+    QCOMPARE(order, QStringList() << "important" << "local");
+}
+
+void tst_QThreadPool::clearAndCancelLocalTasks()
+{
+    class CountingTask : public QRunnable
+    {
+    public:
+        QAtomicInt &runs;
+        QAtomicInt &deletions;
+        CountingTask(QAtomicInt &runs, QAtomicInt &deletions) : runs(runs), deletions(deletions) {}
+        ~CountingTask() { deletions.ref(); }
+        void run() { runs.ref(); }
+    };
+    class ParentTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        QList<QRunnable *> children;
+        QSemaphore childrenStarted;
+        QSemaphore finish;
+        ParentTask(QThreadPool *pool) : pool(pool) { setAutoDelete(false); }
+        void run()
+        {
+            for (QRunnable *child : qAsConst(children))
+                pool->start(child);
+            childrenStarted.release();
+            finish.acquire();
+        }
+    };
+
+    QAtomicInt runs;
+    QAtomicInt deletions;
+    QThreadPool threadPool;
+    // no other thread that could take the children
+    threadPool.setMaxThreadCount(1);
+
+    ParentTask parent(&threadPool);
+    CountingTask kept(runs, deletions);
+    kept.setAutoDelete(false);
+    parent.children << new CountingTask(runs, deletions) << &kept << new CountingTask(runs, deletions);
+    threadPool.start(&parent);
+    QVERIFY(parent.childrenStarted.tryAcquire(1, 10000));
+
+    threadPool.cancel(&kept);
+    threadPool.clear();
+    QCOMPARE(deletions.load(), 2);
+    parent.finish.release();
+    QVERIFY(threadPool.waitForDone(20000));
+    QCOMPARE(runs.load(), 0);
+    QCOMPARE(deletions.load(), 2);
+}
+
 void tst_QThreadPool::stressTest()
 {
     class Task : public QRunnable
@@ -94,6 +94,7 @@ private slots:
     void replaceWithSpecifiedLength();
     void indexOf_data();
     void indexOf();
+    void indexOfLongHaystack();
     void lastIndexOf_data();
     void lastIndexOf();
     void toULong_data();
@@ -1160,6 +1161,33 @@ void tst_QByteArray::indexOf()
     }
 }
 
+// The search processes long haystacks in blocks; check every position.
+void tst_QByteArray::indexOfLongHaystack()
+{
+    const QByteArray needles[] = { QByteArrayLiteral("b"), QByteArrayLiteral("ba"),
+                                   QByteArrayLiteral("bab"), QByteArrayLiteral("baaaaaab") };
+    for (const QByteArray &needle : needles) {
+        for (int length = needle.size(); length <= 100; ++length) {
+            const QByteArray haystack(length, 'a');
+            QCOMPARE(haystack.indexOf(needle), -1);
+            for (int i = 0; i + needle.size() <= length; ++i) {
+                QByteArray copy = haystack;
+                copy.replace(i, needle.size(), needle);
+                QCOMPARE(copy.indexOf(needle), i);
+                QCOMPARE(copy.indexOf(needle, i), i);
+                QCOMPARE(copy.indexOf(needle, i + 1), -1);
+                QCOMPARE(copy.indexOf(needle.constData()), i);
+            }
+        }
+    }
+
+    // first and last byte match, but not the middle
+    const QByteArray padding(40, 'a');
+    const QByteArray nearMiss = padding + "baaaacab" + padding;
+    QCOMPARE(nearMiss.indexOf("baaaaaab"), -1);
+    QCOMPARE((nearMiss + "baaaaaab").indexOf("baaaaaab"), nearMiss.size());
+}
+
 void tst_QByteArray::lastIndexOf_data()
 {
     QTest::addColumn<QByteArray>("haystack");
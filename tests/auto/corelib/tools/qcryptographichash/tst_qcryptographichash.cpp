@@ -42,6 +42,10 @@ private slots:
     void sha3();
     void files_data();
     void files();
+    void blocks_data();
+    void blocks();
+    void lengths_data();
+    void lengths();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -254,5 +258,105 @@ void tst_QCryptographicHash::files()
 }
 
 
+static QByteArray blockTestData()
+{
+    QByteArray data(10000, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7 + i / 256);
+    return data;
+}
+
+void tst_QCryptographicHash::blocks_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<QByteArray>("hash");
+    QTest::newRow("md5") << QCryptographicHash::Md5
+                          << QByteArray("09445357d379ef5a5451e5d5654a8f7b");
+    QTest::newRow("sha1") << QCryptographicHash::Sha1
+                          << QByteArray("35b95c21647a0e723871393848814bf5a6ddd210");
+    QTest::newRow("sha224") << QCryptographicHash::Sha224
+                          << QByteArray("2753b35c9a702f13e19e05e84d17198215b56addae17a75359583b46");
+    QTest::newRow("sha256") << QCryptographicHash::Sha256
+                          << QByteArray("c6bec1a98cf1c8f350c1ca9cd7ed598ae4e74e32ef95e8396cfd64129c34dc24");
+    QTest::newRow("sha384") << QCryptographicHash::Sha384
+                          << QByteArray("d59e501e8ac52782b15386ceb2286c74fe4e88415905111b40927b741c4e6ac09b65bc53aeea1446e63989750da7b3ec");
+    QTest::newRow("sha512") << QCryptographicHash::Sha512
+                          << QByteArray("26cb4059c0a8be6a115999222a7e53909d2a99dab2e3a3c80a89d9f35706e9501381efc94f55d94ef3faf3877acfca4bf84034caf2ede60f9f3c22b51e83e41e");
+    QTest::newRow("sha3_224") << QCryptographicHash::Sha3_224
+                          << QByteArray("a32b4edabba97b22e1d0cce190093bb5cd8891b0e525e5e0b1576062");
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256
+                          << QByteArray("b34e4bebd10de192ca422a8110152806ead84c056433181014269714c3ae6f02");
+    QTest::newRow("sha3_384") << QCryptographicHash::Sha3_384
+                          << QByteArray("95b796b72b550333b3614d15a158456c47585a6f8383397d69146f64c7170447861cb41cb8adc221ee1f42dcbdda9c31");
+    QTest::newRow("sha3_512") << QCryptographicHash::Sha3_512
+                          << QByteArray("95fa210715e64a8387e6bd199a7cfe80fe9bb4554106409eabdd998efc7b40e20ae8a858a76988c6e7c765676c30a9eef3c6c12a2898f5ae1dc86f4771cd0b4d");
+}
+
+// hashes the same message in one go, in pieces that do and do not line up
+// with the block size of the algorithm, and from a QIODevice
+void tst_QCryptographicHash::blocks()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(QByteArray, hash);
+    const QByteArray data = blockTestData();
+
+    QCOMPARE(QCryptographicHash::hash(data, algorithm).toHex(), hash);
+
+    static const int chunkSizes[] = { 1, 63, 64, 65, 127, 200, 1000 };
+    for (int chunkSize : chunkSizes) {
+        QCryptographicHash h(algorithm);
+        for (int i = 0; i < data.size(); i += chunkSize)
+            h.addData(data.constData() + i, qMin(chunkSize, data.size() - i));
+        QCOMPARE(h.result().toHex(), hash);
+    }
+
+    QBuffer buffer;
+    buffer.setData(data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCryptographicHash h(algorithm);
+    QVERIFY(h.addData(&buffer));
+    QCOMPARE(h.result().toHex(), hash);
+}
+
+void tst_QCryptographicHash::lengths_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<QByteArray>("hash");
+    QTest::newRow("md5") << QCryptographicHash::Md5
+                          << QByteArray("26d420cacf656b9f2c6333c7175c8000");
+    QTest::newRow("sha1") << QCryptographicHash::Sha1
+                          << QByteArray("68d9f6d9d2bad48ff7fa4ab2fb4d920c6e9ca140");
+    QTest::newRow("sha224") << QCryptographicHash::Sha224
+                          << QByteArray("aff8d3aba1c37caac589beb263944bd78c8584f76fdd846d1f0b7d3d");
+    QTest::newRow("sha256") << QCryptographicHash::Sha256
+                          << QByteArray("8133bea06a9979f7bff0426d07c426a13c1e2d346abb91ffc80f8c5ad7a0c5c3");
+    QTest::newRow("sha384") << QCryptographicHash::Sha384
+                          << QByteArray("e74ee7a539f7a05277e0a07546657d9333981960f3e0d602bde1901c9352d3fbe638022a97805e9fe0a9cc8c412dd388");
+    QTest::newRow("sha512") << QCryptographicHash::Sha512
+                          << QByteArray("9cdea6c1c82ae38edeeee09193d91c1121f8bf8e7470a5fc6ac39b887340a97ba7fa7db00567a153925d9390cd2484a5fa0e44f8d127e7666f3c047ece9429dc");
+    QTest::newRow("sha3_224") << QCryptographicHash::Sha3_224
+                          << QByteArray("722d97b2e581a8d53aabe0a2b7d7a85a04b2b00123e35dcb9b00bbdd");
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256
+                          << QByteArray("89ef42dca8fec5f231ee2f27b61d7f2c362037e7ca83e74f3d20c7ceeefbd390");
+    QTest::newRow("sha3_384") << QCryptographicHash::Sha3_384
+                          << QByteArray("dd38511a6d18a0c2842a903d9231523c5e7495b65e7fb07d08d9eb165eaf006217d986489f963911ace28248f90033b3");
+    QTest::newRow("sha3_512") << QCryptographicHash::Sha3_512
+                          << QByteArray("7e3f97c70de86968fd04db4a3404d448fc50b061eb534d3363b5919ed4ef599046a6c3236c5f1069e649adce7b0985f5cd61172d5853d76c1f6090d20acd2df3");
+}
+
+// the hash of the hashes of all messages up to 300 bytes long, which covers
+// every way the padding can fall into one or two blocks
+void tst_QCryptographicHash::lengths()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(QByteArray, hash);
+    const QByteArray data = blockTestData();
+
+    QCryptographicHash all(algorithm);
+    for (int length = 0; length < 300; ++length)
+        all.addData(QCryptographicHash::hash(data.left(length), algorithm));
+    QCOMPARE(all.result().toHex(), hash);
+}
+
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
@@ -0,0 +1,389 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndLookup();
+    void remove();
+    void take();
+    void growth();
+    void reserveAndSqueeze();
+    void implicitSharing();
+    void iterators();
+    void eraseWhileIterating();
+    void stringKeys();
+    void insertOwnElement();
+    void complexValues();
+    void compare();
+    void matchesQHash();
+    void flatSet();
+};
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, -1), -1);
+
+    hash.insert(1, 10);
+    hash.insert(2, 20);
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains(1));
+    QCOMPARE(hash.value(2), 20);
+
+    hash.insert(1, 11);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(1), 11);
+
+    hash[3] = 30;
+    ++hash[3];
+    QCOMPARE(hash.value(3), 31);
+    QCOMPARE(hash[4], 0);
+    QCOMPARE(hash.size(), 4);
+
+    const QFlatHash<int, int> &constHash = hash;
+    QCOMPARE(constHash[5], 0);
+    QCOMPARE(hash.size(), 4);
+
+    QFlatHash<int, int>::iterator it = hash.find(2);
+    QVERIFY(it != hash.end());
+    QCOMPARE(it.key(), 2);
+    QCOMPARE(it.value(), 20);
+    QVERIFY(hash.find(42) == hash.end());
+    QVERIFY(constHash.constFind(42) == constHash.constEnd());
+
+    QFlatHash<int, int> list = { { 1, 2 }, { 3, 4 } };
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list.value(3), 4);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.remove(1), 0);
+
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    // churn must not grow the table
+    const int capacity = hash.capacity();
+    for (int i = 1000; i < 100000; ++i) {
+        hash.insert(i, i);
+        hash.remove(i);
+    }
+    QCOMPARE(hash.size(), 50);
+    QCOMPARE(hash.capacity(), capacity);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    QCOMPARE(hash.take(1), QString());
+    hash.insert(1, QStringLiteral("one"));
+    QCOMPARE(hash.take(2), QString());
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QVERIFY(hash.isEmpty());
+}
+
+void tst_QFlatHash::growth()
+{
+    QFlatHash<quint64, int> hash;
+    const int count = 100000;
+    for (int i = 0; i < count; ++i)
+        hash.insert(quint64(i) << 20, i);
+    QCOMPARE(hash.size(), count);
+    QVERIFY(hash.capacity() >= count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(hash.value(quint64(i) << 20, -1), i);
+    QVERIFY(!hash.contains(1));
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int> copy = hash;
+    QVERIFY(!hash.isDetached());
+    QVERIFY(copy == hash);
+
+    copy.insert(1000, 1000);
+    copy.remove(0);
+    QVERIFY(hash.isDetached());
+    QVERIFY(copy.isDetached());
+    QCOMPARE(hash.size(), 100);
+    QVERIFY(hash.contains(0));
+    QVERIFY(!hash.contains(1000));
+    QCOMPARE(copy.size(), 100);
+    QVERIFY(!copy.contains(0));
+
+    QFlatHash<int, int> copy2 = hash;
+    copy2[5] = 50;
+    QCOMPARE(hash.value(5), 5);
+    QCOMPARE(copy2.value(5), 50);
+
+    QFlatHash<int, int> moved = std::move(copy2);
+    QVERIFY(copy2.isEmpty());
+    QCOMPARE(moved.value(5), 50);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> empty;
+    QVERIFY(empty.begin() == empty.end());
+    QVERIFY(empty.constBegin() == empty.constEnd());
+
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, 2 * i);
+
+    int count = 0;
+    qint64 keySum = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), 2 * it.key());
+        keySum += it.key();
+        ++count;
+    }
+    QCOMPARE(count, 1000);
+    QCOMPARE(keySum, qint64(999 * 1000 / 2));
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = it.key();
+    for (int value : qAsConst(hash))
+        QCOMPARE(hash.value(value), value);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 1000);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), 999);
+    QCOMPARE(hash.values().size(), 1000);
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    const QFlatHash<int, int> copy = hash;
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+    QCOMPARE(copy.size(), 1000);
+}
+
+void tst_QFlatHash::stringKeys()
+{
+    QFlatHash<QString, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(QString::number(i), i);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(QString::number(i)), i);
+    QVERIFY(!hash.contains(QStringLiteral("foo")));
+    hash.remove(QStringLiteral("500"));
+    QCOMPARE(hash.size(), 999);
+    QCOMPARE(hash.value(QStringLiteral("500"), -1), -1);
+}
+
+void tst_QFlatHash::insertOwnElement()
+{
+    // the key and value refer to elements, which move when the table grows
+    QFlatHash<QString, QString> hash;
+    hash.insert(QStringLiteral("0"), QStringLiteral("value"));
+    for (int i = 1; i < 1000; ++i)
+        hash.insert(QString::number(i), hash[QString::number(i - 1)]);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(QString::number(i)), QStringLiteral("value"));
+
+    QFlatHash<QString, QString> chain;
+    chain.insert(QStringLiteral("a"), QStringLiteral("a0"));
+    for (int i = 0; i < 1000; ++i) {
+        const QString &value = chain.constFind(QStringLiteral("a")).value();
+        if (i % 2)
+            chain.insert(value, value);
+        else
+            chain[value] = value;
+        chain[QStringLiteral("a")] = QLatin1Char('a') + QString::number(i + 1);
+    }
+    QCOMPARE(chain.size(), 1001);
+    for (int i = 0; i < 1000; ++i) {
+        const QString key = QLatin1Char('a') + QString::number(i);
+        QCOMPARE(chain.value(key), key);
+    }
+}
+
+struct Counted
+{
+    static int instances;
+    Counted(int v = 0) : value(v) { ++instances; }
+    Counted(const Counted &o) : value(o.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &o) { value = o.value; return *this; }
+    bool operator==(const Counted &o) const { return value == o.value; }
+    int value;
+};
+int Counted::instances = 0;
+
+void tst_QFlatHash::complexValues()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::instances, 1000);
+        for (int i = 0; i < 500; ++i)
+            hash.remove(i);
+        QCOMPARE(Counted::instances, 500);
+
+        QFlatHash<int, Counted> copy = hash;
+        copy.insert(-1, Counted(-1));
+        QCOMPARE(Counted::instances, 1001);
+        copy.squeeze();
+        QCOMPARE(Counted::instances, 1001);
+        QCOMPARE(copy.value(600).value, 600);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+    b[50] = 0;
+    QVERIFY(a != b);
+    b.remove(50);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::matchesQHash()
+{
+    QFlatHash<int, int> flat;
+    QHash<int, int> reference;
+    uint seed = 42;
+    for (int i = 0; i < 200000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int key = int((seed >> 8) % 5000);
+        switch ((seed >> 4) % 3) {
+        case 0:
+        case 1:
+            flat.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), reference.remove(key));
+            break;
+        }
+    }
+    QCOMPARE(flat.size(), reference.size());
+    for (QHash<int, int>::const_iterator it = reference.cbegin(); it != reference.cend(); ++it)
+        QCOMPARE(flat.value(it.key(), -1), it.value());
+}
+
+void tst_QFlatHash::flatSet()
+{
+    QFlatSet<QString> set;
+    QVERIFY(set.isEmpty());
+    set.insert(QStringLiteral("a"));
+    set.insert(QStringLiteral("b"));
+    set.insert(QStringLiteral("a"));
+    QCOMPARE(set.size(), 2);
+    QVERIFY(set.contains(QStringLiteral("a")));
+    QVERIFY(!set.contains(QStringLiteral("c")));
+    QCOMPARE(*set.find(QStringLiteral("b")), QStringLiteral("b"));
+
+    QFlatSet<QString> copy = set;
+    QVERIFY(copy == set);
+    QVERIFY(copy.remove(QStringLiteral("a")));
+    QVERIFY(!copy.remove(QStringLiteral("a")));
+    QVERIFY(copy != set);
+    QCOMPARE(set.size(), 2);
+
+    QFlatSet<int> ints = { 3, 1, 2, 3 };
+    QCOMPARE(ints.size(), 3);
+    int sum = 0;
+    for (int i : ints)
+        sum += i;
+    QCOMPARE(sum, 6);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -51,6 +51,8 @@ private slots:
     void ungetChar();
     void indexOf();
     void appendAndRead();
+    void readPointers();
+    void appendShared();
     void peek();
     void readLine();
 };
@@ -348,6 +350,62 @@ void tst_QRingBuffer::appendAndRead()
     QCOMPARE(ringBuffer.read(), ba3);
 }
 
+void tst_QRingBuffer::readPointers()
+{
+    QRingBuffer ringBuffer(8);
+    const char *pointers[4];
+    qint64 lengths[4];
+    QCOMPARE(ringBuffer.readPointers(pointers, lengths, 4), 0);
+
+    QByteArray ba1("Hello world!");
+    QByteArray ba2("Test string.");
+    ringBuffer.append(ba1);
+    ringBuffer.append(ba2);
+    memcpy(ringBuffer.reserve(4), "tail", 4);
+    ringBuffer.free(6);
+
+    QCOMPARE(ringBuffer.readPointers(pointers, lengths, 4), 3);
+    QCOMPARE(QByteArray(pointers[0], lengths[0]), QByteArray("world!"));
+    // appended arrays stay shared after further appends
+    QVERIFY(pointers[0] == ba1.constData() + 6);
+    QVERIFY(pointers[1] == ba2.constData());
+    QCOMPARE(QByteArray(pointers[1], lengths[1]), ba2);
+    QCOMPARE(QByteArray(pointers[2], lengths[2]), QByteArray("tail"));
+
+    QCOMPARE(ringBuffer.readPointers(pointers, lengths, 2), 2);
+    QCOMPARE(lengths[0] + lengths[1], qint64(18));
+}
+
+void tst_QRingBuffer::appendShared()
+{
+    QRingBuffer ringBuffer(64);
+    QByteArray ba1(64, 'a');
+    QByteArray ba2(64, 'b');
+    ringBuffer.append(ba1);
+    ringBuffer.append("ccc", 3);
+    ringBuffer.append(ba2);
+    ringBuffer.append(ba1);
+    ringBuffer.putChar('d');
+    QCOMPARE(ringBuffer.size(), qint64(196));
+
+    const char *pointers[8];
+    qint64 lengths[8];
+    QCOMPARE(ringBuffer.readPointers(pointers, lengths, 8), 5);
+    QVERIFY(pointers[0] == ba1.constData());
+    QCOMPARE(QByteArray(pointers[1], lengths[1]), QByteArray("ccc"));
+    QVERIFY(pointers[2] == ba2.constData());
+    QVERIFY(pointers[3] == ba1.constData());
+    QCOMPARE(QByteArray(pointers[4], lengths[4]), QByteArray("d"));
+
+    // a shared array is not reused for new data once it has been read
+    ringBuffer.append(ba2);
+    QCOMPARE(ringBuffer.skip(196 + 64), qint64(196 + 64));
+    ringBuffer.append("eee", 3);
+    QCOMPARE(ba2, QByteArray(64, 'b'));
+    QCOMPARE(ringBuffer.read(), QByteArray("eee"));
+    QVERIFY(ba1.isDetached());
+}
+
 void tst_QRingBuffer::peek()
 {
     QRingBuffer ringBuffer;
@@ -506,6 +506,7 @@ private slots:
     void fromLatin1Roundtrip();
     void toLatin1Roundtrip_data();
     void toLatin1Roundtrip();
+    void longStrings();
     void stringRef_toLatin1Roundtrip_data();
     void stringRef_toLatin1Roundtrip();
     void stringRef_utf8_data();
@@ -4497,6 +4498,49 @@ void tst_QString::toLatin1Roundtrip()
     s.clear();
 }
 
+// The conversion, comparison and search functions process long strings in
+// blocks of up to 32 characters; check every position of the block and tail.
+void tst_QString::longStrings()
+{
+    for (int length = 1; length <= 100; ++length) {
+        const QString ascii(length, QLatin1Char('a'));
+        const QByteArray latin1(length, 'a');
+
+        QCOMPARE(QString::fromLatin1(latin1), ascii);
+        QCOMPARE(ascii.toLatin1(), latin1);
+        QCOMPARE(ascii, QLatin1String(latin1));
+        QVERIFY(ascii.compare(ascii.toUpper(), Qt::CaseInsensitive) == 0);
+        QCOMPARE(ascii.indexOf(QLatin1Char('b')), -1);
+
+        for (int i = 0; i < length; ++i) {
+            QString other = ascii;
+            other[i] = QLatin1Char('b');
+            QVERIFY2(ascii < other, qPrintable(QString::number(i)));
+            QVERIFY(other > ascii);
+            QVERIFY(ascii < QLatin1String(other.toLatin1()));
+            QVERIFY(QLatin1String(other.toLatin1()) > ascii);
+            QCOMPARE(other.indexOf(QLatin1Char('b')), i);
+            QCOMPARE(other.indexOf(QLatin1Char('b'), i), i);
+            QCOMPARE(other.indexOf(QLatin1Char('b'), i + 1), -1);
+            QVERIFY(ascii.compare(other.toUpper(), Qt::CaseInsensitive) < 0);
+            QVERIFY(other.compare(ascii.toUpper(), Qt::CaseInsensitive) > 0);
+
+            QString unicode = ascii;
+            unicode[i] = QChar(0x3b1);
+            QByteArray expected = latin1;
+            expected[i] = '?';
+            QCOMPARE(unicode.toLatin1(), expected);
+            QVERIFY(unicode.compare(ascii, Qt::CaseInsensitive) > 0);
+            QCOMPARE(unicode.indexOf(QChar(0x3b1)), i);
+
+            QByteArray high = latin1;
+            high[i] = char(0xe9);
+            QCOMPARE(QString::fromLatin1(high).at(i), QChar(0xe9));
+            QCOMPARE(QString::fromLatin1(high).toLatin1(), high);
+        }
+    }
+}
+
 void tst_QString::stringRef_toLatin1Roundtrip_data()
 {
     toLatin1Roundtrip_data();
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qstringarena
+QT = core testlib
+SOURCES = tst_qstringarena.cpp
@@ -0,0 +1,260 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qstringarena.h>
+
+class tst_QStringArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void strings();
+    void latin1();
+    void byteArrays();
+    void empty();
+    void nullTerminated();
+    void copiesShareData();
+    void detachOnWrite();
+    void largeStrings();
+    void intern();
+    void internByteArrays();
+    void clear();
+};
+
+void tst_QStringArena::strings()
+{
+    QStringArena arena;
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+
+    const QString hello = QStringLiteral("hello");
+    const QString s = arena.string(hello);
+    QCOMPARE(s, hello);
+    QCOMPARE(s.size(), 5);
+    QVERIFY(!s.isDetached());
+    QVERIFY(s.constData() != hello.constData());
+    QCOMPARE(s.constData()[s.size()], QChar());
+    QCOMPARE(arena.bytesAllocated(), qint64(QStringArena::DefaultBlockSize));
+
+    // many strings fit in a block, each with its own null terminator
+    QVector<QString> list;
+    for (int i = 0; i < 200; ++i)
+        list.append(arena.string(QString::number(i)));
+    for (int i = 0; i < 200; ++i) {
+        QCOMPARE(list.at(i), QString::number(i));
+        QCOMPARE(list.at(i).constData()[list.at(i).size()], QChar());
+        QCOMPARE(quintptr(list.at(i).constData()) % sizeof(QChar), quintptr(0));
+    }
+    QCOMPARE(arena.bytesAllocated(), qint64(QStringArena::DefaultBlockSize) * 2);
+    QCOMPARE(s, hello);
+}
+
+void tst_QStringArena::latin1()
+{
+    QStringArena arena;
+    const QString s = arena.string(QLatin1String("Gr\xfc\xdf" "e"));
+    QCOMPARE(s, QString::fromLatin1("Gr\xfc\xdf" "e"));
+    QVERIFY(!s.isDetached());
+    QCOMPARE(s.constData()[s.size()], QChar());
+}
+
+void tst_QStringArena::byteArrays()
+{
+    QStringArena arena;
+    const QByteArray s = arena.byteArray("hello world", 5);
+    QCOMPARE(s, QByteArray("hello"));
+    QCOMPARE(s.constData()[5], '\0');
+    QVERIFY(!s.isDetached());
+
+    const QByteArray t = arena.byteArray(QByteArray("odd"));
+    QCOMPARE(t, QByteArray("odd"));
+    QCOMPARE(quintptr(t.constData()) % sizeof(void *), quintptr(0));
+    QCOMPARE(s, QByteArray("hello"));
+}
+
+void tst_QStringArena::empty()
+{
+    QStringArena arena;
+    QVERIFY(arena.string(nullptr, 0).isNull());
+    QVERIFY(!arena.string(QString("")).isNull());
+    QVERIFY(arena.string(QString("")).isEmpty());
+    QVERIFY(arena.string(QLatin1String("")).isEmpty());
+    QVERIFY(arena.byteArray(nullptr, 0).isNull());
+    QVERIFY(arena.byteArray(QByteArray("")).isEmpty());
+    QVERIFY(arena.intern(QString()).isNull());
+    QVERIFY(arena.intern(QByteArray("")).isEmpty());
+    QCOMPARE(arena.internedCount(), 0);
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+}
+
+void tst_QStringArena::nullTerminated()
+{
+    QStringArena arena;
+    const QString text = QStringLiteral("text");
+    QCOMPARE(arena.string(text.constData(), -1), text);
+    QCOMPARE(arena.intern(text.constData(), -1), text);
+    QCOMPARE(arena.byteArray("bytes", -1), QByteArray("bytes"));
+    QCOMPARE(arena.intern("bytes", -1), QByteArray("bytes"));
+    QCOMPARE(arena.internedCount(), 2);
+
+    QVERIFY(arena.string(nullptr, -1).isNull());
+    QVERIFY(arena.byteArray(nullptr, -1).isNull());
+    QVERIFY(!arena.byteArray("", -1).isNull());
+    QVERIFY(arena.byteArray("", -1).isEmpty());
+}
+
+void tst_QStringArena::copiesShareData()
+{
+    QStringArena arena;
+    const QString s = arena.string(QStringLiteral("shared"));
+    QString copy = s;
+    QCOMPARE(copy.constData(), s.constData());
+
+    QString assigned;
+    assigned = copy;
+    QCOMPARE(assigned.constData(), s.constData());
+
+    QHash<QString, int> hash;
+    hash.insert(s, 1);
+    QCOMPARE(hash.constBegin().key().constData(), s.constData());
+}
+
+void tst_QStringArena::detachOnWrite()
+{
+    QStringArena arena;
+    QString copy;
+    QString other;
+    QByteArray ba;
+    {
+        const QString s = arena.string(QStringLiteral("text"));
+        copy = s;
+        copy.append(QLatin1String(" more"));
+        QCOMPARE(copy, QStringLiteral("text more"));
+        QCOMPARE(s, QStringLiteral("text"));
+
+        other = s;
+        other[0] = QLatin1Char('n');
+        QCOMPARE(other, QStringLiteral("next"));
+        QCOMPARE(s, QStringLiteral("text"));
+
+        ba = arena.byteArray("bytes", 5);
+        const QByteArray original = ba;
+        ba.data()[0] = 'B';
+        QCOMPARE(ba, QByteArray("Bytes"));
+        QCOMPARE(original, QByteArray("bytes"));
+    }
+
+    // copies that were detached outlive the arena's memory
+    arena.clear();
+    QCOMPARE(copy, QStringLiteral("text more"));
+    QCOMPARE(other, QStringLiteral("next"));
+    QCOMPARE(ba, QByteArray("Bytes"));
+}
+
+void tst_QStringArena::largeStrings()
+{
+    QStringArena arena(1024);
+    const QString small = arena.string(QStringLiteral("small"));
+    QCOMPARE(arena.bytesAllocated(), qint64(1024));
+
+    // too large to share a block: gets its own and leaves the current one alone
+    const QString large(1000, QLatin1Char('x'));
+    const QString s = arena.string(large);
+    QCOMPARE(s, large);
+    QCOMPARE(s.constData()[s.size()], QChar());
+    QVERIFY(arena.bytesAllocated() > 1024 + 2000);
+    const qint64 allocated = arena.bytesAllocated();
+
+    const QString next = arena.string(QStringLiteral("next"));
+    QCOMPARE(next, QStringLiteral("next"));
+    QCOMPARE(arena.bytesAllocated(), allocated);
+    QCOMPARE(small, QStringLiteral("small"));
+}
+
+void tst_QStringArena::intern()
+{
+    QStringArena arena;
+    const QString a = arena.intern(QStringLiteral("key"));
+    const QString b = arena.intern(QString::fromLatin1("key"));
+    QCOMPARE(a, QStringLiteral("key"));
+    QCOMPARE(a.constData(), b.constData());
+    QCOMPARE(arena.internedCount(), 1);
+
+    // looking up an interned string allocates nothing
+    const qint64 allocated = arena.bytesAllocated();
+    const QString text = QStringLiteral("a key in a text");
+    const QString c = arena.intern(text.constData() + 2, 3);
+    QCOMPARE(c.constData(), a.constData());
+    QCOMPARE(arena.bytesAllocated(), allocated);
+
+    const QString d = arena.intern(text.constData(), 1);
+    QCOMPARE(d, QStringLiteral("a"));
+    QCOMPARE(arena.internedCount(), 2);
+
+    // not interned: a new copy every time
+    QVERIFY(arena.string(a).constData() != a.constData());
+
+    QSet<const QChar *> distinct;
+    for (int i = 0; i < 1000; ++i)
+        distinct.insert(arena.intern(QString::number(i % 10)).constData());
+    QCOMPARE(distinct.size(), 10);
+    QCOMPARE(arena.internedCount(), 12);
+}
+
+void tst_QStringArena::internByteArrays()
+{
+    QStringArena arena;
+    const QByteArray a = arena.intern(QByteArray("key"));
+    const QByteArray b = arena.intern("keys", 3);
+    QCOMPARE(a, QByteArray("key"));
+    QCOMPARE(a.constData(), b.constData());
+    QCOMPARE(b.constData()[3], '\0');
+
+    // strings and byte arrays are interned separately
+    arena.intern(QStringLiteral("key"));
+    QCOMPARE(arena.internedCount(), 2);
+}
+
+void tst_QStringArena::clear()
+{
+    QStringArena arena;
+    arena.intern(QStringLiteral("one"));
+    arena.string(QStringLiteral("two"));
+    QVERIFY(arena.bytesAllocated() > 0);
+
+    arena.clear();
+    QCOMPARE(arena.internedCount(), 0);
+    QCOMPARE(arena.bytesAllocated(), qint64(0));
+
+    const QString s = arena.intern(QStringLiteral("three"));
+    QCOMPARE(s, QStringLiteral("three"));
+    QCOMPARE(arena.internedCount(), 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QStringArena)
+#include "tst_qstringarena.moc"
@@ -19,6 +19,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -49,6 +50,7 @@ SUBDIRS=\
     qsizef \
     qstl \
     qstring \
+    qstringarena \
     qstring_no_cast_from_bytearray \
     qstringapisymmetry \
     qstringbuilder \
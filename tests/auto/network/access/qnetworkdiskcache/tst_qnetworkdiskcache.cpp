@@ -68,6 +68,8 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void indexed();
+    void indexedExpire();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -527,6 +529,96 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+void tst_QNetworkDiskCache::indexed()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QUrl url(EXAMPLE_URL);
+    qint64 size;
+    QString indexFileName;
+    {
+        SubQNetworkDiskCache cache;
+        cache.setIndexEnabled(true);
+        QVERIFY(cache.isIndexEnabled());
+        cache.setupWithOne(dir.path(), url);
+        indexFileName = cache.cacheDirectory() + QLatin1String("data8/index");
+        QVERIFY(QFile::exists(indexFileName));
+
+        size = cache.cacheSize();
+        QVERIFY(size > 0);
+        QVERIFY(cache.metaData(url).isValid());
+        QScopedPointer<QIODevice> d(cache.data(url));
+        QVERIFY(d);
+        QCOMPARE(d->readAll(), QByteArray("Hello World!"));
+        QVERIFY(!cache.metaData(QUrl("http://localhost:4/notcached")).isValid());
+        QVERIFY(!cache.data(QUrl("http://localhost:4/notcached")));
+
+        // keep the entry when the cache goes away
+        cache.setCacheDirectory(dir.path() + QLatin1String("/other"));
+    }
+
+    // the index is read back
+    {
+        QNetworkDiskCache cache;
+        cache.setIndexEnabled(true);
+        cache.setCacheDirectory(dir.path());
+        QCOMPARE(cache.cacheSize(), size);
+        QVERIFY(cache.metaData(url).isValid());
+    }
+
+    // a missing index is rebuilt from the cache directory
+    QVERIFY(QFile::remove(indexFileName));
+    {
+        SubQNetworkDiskCache cache;
+        cache.setIndexEnabled(true);
+        cache.setCacheDirectory(dir.path());
+        QCOMPARE(cache.cacheSize(), size);
+        QVERIFY(cache.metaData(url).isValid());
+
+        QVERIFY(cache.remove(url));
+        QVERIFY(!cache.metaData(url).isValid());
+        QCOMPARE(cache.cacheSize(), qint64(0));
+
+        cache.setIndexEnabled(false);
+        QVERIFY(!QFile::exists(indexFileName));
+    }
+}
+
+void tst_QNetworkDiskCache::indexedExpire()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    SubQNetworkDiskCache cache;
+    cache.setIndexEnabled(true);
+    cache.setCacheDirectory(dir.path());
+    const qint64 limit = (1024 * 1024 / 4) * 5;
+    cache.setMaximumCacheSize(limit);
+
+    const QByteArray bigString(1024 * 1024 / 4, 'Z');
+    for (int i = 0; i < 10; ++i) {
+        QNetworkCacheMetaData m;
+        m.setUrl(QUrl("http://localhost:4/" + QString::number(i)));
+        if (i == 8)
+            m.setExpirationDate(QDateTime::currentDateTime().addSecs(-60));
+        QIODevice *d = cache.prepare(m);
+        d->write(bigString);
+        cache.insert(d);
+        QVERIFY(cache.call_expire() < limit);
+
+        // keep the first entry in use
+        delete cache.data(QUrl("http://localhost:4/0"));
+        QTest::qWait(5);
+    }
+
+    QStringList cached;
+    for (int i = 0; i < 10; ++i) {
+        if (cache.metaData(QUrl("http://localhost:4/" + QString::number(i))).isValid())
+            cached << QString::number(i);
+    }
+    // the expired entry goes first, then the least recently used ones
+    QCOMPARE(cached, QStringList() << "0" << "6" << "7" << "9");
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
@@ -108,6 +108,7 @@ private slots:
     void multipleDifferentLookups();
 
     void cache();
+    void cacheTimeToLive();
 
     void abortHostLookup();
 protected slots:
@@ -553,6 +554,52 @@ void tst_QHostInfo::cache()
     QCOMPARE(lookupsDoneCounter, 2);
 }
 
+void tst_QHostInfo::cacheTimeToLive()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    bool valid = false;
+    int id = -1;
+
+    // names that do not exist are cached too
+    QHostInfo notFound;
+    notFound.setError(QHostInfo::HostNotFound);
+    qt_qhostinfo_cache_inject("notfound.invalid", notFound);
+    QHostInfo result = qt_qhostinfo_lookup("notfound.invalid", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.error(), QHostInfo::HostNotFound);
+
+    // ... but do not replace a valid entry
+    QHostInfo found;
+    found.setAddresses(QList<QHostAddress>() << QHostAddress("192.0.2.1"));
+    qt_qhostinfo_cache_inject("ttl.invalid", found);
+    qt_qhostinfo_cache_inject("ttl.invalid", notFound);
+    result = qt_qhostinfo_lookup("ttl.invalid", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.addresses(), found.addresses());
+
+    // the time to live of the DNS records overrides the default
+    qt_qhostinfo_cache_set_ttl("ttl.invalid", 1);
+    result = qt_qhostinfo_lookup("ttl.invalid", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QTest::qSleep(1100);
+    result = qt_qhostinfo_lookup("ttl.invalid", 0, 0, &valid, &id);
+    QVERIFY(!valid);
+
+    // a time to live known before the result applies to it
+    qt_qhostinfo_cache_set_ttl("ttl2.invalid", 1);
+    qt_qhostinfo_lookup("ttl2.invalid", 0, 0, &valid, &id);
+    QVERIFY(!valid);
+    qt_qhostinfo_cache_inject("ttl2.invalid", found);
+    qt_qhostinfo_lookup("ttl2.invalid", 0, 0, &valid, &id);
+    QVERIFY(valid);
+    QTest::qSleep(1100);
+    qt_qhostinfo_lookup("ttl2.invalid", 0, 0, &valid, &id);
+    QVERIFY(!valid);
+}
+
 void tst_QHostInfo::resultsReady(const QHostInfo &hi)
 {
     lookupDone = true;
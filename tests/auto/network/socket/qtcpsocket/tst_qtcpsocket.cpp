@@ -198,6 +198,7 @@ private slots:
     void serverDisconnectWithBuffered();
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
+    void writeRawData();
     void readNotificationsAfterBind();
 
 protected slots:
@@ -3116,6 +3117,42 @@ void tst_QTcpSocket::writeOnReadBufferOverflow()
     delete socket;
 }
 
+// Test that the contents of an array that does not own them are copied
+void tst_QTcpSocket::writeRawData()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer tcpServer;
+    QTcpSocket *socket = newSocket();
+
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY2(tcpServer.waitForNewConnection(5000), "Network timeout");
+    QTcpSocket *newConnection = tcpServer.nextPendingConnection();
+    QVERIFY(newConnection != nullptr);
+
+    const QByteArray expected(64 * 1024, 'a');
+    QByteArray data = expected;
+    data.detach();
+    const qint64 written = socket->write(QByteArray::fromRawData(data.constData(), data.size()));
+    QCOMPARE(written, qint64(expected.size()));
+    // nothing has been sent yet
+    data.fill('b');
+
+    while (socket->bytesToWrite() > 0)
+        QVERIFY(socket->waitForBytesWritten(5000));
+    QByteArray received;
+    while (received.size() < expected.size() && newConnection->waitForReadyRead(5000))
+        received += newConnection->readAll();
+    QCOMPARE(received, expected);
+
+    delete newConnection;
+    delete socket;
+}
+
 // Test that the socket does not enable the read notifications in bind()
 void tst_QTcpSocket::readNotificationsAfterBind()
 {
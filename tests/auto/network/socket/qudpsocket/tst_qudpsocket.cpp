@@ -88,6 +88,7 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void batchedDatagrams();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1105,6 +1106,54 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+#ifdef FORCE_SESSION
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(receiver.bind(QHostAddress::LocalHost));
+
+    QUdpSocket sender;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(sender.bind(QHostAddress::LocalHost));
+
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 10; ++i)
+        datagrams << QNetworkDatagram(QByteArray(i * 100, char('a' + i)), QHostAddress::LocalHost, receiver.localPort());
+    QSignalSpy bytesWrittenSpy(&sender, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(sender.writeDatagrams(datagrams), 10);
+    QCOMPARE(bytesWrittenSpy.count(), 1);
+    QCOMPARE(bytesWrittenSpy.at(0).at(0).toLongLong(), qint64(4500));
+
+    QVector<QNetworkDatagram> received;
+    while (received.size() < 10) {
+        if (!receiver.hasPendingDatagrams())
+            QVERIFY2(receiver.waitForReadyRead(5000), QtNetworkSettings::msgSocketError(receiver).constData());
+        // the first batch reads datagrams of any size, later ones truncate
+        received += receiver.receiveDatagrams(received.isEmpty() ? 5 : 20, received.isEmpty() ? -1 : 500);
+    }
+    QVERIFY(!receiver.hasPendingDatagrams());
+    QVERIFY(receiver.receiveDatagrams(10).isEmpty());
+    // the count is clamped rather than sizing a buffer for INT_MAX datagrams
+    QVERIFY(receiver.receiveDatagrams(INT_MAX).isEmpty());
+
+    for (int i = 0; i < 10; ++i) {
+        const QNetworkDatagram &dgram = received.at(i);
+        QVERIFY(dgram.isValid());
+        QCOMPARE(dgram.data(), datagrams.at(i).data().left(500));
+        QCOMPARE(dgram.senderAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(dgram.senderPort(), int(sender.localPort()));
+        QCOMPARE(dgram.destinationPort(), int(receiver.localPort()));
+    }
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
@@ -223,6 +223,7 @@ private slots:
 #ifndef QT_NO_OPENSSL
     void dhServerCustomParamsNull();
     void dhServerCustomParams();
+    void sessionSharing();
 #endif
     void ecdhServer();
     void verifyClientCertificate_data();
@@ -2973,6 +2974,81 @@ void tst_QSslSocket::dhServerCustomParams()
 }
 #endif // QT_NO_OPENSSL
 
+#ifndef QT_NO_OPENSSL
+void tst_QSslSocket::sessionSharing()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("No SSL support");
+
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    SslServer server(SRCDIR "certs/bogus-server.key", SRCDIR "certs/bogus-server.crt");
+    QVERIFY(server.listen());
+
+    const QList<QSslCertificate> caCertificates = QSslCertificate::fromPath(SRCDIR "certs/bogus-ca.crt");
+    QVERIFY(!caCertificates.isEmpty());
+
+    // Every client is a new socket, so a session can only be resumed through
+    // the caches shared by all sockets.
+    bool resumed = false;
+    int clientVerifyDepth = 0;
+    auto connectClient = [&](const QList<QSslCertificate> &clientCaCertificates) {
+        QSslSocket client;
+        client.setCaCertificates(clientCaCertificates);
+        client.setPeerVerifyDepth(clientVerifyDepth);
+        client.setPeerVerifyName(QStringLiteral("Bogus Server"));
+
+        QEventLoop loop;
+        QTimer::singleShot(5000, &loop, SLOT(quit()));
+        connect(&client, SIGNAL(error(QAbstractSocket::SocketError)), &loop, SLOT(quit()));
+        connect(&client, SIGNAL(encrypted()), &loop, SLOT(quit()));
+        client.connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+        loop.exec();
+
+        QVERIFY2(client.isEncrypted(), qPrintable(client.errorString()));
+        QVERIFY(client.sslErrors().isEmpty());
+        resumed = QSslConfigurationPrivate::peerSessionWasShared(client.sslConfiguration());
+    };
+
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+    connectClient(caCertificates);
+    QVERIFY(resumed);
+
+    // a client that verifies the server differently does not resume it
+    connectClient(caCertificates + QSslCertificate::fromPath(SRCDIR "certs/ca.crt"));
+    QVERIFY(!resumed);
+    clientVerifyDepth = 2;
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+    connectClient(caCertificates);
+    QVERIFY(resumed);
+    clientVerifyDepth = 0;
+
+    // nor does the server, when it would verify the client differently
+    server.addCaCertificates = QLatin1String(SRCDIR "certs/bogus-ca.crt");
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+    connectClient(caCertificates);
+    QVERIFY(resumed);
+
+    server.config.setPeerVerifyDepth(2);
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+    connectClient(caCertificates);
+    QVERIFY(resumed);
+
+    // no sharing at all when it is disabled
+    server.config.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+    connectClient(caCertificates);
+    QVERIFY(!resumed);
+}
+#endif // QT_NO_OPENSSL
+
 void tst_QSslSocket::ecdhServer()
 {
     if (!QSslSocket::supportsSsl()) {
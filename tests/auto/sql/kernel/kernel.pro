@@ -9,3 +9,4 @@ SUBDIRS=\
    qsqlthread \
    qsql \
    qsqlresult \
+   qsqlasyncresult \
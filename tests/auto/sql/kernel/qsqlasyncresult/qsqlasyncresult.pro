@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlasyncresult
+SOURCES  += tst_qsqlasyncresult.cpp
+
+QT = core sql testlib core-private sql-private
@@ -0,0 +1,263 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include "../qsqldatabase/tst_databases.h"
+
+const QString qtest(qTableName("qtest", __FILE__, QSqlDatabase()));
+
+class tst_QSqlAsyncResult : public QObject
+{
+    Q_OBJECT
+
+public:
+    void generic_data(const QString &engine = QString());
+    tst_Databases dbs;
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void select_data() { generic_data(); }
+    void select();
+    void boundValues_data() { generic_data(); }
+    void boundValues();
+    void error_data() { generic_data(); }
+    void error();
+    void nonSelect_data() { generic_data(); }
+    void nonSelect();
+    void concurrentQueries_data() { generic_data(); }
+    void concurrentQueries();
+    void queueOrder_data() { generic_data(); }
+    void queueOrder();
+    void watcher_data() { generic_data(); }
+    void watcher();
+    void invalidConnection();
+    void swap();
+};
+
+void tst_QSqlAsyncResult::generic_data(const QString &engine)
+{
+    if (dbs.fillTestTable(engine) == 0) {
+        if (engine.isEmpty())
+            QSKIP("No database drivers are available in this Qt configuration");
+        else
+            QSKIP(QString("No database drivers of type %1 are available in this Qt configuration").arg(engine).toLocal8Bit());
+    }
+}
+
+void tst_QSqlAsyncResult::initTestCase()
+{
+    QVERIFY(dbs.open());
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        CHECK_DATABASE(db);
+        tst_Databases::safeDropTable(db, qtest);
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("create table " + qtest + " (id int not null primary key, name varchar(20))"));
+        QVERIFY_SQL(q, prepare("insert into " + qtest + " values (?, ?)"));
+        for (int i = 0; i < 100; ++i) {
+            q.addBindValue(i);
+            q.addBindValue(QString("name %1").arg(i));
+            QVERIFY_SQL(q, exec());
+        }
+    }
+}
+
+void tst_QSqlAsyncResult::cleanupTestCase()
+{
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        tst_Databases::safeDropTable(db, qtest);
+    }
+    dbs.close();
+}
+
+#define CHECK_ASYNC_DATABASE(db) \
+    CHECK_DATABASE(db); \
+    if (db.databaseName() == ":memory:") \
+        QSKIP("in-memory databases are not shared with the worker connections")
+
+void tst_QSqlAsyncResult::select()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    QFuture<QSqlAsyncResult> future = db.execAsync("select id, name from " + qtest + " where id < 10 order by id");
+    const QSqlAsyncResult result = future.result();
+    QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+    QVERIFY(result.isSelect());
+    QCOMPARE(result.size(), 10);
+    QCOMPARE(result.record().count(), 2);
+    QCOMPARE(result.record().fieldName(1).toLower(), QString("name"));
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(result.value(i, 0).toInt(), i);
+        QCOMPARE(result.value(i, 1).toString(), QString("name %1").arg(i));
+        QCOMPARE(result.record(i).value("name").toString(), QString("name %1").arg(i));
+    }
+    QVERIFY(!result.value(10, 0).isValid());
+    QVERIFY(!result.value(0, 2).isValid());
+    QVERIFY(!result.value(-1, 0).isValid());
+}
+
+void tst_QSqlAsyncResult::boundValues()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    const QSqlAsyncResult result = db.execAsync("select name from " + qtest + " where id = ? or id = ? order by id",
+                                                QVariantList() << 42 << 7).result();
+    QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result.value(0, 0).toString(), QString("name 7"));
+    QCOMPARE(result.value(1, 0).toString(), QString("name 42"));
+}
+
+void tst_QSqlAsyncResult::error()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    const QSqlAsyncResult result = db.execAsync("select * from " + qtest + "_does_not_exist").result();
+    QVERIFY(!result.isActive());
+    QVERIFY(result.lastError().isValid());
+    QCOMPARE(result.size(), 0);
+    QVERIFY(!result.value(0, 0).isValid());
+}
+
+void tst_QSqlAsyncResult::nonSelect()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    QSqlAsyncResult result = db.execAsync("update " + qtest + " set name = ? where id >= ?",
+                                          QVariantList() << QString("updated") << 95).result();
+    QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+    QVERIFY(!result.isSelect());
+    QCOMPARE(result.numRowsAffected(), 5);
+    QCOMPARE(result.size(), 0);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("select count(*) from " + qtest + " where name = 'updated'"));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 5);
+}
+
+void tst_QSqlAsyncResult::concurrentQueries()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    db.setMaxAsyncConnectionCount(4);
+    QCOMPARE(db.maxAsyncConnectionCount(), 4);
+    QVector<QFuture<QSqlAsyncResult> > futures;
+    for (int i = 0; i < 50; ++i)
+        futures << db.execAsync("select count(*) from " + qtest + " where id < ?", QVariantList() << i);
+    for (int i = 0; i < futures.count(); ++i) {
+        const QSqlAsyncResult result = futures.at(i).result();
+        QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+        QCOMPARE(result.value(0, 0).toInt(), i);
+    }
+    db.setMaxAsyncConnectionCount(1);
+}
+
+void tst_QSqlAsyncResult::queueOrder()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    // with a single connection the statements run in the order they were queued
+    QCOMPARE(db.maxAsyncConnectionCount(), 1);
+    const QString table = qTableName("asyncorder", __FILE__, db);
+    tst_Databases::safeDropTable(db, table);
+    db.execAsync("create table " + table + " (id int)");
+    QVector<QFuture<QSqlAsyncResult> > futures;
+    for (int i = 0; i < 20; ++i)
+        futures << db.execAsync("insert into " + table + " values (?)", QVariantList() << i);
+    QSqlAsyncResult result = db.execAsync("select count(*) from " + table).result();
+    for (const QFuture<QSqlAsyncResult> &future : qAsConst(futures))
+        QVERIFY(future.isFinished());
+    QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+    QCOMPARE(result.value(0, 0).toInt(), 20);
+    db.execAsync("drop table " + table).waitForFinished();
+}
+
+void tst_QSqlAsyncResult::watcher()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_ASYNC_DATABASE(db);
+
+    QFutureWatcher<QSqlAsyncResult> watcher;
+    QSignalSpy spy(&watcher, &QFutureWatcherBase::finished);
+    watcher.setFuture(db.execAsync("select name from " + qtest + " where id = 3"));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(watcher.result().value(0, 0).toString(), QString("name 3"));
+}
+
+void tst_QSqlAsyncResult::invalidConnection()
+{
+    QSqlDatabase db;
+    QVERIFY(!db.isValid());
+    db.setMaxAsyncConnectionCount(4);
+    QCOMPARE(db.maxAsyncConnectionCount(), 1);
+    QCOMPARE(QSqlDatabase().maxAsyncConnectionCount(), 1);
+
+    QFuture<QSqlAsyncResult> future = db.execAsync("select 1");
+    QVERIFY(future.isFinished());
+    const QSqlAsyncResult result = future.result();
+    QVERIFY(!result.isActive());
+    QCOMPARE(result.lastError().type(), QSqlError::ConnectionError);
+}
+
+void tst_QSqlAsyncResult::swap()
+{
+    QSqlAsyncResult failed = QSqlDatabase().execAsync("select 1").result();
+    QSqlAsyncResult empty;
+    QVERIFY(failed.lastError().isValid());
+    QVERIFY(!empty.lastError().isValid());
+
+    failed.swap(empty);
+    QVERIFY(!failed.lastError().isValid());
+    QVERIFY(empty.lastError().isValid());
+
+    failed = std::move(empty);
+    QVERIFY(failed.lastError().isValid());
+}
+
+QTEST_MAIN(tst_QSqlAsyncResult)
+#include "tst_qsqlasyncresult.moc"
@@ -73,6 +73,13 @@ private slots:
     void eventNotification_data() { generic_data(); }
     void eventNotification();
     void addDatabase();
+    void connectionPool_data() { generic_data(); }
+    void connectionPool();
+    void connectionPoolThreads_data() { generic_data(); }
+    void connectionPoolThreads();
+    void connectionPoolMinimum_data() { generic_data(); }
+    void connectionPoolMinimum();
+    void connectionPoolDriverInstance();
     void errorReporting_data();
     void errorReporting();
 
@@ -438,6 +445,164 @@ void tst_QSqlDatabase::addDatabase()
     QVERIFY(!QSqlDatabase::contains("INVALID_CONNECTION"));
 }
 
+void tst_QSqlDatabase::connectionPool()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlDatabase::setConnectionPoolLimits(dbName, 0, 2);
+    QSqlDatabase first = QSqlDatabase::acquireConnection(dbName);
+    QVERIFY(first.isValid());
+    QVERIFY(first.isOpen());
+    QVERIFY(first.driver() != db.driver());
+    QCOMPARE(first.driverName(), db.driverName());
+    QCOMPARE(first.databaseName(), db.databaseName());
+
+    // every checkout gets a connection of its own, also in the same thread
+    QSqlDatabase second = QSqlDatabase::acquireConnection(dbName);
+    QVERIFY(second.isOpen());
+    QVERIFY(second.driver() != first.driver());
+    QSqlConnectionPoolStatistics statistics = QSqlDatabase::connectionPoolStatistics(dbName);
+    QCOMPARE(statistics.connectionCount(), 2);
+    QCOMPARE(statistics.idleCount(), 0);
+    QSqlDatabase::releaseConnection(second);
+    QSqlDatabase::releaseConnection(first);
+    statistics = QSqlDatabase::connectionPoolStatistics(dbName);
+    QCOMPARE(statistics.connectionCount(), 2);
+    QCOMPARE(statistics.idleCount(), 2);
+    QCOMPARE(statistics.checkoutCount(), 2);
+    QCOMPARE(statistics.waitCount(), 0);
+
+    QTest::ignoreMessage(QtWarningMsg, "QSqlDatabase::releaseConnection: connection is not checked out");
+    QSqlDatabase::releaseConnection(first);
+    QTest::ignoreMessage(QtWarningMsg, "QSqlDatabase::releaseConnection: connection was not acquired from a pool");
+    QSqlDatabase::releaseConnection(db);
+
+    // idle connections are reused, and reopened when they are not usable
+    const QSqlDriver *driver = first.driver();
+    first.close();
+    QSqlDatabase::setConnectionPoolHealthCheck(dbName, QLatin1String("this is not sql"));
+    QSqlDatabase reused = QSqlDatabase::acquireConnection(dbName);
+    QCOMPARE(reused.driver(), driver);
+    QVERIFY(reused.isOpen());
+    QSqlDatabase::releaseConnection(reused);
+    QSqlDatabase::setConnectionPoolHealthCheck(dbName, QString());
+
+    QTest::qSleep(10);
+    QSqlDatabase::setConnectionPoolIdleTimeout(dbName, 0);
+    statistics = QSqlDatabase::connectionPoolStatistics(dbName);
+    QCOMPARE(statistics.connectionCount(), 0);
+    QCOMPARE(statistics.checkoutCount(), 3);
+    QSqlDatabase::setConnectionPoolIdleTimeout(dbName, 60000);
+    QSqlDatabase::setConnectionPoolLimits(dbName, 0, 10);
+}
+
+class PoolThread : public QThread
+{
+public:
+    PoolThread(const QString &connectionName, int timeout)
+        : connectionName(connectionName), timeout(timeout), acquired(false) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QSqlDatabase db = QSqlDatabase::acquireConnection(connectionName, timeout);
+        acquired = db.isOpen();
+        if (db.isValid())
+            QSqlDatabase::releaseConnection(db);
+    }
+
+    QString connectionName;
+    int timeout;
+    bool acquired;
+};
+
+void tst_QSqlDatabase::connectionPoolThreads()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlDatabase::setConnectionPoolLimits(dbName, 0, 1);
+    QSqlDatabase held = QSqlDatabase::acquireConnection(dbName);
+    QVERIFY(held.isOpen());
+    const QSqlConnectionPoolStatistics before = QSqlDatabase::connectionPoolStatistics(dbName);
+
+    QTest::ignoreMessage(QtWarningMsg, qPrintable(QLatin1String("QSqlDatabase::acquireConnection: timed out waiting for a connection to '")
+                                                  + dbName + QLatin1Char('\'')));
+    PoolThread timingOut(dbName, 50);
+    timingOut.start();
+    QVERIFY(timingOut.wait());
+    QVERIFY(!timingOut.acquired);
+
+    PoolThread waiting(dbName, -1);
+    waiting.start();
+    QVERIFY(!waiting.wait(50));
+    QSqlDatabase::releaseConnection(held);
+    QVERIFY(waiting.wait());
+    QVERIFY(waiting.acquired);
+
+    const QSqlConnectionPoolStatistics after = QSqlDatabase::connectionPoolStatistics(dbName);
+    QCOMPARE(after.connectionCount(), 1);
+    QCOMPARE(after.idleCount(), 1);
+    QCOMPARE(after.timeoutCount(), before.timeoutCount() + 1);
+    QCOMPARE(after.waitCount(), before.waitCount() + 1);
+    QCOMPARE(after.checkoutCount(), before.checkoutCount() + 1);
+    QVERIFY(after.maxWaitTime() >= 50000);
+    QSqlDatabase::setConnectionPoolLimits(dbName, 0, 10);
+}
+
+void tst_QSqlDatabase::connectionPoolMinimum()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    // the minimum number of connections is opened up front, and kept open
+    QSqlDatabase::setConnectionPoolIdleTimeout(dbName, 100);
+    QSqlDatabase::setConnectionPoolLimits(dbName, 2, 10);
+    QSqlConnectionPoolStatistics statistics = QSqlDatabase::connectionPoolStatistics(dbName);
+    QCOMPARE(statistics.connectionCount(), 2);
+    QCOMPARE(statistics.idleCount(), 2);
+
+    // the others are closed once they are idle, even if the pool is not used
+    QVector<QSqlDatabase> connections;
+    QVector<QPointer<QSqlDriver> > drivers;
+    for (int i = 0; i < 3; ++i) {
+        connections << QSqlDatabase::acquireConnection(dbName);
+        QVERIFY(connections.last().isOpen());
+        drivers << connections.last().driver();
+    }
+    for (const QSqlDatabase &connection : qAsConst(connections))
+        QSqlDatabase::releaseConnection(connection);
+    connections.clear();
+    QTRY_COMPARE(drivers.count(QPointer<QSqlDriver>()), 1);
+    QCOMPARE(QSqlDatabase::connectionPoolStatistics(dbName).connectionCount(), 2);
+
+    QSqlDatabase::setConnectionPoolLimits(dbName, 0, 10);
+    QSqlDatabase::setConnectionPoolIdleTimeout(dbName, 60000);
+}
+
+class PoolTestDriver : public QSqlDriver
+{
+public:
+    bool hasFeature(DriverFeature) const Q_DECL_OVERRIDE { return false; }
+    bool open(const QString &, const QString &, const QString &, const QString &, int,
+              const QString &) Q_DECL_OVERRIDE { return false; }
+    void close() Q_DECL_OVERRIDE {}
+    QSqlResult *createResult() const Q_DECL_OVERRIDE { return 0; }
+};
+
+void tst_QSqlDatabase::connectionPoolDriverInstance()
+{
+    // a driver instance cannot be copied for the pooled connections
+    QSqlDatabase::addDatabase(new PoolTestDriver, QLatin1String("poolDriverInstance"));
+    QTest::ignoreMessage(QtWarningMsg, "QSqlDatabase::acquireConnection: connection 'poolDriverInstance' "
+                                       "was added with a driver instance and cannot be pooled");
+    QVERIFY(!QSqlDatabase::acquireConnection(QLatin1String("poolDriverInstance")).isValid());
+    QSqlDatabase::removeDatabase(QLatin1String("poolDriverInstance"));
+}
+
 void tst_QSqlDatabase::errorReporting_data()
 {
     QTest::addColumn<QString>("driver");
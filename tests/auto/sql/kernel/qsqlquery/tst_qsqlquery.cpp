@@ -233,6 +233,12 @@ private slots:
 
     void sqlite_constraint_data() { generic_data("QSQLITE"); }
     void sqlite_constraint();
+    void sqlite_batchExecRollback_data() { generic_data("QSQLITE"); }
+    void sqlite_batchExecRollback();
+    void sqlite_cachedMixedTypes_data() { generic_data("QSQLITE"); }
+    void sqlite_cachedMixedTypes();
+    void sqlite_statementCache_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCache();
 
     void sqlite_real_data() { generic_data("QSQLITE"); }
     void sqlite_real();
@@ -2155,7 +2161,9 @@ void tst_QSqlQuery::batchExec()
     q.addBindValue( numCol );
 
     QVERIFY_SQL( q, execBatch() );
-    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName + " order by id" ) );
+    // not all DBMS sort NULL values last
+    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName
+                          + " order by case when id is null then 1 else 0 end, id" ) );
 
     QVERIFY( q.next() );
     QCOMPARE( q.value( 0 ).toInt(), 1 );
@@ -2211,6 +2219,8 @@ void tst_QSqlQuery::oraArrayBind()
 
     if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
         QSKIP( "Database can't do BatchOperations");
+    if (tst_Databases::getDatabaseType(db) != QSqlDriver::Oracle)
+        QSKIP("Test requires Oracle");
 
     QSqlQuery q( db );
 
@@ -3814,6 +3824,164 @@ void tst_QSqlQuery::sqlite_constraint()
     QCOMPARE(q.lastError().databaseText(), QLatin1String("Raised Abort successfully"));
 }
 
+void tst_QSqlQuery::sqlite_batchExecRollback()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlDriver::DbmsType dbType = tst_Databases::getDatabaseType(db);
+    if (dbType != QSqlDriver::SQLite)
+        QSKIP("Sqlite3 specific test");
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("batch_rollback", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER PRIMARY KEY)"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id) VALUES (?)"));
+
+    // the duplicate key makes the batch fail, and none of its rows must remain
+    QVariantList ids;
+    ids << 1 << 2 << 3 << 2 << 4;
+    q.addBindValue(ids);
+    QVERIFY(!q.execBatch());
+    QCOMPARE(q.lastError().type(), QSqlError::StatementError);
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+
+    // inside a transaction the batch does not commit on its own
+    QVERIFY_SQL(db, transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id) VALUES (?)"));
+    ids.clear();
+    ids << 1 << 2 << 3;
+    q.addBindValue(ids);
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY_SQL(db, rollback());
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+    q.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+// SQLite columns may hold values of any type, which the row cache of
+// scrollable queries has to hand back unchanged
+void tst_QSqlQuery::sqlite_cachedMixedTypes()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlDriver::DbmsType dbType = tst_Databases::getDatabaseType(db);
+    if (dbType != QSqlDriver::SQLite)
+        QSKIP("Sqlite3 specific test");
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("cached_mixed", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, a, b, c)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, NULL, 'x', 1.5)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (2, 10, '', 2.5)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (3, 'text', NULL, 3)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (4, 20, 'yz', NULL)"));
+
+    QVERIFY(!q.isForwardOnly());
+    QVERIFY_SQL(q, exec("SELECT id, a, b, c FROM " + tableName + " ORDER BY id"));
+    QVERIFY(q.last());
+    QCOMPARE(q.at(), 3);
+
+    // walk backwards so that every row is read from the cache
+    QCOMPARE(q.value(0), QVariant(qlonglong(4)));
+    QCOMPARE(q.value(1), QVariant(qlonglong(20)));
+    QCOMPARE(q.value(2), QVariant(QString("yz")));
+    QVERIFY(q.isNull(3));
+    QCOMPARE(q.value(3).type(), QVariant::String);
+
+    QVERIFY(q.previous());
+    QCOMPARE(q.value(1), QVariant(QString("text")));
+    QVERIFY(q.isNull(2));
+    QCOMPARE(q.value(3), QVariant(qlonglong(3)));
+
+    QVERIFY(q.previous());
+    QCOMPARE(q.value(1), QVariant(qlonglong(10)));
+    QVERIFY(!q.isNull(2));
+    QVERIFY(!q.value(2).toString().isNull());
+    QVERIFY(q.value(2).toString().isEmpty());
+    QCOMPARE(q.value(3), QVariant(2.5));
+
+    QVERIFY(q.first());
+    QCOMPARE(q.value(0), QVariant(qlonglong(1)));
+    QVERIFY(q.isNull(1));
+    QCOMPARE(q.value(2), QVariant(QString("x")));
+    QCOMPARE(q.value(3), QVariant(1.5));
+
+    QVERIFY(q.seek(2));
+    QCOMPARE(q.value(0), QVariant(qlonglong(3)));
+    q.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::sqlite_statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlDriver::DbmsType dbType = tst_Databases::getDatabaseType(db);
+    if (dbType != QSqlDriver::SQLite)
+        QSKIP("Sqlite3 specific test");
+
+    const QString tableName(qTableName("stmt_cache", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, name TEXT)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, 'one')"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (2, 'two')"));
+
+    const QString select("SELECT * FROM " + tableName + " WHERE id = ?");
+    void *handle = 0;
+    {
+        QSqlQuery first(db);
+        QVERIFY_SQL(first, prepare(select));
+        handle = *static_cast<void *const *>(first.result()->handle().constData());
+        first.addBindValue(2);
+        QVERIFY_SQL(first, exec());
+        QVERIFY(first.next());
+        QCOMPARE(first.value(1).toString(), QString("two"));
+    }
+
+    // the statement of the finished query is reused, with its bindings cleared
+    QSqlQuery second(db);
+    QVERIFY_SQL(second, prepare(select));
+    QCOMPARE(*static_cast<void *const *>(second.result()->handle().constData()), handle);
+    QVERIFY(!second.exec());
+    second.addBindValue(1);
+    QVERIFY_SQL(second, exec());
+    QVERIFY(second.next());
+    QCOMPARE(second.record().count(), 2);
+    QCOMPARE(second.value(1).toString(), QString("one"));
+    second.finish();
+
+    // a cached statement picks up schema changes
+    QVERIFY_SQL(q, exec("ALTER TABLE " + tableName + " ADD COLUMN extra TEXT DEFAULT 'x'"));
+    QVERIFY_SQL(second, prepare(select));
+    second.addBindValue(1);
+    QVERIFY_SQL(second, exec());
+    QVERIFY(second.next());
+    QCOMPARE(second.record().count(), 3);
+    QCOMPARE(second.value(2).toString(), QString("x"));
+    second.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 void tst_QSqlQuery::sqlite_real()
 {
     QFETCH(QString, dbName);
@@ -70,6 +70,8 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void backgroundFetch_data() { generic_data(); }
+    void backgroundFetch();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -490,6 +492,68 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::backgroundFetch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    if (db.databaseName() == QLatin1String(":memory:"))
+        QSKIP("In-memory databases cannot be shared with the fetching thread");
+
+    QSqlQueryModel model;
+    QVERIFY(!model.isBackgroundFetchEnabled());
+    model.setBackgroundFetchEnabled(true);
+    model.setFetchBatchSize(100);
+    QCOMPARE(model.fetchBatchSize(), 100);
+
+    QSignalSpy rowsInsertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    model.setQuery("select id, name from " + qTableName("many", __FILE__, db) + " order by id", db);
+    // only the first batch is inserted without being requested
+    QTRY_COMPARE(model.rowCount(), 100);
+    QTest::qWait(100);
+    QCOMPARE(model.rowCount(), 100);
+    QVERIFY(model.canFetchMore());
+    while (model.canFetchMore()) {
+        const int rows = model.rowCount();
+        model.fetchMore();
+        QTRY_VERIFY(model.rowCount() > rows || !model.canFetchMore());
+    }
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+
+    QCOMPARE(model.columnCount(), 2);
+    QCOMPARE(model.rowCount(), 2048);
+    QCOMPARE(rowsInsertedSpy.count(), 21);
+    QCOMPARE(rowsInsertedSpy.first().value(1).toInt(), 0);
+    QCOMPARE(rowsInsertedSpy.last().value(2).toInt(), 2047);
+    QCOMPARE(model.data(model.index(0, 1)).toString(), QString("harry"));
+    QCOMPARE(model.data(model.index(2047, 0)).toInt(), 2047);
+    QCOMPARE(model.record(5).value(0).toInt(), 5);
+
+    // fetchMore() inserts what has arrived without waiting for more rows
+    model.setQuery("select id from " + qTableName("many", __FILE__, db), db);
+    model.fetchMore();
+    QVERIFY(model.rowCount() <= 100);
+    QTRY_COMPARE(model.rowCount(), 100);
+    model.fetchMore();
+    QTRY_COMPARE(model.rowCount(), 200);
+
+    // stopping a fetch that waits for rows to be requested
+    model.clear();
+    QTRY_VERIFY(QSqlDatabase::connectionNames().filter("qt_sql_model_fetch_").isEmpty());
+
+    model.setQuery("select * from " + qTableName("nonexistent", __FILE__, db), db);
+    QTRY_VERIFY(!model.canFetchMore());
+    QVERIFY(model.lastError().isValid());
+    QCOMPARE(model.rowCount(), 0);
+
+    // stopping a fetch in progress
+    model.setQuery("select id from " + qTableName("many", __FILE__, db), db);
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    // the fetching thread removes its connection when it is done
+    QTRY_VERIFY(QSqlDatabase::connectionNames().filter("qt_sql_model_fetch_").isEmpty());
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
@@ -42,6 +42,10 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void utf8Decode_data() const;
+    void utf8Decode() const;
+    void utf8Encode_data() const;
+    void utf8Encode() const;
 };
 
 void tst_QTextCodec::codecForName() const
@@ -162,7 +166,58 @@ void tst_QTextCodec::toUnicode() const
 }
 
 
+void tst_QTextCodec::utf8Decode_data() const
+{
+    QTest::addColumn<QString>("text");
+
+    // roughly 8 kB of UTF-8 each, small enough not to measure the allocator
+    QString ascii, latin, greek, cjk, mixed;
+    for (int i = 0; i < 8192; ++i)
+        ascii += QLatin1Char('a' + i % 26);
+    for (int i = 0; i < 7500; ++i)
+        latin += i % 10 ? QChar('a' + i % 26) : QChar(0xe0 + i % 26);
+    for (int i = 0; i < 4096; ++i)
+        greek += i % 8 ? QChar(0x3b1 + i % 25) : QChar(' ');
+    for (int i = 0; i < 2730; ++i)
+        cjk += QChar(0x4e00 + i);
+    for (int i = 0; i < 2048; ++i) {
+        if (i % 16 == 0) {
+            const uint emoji = 0x1f600 + i % 80;
+            mixed += QChar(QChar::highSurrogate(emoji));
+            mixed += QChar(QChar::lowSurrogate(emoji));
+        } else {
+            mixed += i % 4 ? QChar(0x4e00 + i) : QChar(' ');
+        }
+    }
+
+    QTest::newRow("ascii") << ascii;
+    QTest::newRow("latin") << latin;
+    QTest::newRow("greek") << greek;
+    QTest::newRow("cjk") << cjk;
+    QTest::newRow("cjk-emoji") << mixed;
+}
 
+void tst_QTextCodec::utf8Decode() const
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+    QBENCHMARK {
+        QString::fromUtf8(utf8);
+    }
+}
+
+void tst_QTextCodec::utf8Encode_data() const
+{
+    utf8Decode_data();
+}
+
+void tst_QTextCodec::utf8Encode() const
+{
+    QFETCH(QString, text);
+    QBENCHMARK {
+        text.toUtf8();
+    }
+}
 
 QTEST_MAIN(tst_QTextCodec)
 
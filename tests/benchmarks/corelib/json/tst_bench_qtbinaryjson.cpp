@@ -29,6 +29,9 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstream.h>
+#include <qjsonlazyvalue.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,6 +48,12 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseLargeDocument_data();
+    void parseLargeDocument();
+    void streamLargeDocument_data();
+    void streamLargeDocument();
+    void lazyLookup_data();
+    void lazyLookup();
 
     void toByteArray();
     void fromByteArray();
@@ -120,6 +129,108 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+static QByteArray largeDocument(const QByteArray &shape)
+{
+    // roughly 4 MB of records, the way a REST endpoint would return them
+    QJsonArray records;
+    for (int i = 0; i < 20000; ++i) {
+        QJsonObject record;
+        record.insert(QStringLiteral("id"), i);
+        record.insert(QStringLiteral("name"), QStringLiteral("record number %1").arg(i));
+        record.insert(QStringLiteral("ratio"), i / 7.);
+        record.insert(QStringLiteral("active"), (i & 1) == 0);
+        if (shape == "strings") {
+            record.insert(QStringLiteral("description"),
+                          QString(QStringLiteral("Lorem ipsum dolor sit amet, consectetur "
+                                                 "adipiscing elit, sed do eiusmod tempor. ")).repeated(3));
+        } else {
+            QJsonArray tags;
+            for (int j = 0; j < 4; ++j)
+                tags.append(j * i);
+            record.insert(QStringLiteral("tags"), tags);
+        }
+        records.append(record);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("status"), QStringLiteral("ok"));
+    root.insert(QStringLiteral("records"), records);
+    root.insert(QStringLiteral("count"), records.size());
+    return QJsonDocument(root).toJson(shape == "indented" ? QJsonDocument::Indented
+                                                          : QJsonDocument::Compact);
+}
+
+void BenchmarkQtBinaryJson::parseLargeDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("compact") << largeDocument("compact");
+    QTest::newRow("indented") << largeDocument("indented");
+    QTest::newRow("strings") << largeDocument("strings");
+}
+
+void BenchmarkQtBinaryJson::parseLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QJsonObject object = doc.object();
+    }
+}
+
+void BenchmarkQtBinaryJson::streamLargeDocument_data()
+{
+    parseLargeDocument_data();
+}
+
+void BenchmarkQtBinaryJson::streamLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QBuffer buffer(&json);
+        buffer.open(QIODevice::ReadOnly);
+        QJsonStreamReader reader(&buffer);
+        while (!reader.atEnd())
+            reader.readNext();
+    }
+}
+
+void BenchmarkQtBinaryJson::lazyLookup_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("lazy");
+
+    const QByteArray json = largeDocument("compact");
+    QTest::newRow("eager") << json << false;
+    QTest::newRow("lazy") << json << true;
+}
+
+void BenchmarkQtBinaryJson::lazyLookup()
+{
+    // Read two fields of a large document: the eager parser has to build
+    // the whole tree, the lazy one only skips over "records"
+    QFETCH(QByteArray, json);
+    QFETCH(bool, lazy);
+
+    QBENCHMARK {
+        QString status;
+        int count;
+        if (lazy) {
+            QJsonLazyValue root(json);
+            status = root[QStringLiteral("status")].toValue().toString();
+            count = root[QStringLiteral("count")].toValue().toInt();
+        } else {
+            QJsonObject root = QJsonDocument::fromJson(json).object();
+            status = root.value(QStringLiteral("status")).toString();
+            count = root.value(QStringLiteral("count")).toInt();
+        }
+        QCOMPARE(status, QStringLiteral("ok"));
+        QCOMPARE(count, 20000);
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
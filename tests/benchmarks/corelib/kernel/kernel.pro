@@ -1,12 +1,18 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         events \
+        qeventdispatcher \
         qmetaobject \
         qmetatype \
         qobject \
+        qtimerinfo \
         qvariant \
         qcoreapplication
 
+!unix: SUBDIRS -= \
+    qeventdispatcher \
+    qtimerinfo
+
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qeventdispatcher
+
+QT = core-private testlib
+CONFIG += release
+
+SOURCES += tst_qeventdispatcher.cpp
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/private/qeventdispatcher_unix_p.h>
+
+#include <sys/resource.h>
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void socketNotifierWakeup_data();
+    void socketNotifierWakeup();
+    void socketNotifierToggle_data();
+    void socketNotifierToggle();
+
+private:
+    bool populate(QEventDispatcherUNIX *dispatcher, int count);
+    void cleanup(QEventDispatcherUNIX *dispatcher);
+
+    QVector<QSocketNotifier *> idleNotifiers;
+    int idlePipe[2];
+};
+
+// Each row runs against a dispatcher constructed with or without the epoll(7)
+// backend, and with a number of idle socket notifiers registered besides the
+// one that is actually triggered. The poll() backend is expected to scale
+// linearly with the number of idle notifiers, the epoll backend shouldn't.
+static void addRows()
+{
+    QTest::addColumn<bool>("epoll");
+    QTest::addColumn<int>("notifiers");
+
+    static const int counts[] = { 100, 1000, 10000 };
+    for (int count : counts) {
+        QTest::newRow(qPrintable(QString::fromLatin1("poll-%1").arg(count))) << false << count;
+#if QT_CONFIG(epoll)
+        QTest::newRow(qPrintable(QString::fromLatin1("epoll-%1").arg(count))) << true << count;
+#endif
+    }
+}
+
+static QEventDispatcherUNIX *createDispatcher(bool epoll)
+{
+    // the backend is chosen when the dispatcher is constructed
+    if (epoll)
+        qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    QEventDispatcherUNIX *dispatcher = new QEventDispatcherUNIX;
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    return dispatcher;
+}
+
+void tst_QEventDispatcher::initTestCase()
+{
+    // every idle notifier needs a descriptor of its own
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+bool tst_QEventDispatcher::populate(QEventDispatcherUNIX *dispatcher, int count)
+{
+    // duplicates of the read end of a pipe that is never written to
+    if (qt_safe_pipe(idlePipe, O_NONBLOCK) != 0)
+        return false;
+
+    for (int i = 0; i < count; ++i) {
+        int fd = qt_safe_dup(idlePipe[0]);
+        if (fd == -1) {
+            cleanup(dispatcher);
+            return false;
+        }
+
+        // created enabled, so it first registers with the application's dispatcher
+        QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Read);
+        notifier->setEnabled(false);
+        dispatcher->registerSocketNotifier(notifier);
+        idleNotifiers.append(notifier);
+    }
+
+    return true;
+}
+
+void tst_QEventDispatcher::cleanup(QEventDispatcherUNIX *dispatcher)
+{
+    for (QSocketNotifier *notifier : qAsConst(idleNotifiers)) {
+        dispatcher->unregisterSocketNotifier(notifier);
+        qt_safe_close(int(notifier->socket()));
+        delete notifier;
+    }
+    idleNotifiers.clear();
+
+    qt_safe_close(idlePipe[0]);
+    qt_safe_close(idlePipe[1]);
+}
+
+void tst_QEventDispatcher::socketNotifierWakeup_data()
+{
+    addRows();
+}
+
+void tst_QEventDispatcher::socketNotifierWakeup()
+{
+    QFETCH(bool, epoll);
+    QFETCH(int, notifiers);
+
+    QScopedPointer<QEventDispatcherUNIX> dispatcher(createDispatcher(epoll));
+    if (!populate(dispatcher.data(), notifiers - 1))
+        QSKIP("Not enough file descriptors available for this data row");
+
+    int pipefds[2];
+    QCOMPARE(qt_safe_pipe(pipefds, O_NONBLOCK), 0);
+
+    int activations = 0;
+    QSocketNotifier notifier(pipefds[0], QSocketNotifier::Read);
+    notifier.setEnabled(false);
+    connect(&notifier, &QSocketNotifier::activated, [&](int fd) {
+        char c;
+        qt_safe_read(fd, &c, 1);
+        ++activations;
+    });
+    dispatcher->registerSocketNotifier(&notifier);
+
+    int rounds = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            qt_safe_write(pipefds[1], "x", 1);
+            dispatcher->processEvents(QEventLoop::WaitForMoreEvents);
+        }
+        rounds += 100;
+    }
+
+    QCOMPARE(activations, rounds);
+
+    dispatcher->unregisterSocketNotifier(&notifier);
+    qt_safe_close(pipefds[0]);
+    qt_safe_close(pipefds[1]);
+    cleanup(dispatcher.data());
+}
+
+void tst_QEventDispatcher::socketNotifierToggle_data()
+{
+    addRows();
+}
+
+void tst_QEventDispatcher::socketNotifierToggle()
+{
+    QFETCH(bool, epoll);
+    QFETCH(int, notifiers);
+
+    // enabling and disabling a notifier is what QAbstractSocket does with its
+    // write notifier; this is where the epoll backend pays a system call
+    QScopedPointer<QEventDispatcherUNIX> dispatcher(createDispatcher(epoll));
+    if (!populate(dispatcher.data(), notifiers - 1))
+        QSKIP("Not enough file descriptors available for this data row");
+
+    int pipefds[2];
+    QCOMPARE(qt_safe_pipe(pipefds, O_NONBLOCK), 0);
+
+    QSocketNotifier notifier(pipefds[1], QSocketNotifier::Write);
+    notifier.setEnabled(false);
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            dispatcher->registerSocketNotifier(&notifier);
+            dispatcher->processEvents(QEventLoop::AllEvents);
+            dispatcher->unregisterSocketNotifier(&notifier);
+        }
+    }
+
+    qt_safe_close(pipefds[0]);
+    qt_safe_close(pipefds[1]);
+    cleanup(dispatcher.data());
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_qeventdispatcher.moc"
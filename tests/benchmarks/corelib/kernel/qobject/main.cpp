@@ -43,6 +43,12 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_many_receivers_benchmark_data();
+    void signal_many_receivers_benchmark();
+    void signal_threads_benchmark_data();
+    void signal_threads_benchmark();
+    void signal_queued_threads_benchmark_data();
+    void signal_queued_threads_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -127,6 +133,141 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+void QObjectBenchmark::signal_many_receivers_benchmark_data()
+{
+    QTest::addColumn<int>("receiverCount");
+    QTest::newRow("1 receiver") << 1;
+    QTest::newRow("10 receivers") << 10;
+    QTest::newRow("100 receivers") << 100;
+}
+
+void QObjectBenchmark::signal_many_receivers_benchmark()
+{
+    QFETCH(int, receiverCount);
+
+    Object sender;
+    QVector<Object *> receivers;
+    for (int i = 0; i < receiverCount; ++i) {
+        receivers << new Object;
+        QObject::connect(&sender, &Object::signal0, receivers.last(), &Object::slot0);
+    }
+
+    QBENCHMARK {
+        sender.emitSignal0();
+    }
+
+    qDeleteAll(receivers);
+}
+
+class EmitterThread : public QThread
+{
+public:
+    EmitterThread(Object *sender, int emissions) : sender(sender), emissions(emissions) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < emissions; ++i)
+            sender->emitSignal0();
+    }
+
+private:
+    Object *sender;
+    int emissions;
+};
+
+void QObjectBenchmark::signal_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharedSender");
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, one sender each").arg(threadCount)))
+            << threadCount << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, shared sender").arg(threadCount)))
+            << threadCount << true;
+    }
+}
+
+// Every thread emits the same number of signals connected directly to a slot:
+// the time taken should not grow with the number of threads as long as there
+// are enough cores to run them.
+void QObjectBenchmark::signal_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharedSender);
+    const int emissions = 100000;
+
+    Object receiver;
+    QVector<Object *> senders;
+    for (int i = 0; i < (sharedSender ? 1 : threadCount); ++i) {
+        senders << new Object;
+        QObject::connect(senders.last(), &Object::signal0, &receiver, &Object::slot0, Qt::DirectConnection);
+        QObject::connect(senders.last(), &Object::signal0, &receiver, &Object::slot1, Qt::DirectConnection);
+    }
+
+    QBENCHMARK {
+        QVector<EmitterThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new EmitterThread(senders.at(sharedSender ? 0 : i), emissions);
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->start();
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    qDeleteAll(senders);
+}
+
+void QObjectBenchmark::signal_queued_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("batched");
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, queued").arg(threadCount)))
+            << threadCount << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, batched").arg(threadCount)))
+            << threadCount << true;
+    }
+}
+
+// Every thread emits signals queued to a receiver living in the main thread,
+// which processes events until it got all of them.
+void QObjectBenchmark::signal_queued_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, batched);
+    const int emissions = 100000;
+    const Qt::ConnectionType type = batched
+        ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+        : Qt::QueuedConnection;
+
+    Object receiver;
+    QEventLoop loop;
+    int received = 0;
+    QVector<Object *> senders;
+    for (int i = 0; i < threadCount; ++i) {
+        senders << new Object;
+        QObject::connect(senders.last(), &Object::signal0, &receiver, [&]() {
+            if (++received == threadCount * emissions)
+                loop.quit();
+        }, type);
+    }
+
+    QBENCHMARK {
+        received = 0;
+        QVector<EmitterThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new EmitterThread(senders.at(i), emissions);
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->start();
+        loop.exec();
+        for (EmitterThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    qDeleteAll(senders);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qtimerinfo
+
+QT = core-private testlib
+CONFIG += release
+
+SOURCES += tst_qtimerinfo.cpp
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+#include <qtest.h>
+#include <QtCore/private/qtimerinfo_unix_p.h>
+
+class tst_QTimerInfo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerAndUnregister_data();
+    void registerAndUnregister();
+    void restart_data();
+    void restart();
+    void activate_data();
+    void activate();
+
+private:
+    void populate(QTimerInfoList *list, int count, Qt::TimerType timerType, QObject *receiver);
+};
+
+// Intervals are spread over a minute, like the idle timeouts of a server
+// holding many connections.
+static int intervalFor(int timerId)
+{
+    return 1000 + (timerId * 7919) % 60000;
+}
+
+static void addRows()
+{
+    QTest::addColumn<int>("timers");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    static const int counts[] = { 10000, 100000, 1000000 };
+    for (int count : counts) {
+        QTest::newRow(qPrintable(QString::fromLatin1("precise-%1").arg(count)))
+                << count << Qt::PreciseTimer;
+        QTest::newRow(qPrintable(QString::fromLatin1("coarse-%1").arg(count)))
+                << count << Qt::CoarseTimer;
+        QTest::newRow(qPrintable(QString::fromLatin1("verycoarse-%1").arg(count)))
+                << count << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimerInfo::populate(QTimerInfoList *list, int count, Qt::TimerType timerType,
+                              QObject *receiver)
+{
+    for (int id = 1; id <= count; ++id)
+        list->registerTimer(id, intervalFor(id), timerType, receiver);
+}
+
+void tst_QTimerInfo::registerAndUnregister_data()
+{
+    addRows();
+}
+
+void tst_QTimerInfo::registerAndUnregister()
+{
+    QFETCH(int, timers);
+    QFETCH(Qt::TimerType, timerType);
+
+    QObject receiver;
+    QTimerInfoList list;
+
+    QBENCHMARK {
+        populate(&list, timers, timerType, &receiver);
+        for (int id = 1; id <= timers; ++id)
+            list.unregisterTimer(id);
+    }
+    QVERIFY(list.isEmpty());
+}
+
+void tst_QTimerInfo::restart_data()
+{
+    addRows();
+}
+
+// Restarting a timer, as done for every request on a connection with an idle
+// timeout, while all the other timers stay registered.
+void tst_QTimerInfo::restart()
+{
+    QFETCH(int, timers);
+    QFETCH(Qt::TimerType, timerType);
+
+    QObject receiver;
+    QTimerInfoList list;
+    populate(&list, timers, timerType, &receiver);
+
+    int id = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            id = id % timers + 1;
+            list.unregisterTimer(id);
+            list.registerTimer(id, intervalFor(id), timerType, &receiver);
+        }
+    }
+    QCOMPARE(list.size(), timers);
+
+    qDeleteAll(list);
+}
+
+void tst_QTimerInfo::activate_data()
+{
+    addRows();
+}
+
+// One event loop iteration: find out how long to wait, then fire whatever
+// has expired. Only a few of the timers are due at any time.
+void tst_QTimerInfo::activate()
+{
+    QFETCH(int, timers);
+    QFETCH(Qt::TimerType, timerType);
+
+    QObject receiver;
+    QTimerInfoList list;
+    populate(&list, timers, timerType, &receiver);
+
+    QBENCHMARK {
+        timespec tm;
+        list.timerWait(tm);
+        list.activateTimers();
+    }
+    QCOMPARE(list.size(), timers);
+
+    qDeleteAll(list);
+}
+
+QTEST_MAIN(tst_QTimerInfo)
+
+#include "tst_qtimerinfo.moc"
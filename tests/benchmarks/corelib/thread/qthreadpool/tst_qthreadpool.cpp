@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void contention_data();
+    void contention();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,77 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class CountingRunnable : public QRunnable
+{
+public:
+    explicit CountingRunnable(QAtomicInt *counter) : counter(counter) {}
+    void run() Q_DECL_OVERRIDE {
+        counter->ref();
+    }
+
+private:
+    QAtomicInt *counter;
+};
+
+class FanOutRunnable : public QRunnable
+{
+public:
+    FanOutRunnable(QThreadPool *pool, int count, QAtomicInt *counter)
+        : pool(pool), count(count), counter(counter) {}
+    void run() Q_DECL_OVERRIDE {
+        for (int i = 0; i < count; ++i)
+            pool->start(new CountingRunnable(counter));
+    }
+
+private:
+    QThreadPool *pool;
+    int count;
+    QAtomicInt *counter;
+};
+
+void tst_QThreadPool::contention_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("fromWorkers");
+
+    const int ideal = qMax(QThread::idealThreadCount(), 1);
+    for (int threads = 1; threads < ideal * 2; threads *= 2) {
+        const QByteArray count = QByteArray::number(threads);
+        QTest::newRow(("external-" + count).constData()) << threads << false;
+        QTest::newRow(("workers-" + count).constData()) << threads << true;
+    }
+}
+
+// Many tiny tasks, either all started from the main thread or started from
+// within tasks running in the pool. The latter don't contend on the pool's
+// queue, but are queued on the starting thread and stolen by idle threads.
+void tst_QThreadPool::contention()
+{
+    QFETCH(int, threads);
+    QFETCH(bool, fromWorkers);
+
+    const int producers = threads;
+    const int tasksPerProducer = 10000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threads);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        counter.store(0);
+        for (int i = 0; i < producers; ++i) {
+            if (fromWorkers) {
+                threadPool.start(new FanOutRunnable(&threadPool, tasksPerProducer, &counter));
+            } else {
+                for (int j = 0; j < tasksPerProducer; ++j)
+                    threadPool.start(new CountingRunnable(&counter));
+            }
+        }
+        threadPool.waitForDone();
+    }
+
+    QCOMPARE(counter.load(), producers * tasksPerProducer);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
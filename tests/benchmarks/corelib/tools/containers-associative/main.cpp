@@ -26,9 +26,17 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <QFlatHash>
+#include <QVector>
 
 #include <qtest.h>
 
+enum ContainerType {
+    Hash,
+    FlatHash,
+    Map
+};
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -37,6 +45,8 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void largeTable_data();
+    void largeTable();
 };
 
 template <typename T>
@@ -52,30 +62,34 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<int>("type");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << int(Hash) << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << int(FlatHash) << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << int(Map) << size;
     }
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(int, type);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (type) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testInsert<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -84,15 +98,16 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<int>("type");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << int(Hash) << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << int(FlatHash) << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << int(Map) << size;
     }
 }
 
@@ -115,14 +130,69 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(int, type);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (type) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testLookup<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::largeTable_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("size");
+
+    for (int size = 100000; size <= 1000000; size *= 10) {
+        const QByteArray sizeString = QByteArray::number(size);
+
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << int(Hash) << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << int(FlatHash) << size;
+    }
+}
+
+// Scattered 64-bit keys, as in symbol tables, where the working set does
+// not fit in the cache.
+template <typename T>
+void testLargeTable(int size)
+{
+    QVector<quint64> keys(size);
+    quint64 x = 88172645463325252ULL;
+    for (int i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        keys[i] = x;
     }
+
+    QBENCHMARK {
+        T container;
+        for (int i = 0; i < size; ++i)
+            container.insert(keys.at(i), i);
+        qint64 sum = 0;
+        for (int i = 0; i < size; ++i)
+            sum += container.value(keys.at(i));
+        QCOMPARE(sum, qint64(size) * (size - 1) / 2);
+    }
+}
+
+void tst_associative_containers::largeTable()
+{
+    QFETCH(int, type);
+    QFETCH(int, size);
+
+    if (type == FlatHash)
+        testLargeTable<QFlatHash<quint64, int> >(size);
+    else
+        testLargeTable<QHash<quint64, int> >(size);
 }
 
 QTEST_MAIN(tst_associative_containers)
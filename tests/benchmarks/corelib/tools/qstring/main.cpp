@@ -49,7 +49,23 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void fromLatin1_data() { kernel_data(); }
+    void fromLatin1();
+    void toLatin1_data() { kernel_data(); }
+    void toLatin1();
+    void compare_data() { kernel_data(); }
+    void compare();
+    void compareLatin1_data() { kernel_data(); }
+    void compareLatin1();
+    void compareCaseInsensitive_data() { kernel_data(); }
+    void compareCaseInsensitive();
+    void indexOfChar_data() { kernel_data(); }
+    void indexOfChar();
+    void byteArrayIndexOf_data() { kernel_data(); }
+    void byteArrayIndexOf();
+
 private:
+    void kernel_data();
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
 };
@@ -188,6 +204,106 @@ void tst_QString::toCaseFolded()
     }
 }
 
+// The following run the vectorized string kernels over strings that only
+// differ in their last character. Compare the results with and without
+// QT_NO_CPU_FEATURE=avx2 in the environment to see the AVX2 versions at work.
+void tst_QString::kernel_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("16") << 16;
+    QTest::newRow("256") << 256;
+    QTest::newRow("4096") << 4096;
+}
+
+void tst_QString::fromLatin1()
+{
+    QFETCH(int, size);
+    const QByteArray latin1(size, 'a');
+
+    QBENCHMARK {
+        QString::fromLatin1(latin1);
+    }
+}
+
+void tst_QString::toLatin1()
+{
+    QFETCH(int, size);
+    const QString s(size, QLatin1Char('a'));
+
+    QBENCHMARK {
+        s.toLatin1();
+    }
+}
+
+void tst_QString::compare()
+{
+    QFETCH(int, size);
+    const QString s1(size, QLatin1Char('a'));
+    QString s2 = s1;
+    s2[size - 1] = QLatin1Char('b');
+
+    int result;
+    QBENCHMARK {
+        result = s1.compare(s2);
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_QString::compareLatin1()
+{
+    QFETCH(int, size);
+    const QString s1(size, QLatin1Char('a'));
+    QByteArray latin1(size, 'a');
+    latin1[size - 1] = 'b';
+    const QLatin1String s2(latin1);
+
+    int result;
+    QBENCHMARK {
+        result = s1.compare(s2);
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_QString::compareCaseInsensitive()
+{
+    QFETCH(int, size);
+    const QString s1(size, QLatin1Char('a'));
+    QString s2(size, QLatin1Char('A'));
+    s2[size - 1] = QLatin1Char('B');
+
+    int result;
+    QBENCHMARK {
+        result = s1.compare(s2, Qt::CaseInsensitive);
+    }
+    QVERIFY(result < 0);
+}
+
+void tst_QString::indexOfChar()
+{
+    QFETCH(int, size);
+    QString s(size, QLatin1Char('a'));
+    s[size - 1] = QLatin1Char('b');
+
+    int result;
+    QBENCHMARK {
+        result = s.indexOf(QLatin1Char('b'));
+    }
+    QCOMPARE(result, size - 1);
+}
+
+void tst_QString::byteArrayIndexOf()
+{
+    QFETCH(int, size);
+    QByteArray haystack(size, 'a');
+    haystack.replace(size - 8, 8, "baaaaaab");
+
+    int result;
+    QBENCHMARK {
+        result = haystack.indexOf("baaaaaab");
+    }
+    QCOMPARE(result, size - 8);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QStringArena>
+#include <QVector>
+
+#include <qtest.h>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+
+static size_t heapInUse()
+{
+#  if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#  else
+    return size_t(mallinfo().uordblks);
+#  endif
+}
+#endif
+
+class tst_QStringArena : public QObject
+{
+    Q_OBJECT
+private slots:
+    void createStrings_data();
+    void createStrings();
+    void memoryUsage_data();
+    void memoryUsage();
+
+private:
+    void makeWords();
+
+    QString text;
+    QVector<QPair<int, int> > words;
+};
+
+enum Mode { Heap, Arena, Interned };
+
+// A text of some 200000 short words, taken from a small vocabulary so that
+// many repeat, as the keys and values of a parsed document do.
+void tst_QStringArena::makeWords()
+{
+    if (!words.isEmpty())
+        return;
+    static const char * const vocabulary[] = {
+        "id", "name", "type", "value", "width", "height", "x", "y", "visible",
+        "enabled", "children", "parent", "color", "font", "text", "title",
+        "description", "url", "timestamp", "count"
+    };
+    const int vocabularySize = int(sizeof vocabulary / sizeof *vocabulary);
+    for (int i = 0; i < 200000; ++i) {
+        const int start = text.size();
+        if (i % 3)
+            text += QLatin1String(vocabulary[(i * 7) % vocabularySize]);
+        else
+            text += QString::number(i);
+        words.append(qMakePair(start, text.size() - start));
+        text += QLatin1Char(' ');
+    }
+}
+
+static void addRows()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("heap") << int(Heap);
+    QTest::newRow("arena") << int(Arena);
+    QTest::newRow("interned") << int(Interned);
+}
+
+static void collect(QVector<QString> &result, QStringArena &arena, Mode mode,
+                    const QString &text, const QVector<QPair<int, int> > &words)
+{
+    const QChar *data = text.constData();
+    for (const QPair<int, int> &word : words) {
+        switch (mode) {
+        case Heap:
+            result.append(QString(data + word.first, word.second));
+            break;
+        case Arena:
+            result.append(arena.string(data + word.first, word.second));
+            break;
+        case Interned:
+            result.append(arena.intern(data + word.first, word.second));
+            break;
+        }
+    }
+}
+
+void tst_QStringArena::createStrings_data()
+{
+    addRows();
+}
+
+void tst_QStringArena::createStrings()
+{
+    QFETCH(int, mode);
+    makeWords();
+
+    QBENCHMARK {
+        QStringArena arena;
+        QVector<QString> result;
+        result.reserve(words.size());
+        collect(result, arena, Mode(mode), text, words);
+    }
+}
+
+void tst_QStringArena::memoryUsage_data()
+{
+    addRows();
+}
+
+// Reports the memory taken from the heap to hold all the words, including
+// the allocator's own overhead.
+void tst_QStringArena::memoryUsage()
+{
+#if defined(__GLIBC__)
+    QFETCH(int, mode);
+    makeWords();
+
+    QStringArena arena;
+    QVector<QString> result;
+    result.reserve(words.size());
+    malloc_trim(0);
+    const size_t before = heapInUse();
+    collect(result, arena, Mode(mode), text, words);
+    const size_t after = heapInUse();
+    QTest::setBenchmarkResult(qreal(after - before), QTest::BytesAllocated);
+#else
+    QSKIP("Needs the GNU C library to measure the memory allocated");
+#endif
+}
+
+QTEST_MAIN(tst_QStringArena)
+
+#include "main.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_qstringarena
+
+QT = core testlib
+CONFIG += release
+
+SOURCES += main.cpp
@@ -13,6 +13,7 @@ SUBDIRS = \
         qringbuffer \
         qstack \
         qstring \
+        qstringarena \
         qstringbuilder \
         qstringlist \
         qvector \
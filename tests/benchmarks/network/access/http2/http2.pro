@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_http2
+
+QT = core network network-private testlib
+
+CONFIG += release c++11
+
+SOURCES += tst_bench_http2.cpp
@@ -0,0 +1,352 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtNetwork/private/http2protocol_p.h>
+#include <QtNetwork/private/http2frames_p.h>
+#include <QtNetwork/private/bitstreams_p.h>
+#include <QtNetwork/private/hpack_p.h>
+
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qthread.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using namespace Http2;
+using namespace HPack;
+
+enum {
+    BulkTransfers = 2,
+    SmallRequests = 200,
+    SmallResponseSize = 1024,
+    // The server keeps this much queued in its socket, so that what it sends
+    // next is decided by its scheduler rather than by the order of requests:
+    ServerLowWaterMark = 64 * 1024
+};
+
+// One client connection of Http2BenchServer. It answers every request for
+// "/bulk" with an endless body and any other one with SmallResponseSize bytes,
+// and interleaves DATA frames of concurrent responses according to the stream
+// weights sent by the client (HTTP/2 5.3.2), like a real server would.
+class Http2BenchConnection : public QObject
+{
+    Q_OBJECT
+public:
+    Http2BenchConnection(qintptr socketDescriptor, QObject *parent)
+        : QObject(parent),
+          decoder(FieldLookupTable::DefaultSize),
+          encoder(FieldLookupTable::DefaultSize, true),
+          chunk(maxFrameSize, 'x')
+    {
+        socket.setSocketDescriptor(socketDescriptor);
+        socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(&socket, &QIODevice::readyRead, this, &Http2BenchConnection::readReady);
+        connect(&socket, &QIODevice::bytesWritten, this, &Http2BenchConnection::sendData);
+
+        writer.start(FrameType::SETTINGS, FrameFlag::EMPTY, connectionStreamID);
+        writer.write(socket);
+    }
+
+private slots:
+    void readReady()
+    {
+        if (waitingClientPreface) {
+            if (socket.bytesAvailable() < clientPrefaceLength)
+                return;
+            char preface[clientPrefaceLength];
+            socket.read(preface, clientPrefaceLength);
+            if (std::memcmp(preface, Http2clientPreface, clientPrefaceLength))
+                return socket.abort();
+            waitingClientPreface = false;
+        }
+
+        forever {
+            switch (reader.read(socket)) {
+            case FrameStatus::incompleteFrame:
+                sendData();
+                return;
+            case FrameStatus::goodFrame:
+                handleFrame(reader.inboundFrame());
+                break;
+            default:
+                return socket.abort();
+            }
+        }
+    }
+
+    void sendData()
+    {
+        while (socket.bytesToWrite() < ServerLowWaterMark && sessionWindow > 0) {
+            // Start-time fair queueing: the response that has been served
+            // least relative to its weight goes next.
+            auto next = responses.end();
+            for (auto it = responses.begin(); it != responses.end(); ++it) {
+                if (it->second.window > 0 && (next == responses.end() || it->second.pass < next->second.pass))
+                    next = it;
+            }
+            if (next == responses.end())
+                return;
+
+            Response &response = next->second;
+            qint64 size = std::min({qint64(maxFrameSize), qint64(sessionWindow), qint64(response.window)});
+            if (response.remaining >= 0)
+                size = std::min(size, response.remaining);
+            const bool last = response.remaining == size;
+
+            writer.start(FrameType::DATA, last ? FrameFlag::END_STREAM : FrameFlag::EMPTY, next->first);
+            const uchar *src = reinterpret_cast<const uchar *>(chunk.constData());
+            writer.append(src, src + size);
+            writer.write(socket);
+
+            sessionWindow -= size;
+            response.window -= size;
+            if (response.remaining >= 0)
+                response.remaining -= size;
+            virtualTime = response.pass;
+            response.pass += size * response.stride;
+            if (last)
+                responses.erase(next);
+        }
+    }
+
+private:
+    struct Response
+    {
+        qint64 remaining; // -1 for an endless body
+        qint32 window;
+        quint64 stride;
+        quint64 pass;
+    };
+
+    void handleFrame(const Frame &frame)
+    {
+        switch (frame.type()) {
+        case FrameType::SETTINGS:
+            if (!frame.flags().testFlag(FrameFlag::ACK)) {
+                writer.start(FrameType::SETTINGS, FrameFlag::ACK, connectionStreamID);
+                writer.write(socket);
+            }
+            break;
+        case FrameType::WINDOW_UPDATE: {
+            const qint32 delta = qFromBigEndian<quint32>(frame.dataBegin());
+            if (frame.streamID() == connectionStreamID) {
+                sessionWindow += delta;
+            } else {
+                const auto it = responses.find(frame.streamID());
+                if (it != responses.end())
+                    it->second.window += delta;
+            }
+            break;
+        }
+        case FrameType::HEADERS:
+            handleRequest(frame);
+            break;
+        case FrameType::RST_STREAM:
+            responses.erase(frame.streamID());
+            break;
+        default:
+            break;
+        }
+    }
+
+    void handleRequest(const Frame &frame)
+    {
+        quint32 dependency = 0;
+        uchar weight = 0;
+        frame.priority(&dependency, &weight);
+
+        BitIStream input(frame.dataBegin(), frame.dataBegin() + frame.dataSize());
+        if (!decoder.decodeHeaderFields(input))
+            return socket.abort();
+
+        bool bulk = false;
+        for (const HeaderField &field : decoder.decodedHeader()) {
+            if (field.name == ":path")
+                bulk = field.value.endsWith("/bulk");
+        }
+
+        HttpHeader header = {{":status", "200"}};
+        if (!bulk)
+            header.push_back(HeaderField("content-length", QByteArray::number(SmallResponseSize)));
+        writer.start(FrameType::HEADERS, FrameFlag::END_HEADERS, frame.streamID());
+        BitOStream output(writer.outboundFrame().buffer);
+        encoder.encodeResponse(output, header);
+        writer.writeHEADERS(socket, maxFrameSize);
+
+        // HTTP/2 weights are 1 to 256, sent as 0 to 255:
+        const Response response = {bulk ? -1 : SmallResponseSize, defaultSessionWindowSize,
+                                   256 / (weight + 1u), virtualTime};
+        responses.insert(std::make_pair(frame.streamID(), response));
+    }
+
+    QTcpSocket socket;
+    bool waitingClientPreface = true;
+    FrameReader reader;
+    FrameWriter writer;
+    Decoder decoder;
+    Encoder encoder;
+    std::map<quint32, Response> responses;
+    qint32 sessionWindow = defaultSessionWindowSize;
+    quint64 virtualTime = 0;
+    const QByteArray chunk;
+};
+
+class Http2BenchServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE quint16 start()
+    {
+        return listen(QHostAddress::LocalHost) ? serverPort() : 0;
+    }
+
+private:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        new Http2BenchConnection(socketDescriptor, this);
+    }
+};
+
+class tst_bench_Http2 : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void smallRequestLatency_data();
+    void smallRequestLatency();
+
+private:
+    QThread serverThread;
+    Http2BenchServer *server = nullptr;
+    quint16 serverPort = 0;
+};
+
+void tst_bench_Http2::initTestCase()
+{
+    server = new Http2BenchServer;
+    server->moveToThread(&serverThread);
+    serverThread.start();
+    QMetaObject::invokeMethod(server, "start", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(quint16, serverPort));
+    QVERIFY(serverPort);
+}
+
+void tst_bench_Http2::cleanupTestCase()
+{
+    QMetaObject::invokeMethod(server, "deleteLater");
+    serverThread.quit();
+    serverThread.wait();
+}
+
+void tst_bench_Http2::smallRequestLatency_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<bool>("prioritized");
+
+    for (int connections : {1, 4}) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 connections, same priority").arg(connections)))
+            << connections << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 connections, prioritized").arg(connections)))
+            << connections << true;
+    }
+}
+
+// Measures the 99th percentile latency of small requests, sent one after
+// another while bulk downloads from the same host keep running.
+void tst_bench_Http2::smallRequestLatency()
+{
+    QFETCH(int, connections);
+    QFETCH(bool, prioritized);
+
+    QNetworkAccessManager manager;
+    const QUrl url(QString::fromLatin1("http://127.0.0.1:%1/").arg(serverPort));
+
+    QVector<QNetworkReply *> bulkReplies;
+    for (int i = 0; i < BulkTransfers; ++i) {
+        QNetworkRequest request(url.resolved(QUrl(QStringLiteral("bulk"))));
+        request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+        request.setAttribute(QNetworkRequest::HTTP2ConnectionsPerHostAttribute, connections);
+        if (prioritized)
+            request.setPriority(QNetworkRequest::LowPriority);
+        QNetworkReply *reply = manager.get(request);
+        connect(reply, &QIODevice::readyRead, reply, [reply]() { reply->readAll(); });
+        bulkReplies << reply;
+    }
+    // Let the bulk transfers get going:
+    connect(bulkReplies.last(), &QIODevice::readyRead,
+            &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    bulkReplies.last()->disconnect(&QTestEventLoop::instance());
+
+    QVector<qint64> latencies;
+    latencies.reserve(SmallRequests);
+    QElapsedTimer timer;
+    for (int i = 0; i < SmallRequests; ++i) {
+        QNetworkRequest request(url.resolved(QUrl(QStringLiteral("small"))));
+        request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+        request.setAttribute(QNetworkRequest::HTTP2ConnectionsPerHostAttribute, connections);
+        if (prioritized)
+            request.setPriority(QNetworkRequest::HighPriority);
+
+        timer.start();
+        QScopedPointer<QNetworkReply> reply(manager.get(request));
+        connect(reply.data(), &QNetworkReply::finished,
+                &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+        QTestEventLoop::instance().enterLoop(10);
+        latencies << timer.nsecsElapsed();
+
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll().size(), int(SmallResponseSize));
+    }
+
+    for (QNetworkReply *reply : qAsConst(bulkReplies)) {
+        reply->abort();
+        delete reply;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const qint64 p99 = latencies.at((latencies.size() * 99 + 99) / 100 - 1);
+    QTest::setBenchmarkResult(p99 / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_bench_Http2)
+
+#include "tst_bench_http2.moc"
@@ -95,9 +95,11 @@ void tst_qnetworkdiskcache::cleanupTestCase()
 void tst_qnetworkdiskcache::timeInsertion_data()
 {
     QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<bool>("indexed");
 
     QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc << false;
+    QTest::newRow("QStandardPaths Cache Location, indexed") << cacheLoc << true;
 }
 
 //This functions times an insert() operation.
@@ -108,6 +110,7 @@ void tst_qnetworkdiskcache::timeInsertion()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -116,6 +119,7 @@ void tst_qnetworkdiskcache::timeInsertion()
     //Housekeeping
     cleanRecursive(cacheDir); // slow op.
     initCacheObject();
+    cache->setIndexEnabled(indexed);
 
     cache->setCacheDirectory(cacheDir);
     cache->setMaximumCacheSize(qint64(HugeCacheLimit));
@@ -156,9 +160,11 @@ void tst_qnetworkdiskcache::timeInsertion()
 void tst_qnetworkdiskcache::timeRead_data()
 {
     QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<bool>("indexed");
 
     QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc << false;
+    QTest::newRow("QStandardPaths Cache Location, indexed") << cacheLoc << true;
 }
 
 //Times metadata as well payload lookup
@@ -167,6 +173,7 @@ void tst_qnetworkdiskcache::timeRead()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -175,6 +182,7 @@ void tst_qnetworkdiskcache::timeRead()
     //Housekeeping
     cleanRecursive(cacheDir); // slow op.
     initCacheObject();
+    cache->setIndexEnabled(indexed);
     cache->setCacheDirectory(cacheDir);
     cache->setMaximumCacheSize(qint64(HugeCacheLimit));
     cache->clear();
@@ -215,15 +223,18 @@ void tst_qnetworkdiskcache::timeRead()
 void tst_qnetworkdiskcache::timeRemoval_data()
 {
     QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<bool>("indexed");
 
     QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc << false;
+    QTest::newRow("QStandardPaths Cache Location, indexed") << cacheLoc << true;
 }
 
 void tst_qnetworkdiskcache::timeRemoval()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -232,6 +243,7 @@ void tst_qnetworkdiskcache::timeRemoval()
     //Housekeeping
     initCacheObject();
     cleanRecursive(cacheDir); // slow op.
+    cache->setIndexEnabled(indexed);
     cache->setCacheDirectory(cacheDir);
     // Make max cache size HUGE, so that evictions don't happen below
     cache->setMaximumCacheSize(qint64(HugeCacheLimit));
@@ -265,15 +277,18 @@ void tst_qnetworkdiskcache::timeRemoval()
 void tst_qnetworkdiskcache::timeExpiration_data()
 {
     QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<bool>("indexed");
 
     QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc << false;
+    QTest::newRow("QStandardPaths Cache Location, indexed") << cacheLoc << true;
 }
 
 void tst_qnetworkdiskcache::timeExpiration()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(bool, indexed);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -282,6 +297,7 @@ void tst_qnetworkdiskcache::timeExpiration()
     //Housekeeping
     initCacheObject();
     cleanRecursive(cacheDir); // slow op.
+    cache->setIndexEnabled(indexed);
     cache->setCacheDirectory(cacheDir);
     // Make max cache size HUGE, so that evictions don't happen below
     cache->setMaximumCacheSize(qint64(HugeCacheLimit));
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qudpsocket.h>
+#include <qnetworkdatagram.h>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loopbackThroughput_data();
+    void loopbackThroughput();
+};
+
+void tst_QUdpSocket::loopbackThroughput_data()
+{
+    QTest::addColumn<int>("datagramSize");
+    QTest::addColumn<bool>("batched");
+
+    for (int size = 64; size <= 1024; size *= 4) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 bytes, one at a time").arg(size)))
+            << size << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 bytes, batched").arg(size)))
+            << size << true;
+    }
+}
+
+// Sends datagrams to a socket bound on the loopback interface and reads
+// them back, in rounds small enough to fit into the receive buffer.
+void tst_QUdpSocket::loopbackThroughput()
+{
+    QFETCH(int, datagramSize);
+    QFETCH(bool, batched);
+    const int rounds = 200;
+    const int perRound = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost));
+
+    QVector<QNetworkDatagram> datagrams;
+    for (int i = 0; i < perRound; ++i) {
+        datagrams << QNetworkDatagram(QByteArray(datagramSize, char('a' + i % 26)),
+                                      QHostAddress::LocalHost, receiver.localPort());
+    }
+
+    QBENCHMARK {
+        for (int round = 0; round < rounds; ++round) {
+            if (batched) {
+                QCOMPARE(sender.writeDatagrams(datagrams), perRound);
+            } else {
+                for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+                    QCOMPARE(sender.writeDatagram(datagram), qint64(datagramSize));
+            }
+
+            int received = 0;
+            while (received < perRound) {
+                if (!receiver.hasPendingDatagrams())
+                    QVERIFY(receiver.waitForReadyRead(5000));
+                if (batched) {
+                    const QVector<QNetworkDatagram> got
+                        = receiver.receiveDatagrams(perRound - received, datagramSize);
+                    received += got.size();
+                } else {
+                    QCOMPARE(receiver.receiveDatagram(datagramSize).data().size(), datagramSize);
+                    ++received;
+                }
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+
+#include "tst_qudpsocket.moc"
@@ -30,7 +30,9 @@
 
 #include <qcoreapplication.h>
 #include <qsslconfiguration.h>
+#include <qsslkey.h>
 #include <qsslsocket.h>
+#include <qtcpserver.h>
 
 
 #include "../../../../auto/network-settings.h"
@@ -51,6 +53,30 @@ public slots:
 private slots:
     void rootCertLoading();
     void systemCaCertificates();
+    void handshakeRate_data();
+    void handshakeRate();
+};
+
+class SslServer : public QTcpServer
+{
+public:
+    SslServer(const QSslCertificate &certificate, const QSslKey &key)
+        : certificate(certificate), key(key) {}
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setLocalCertificate(certificate);
+        socket->setPrivateKey(key);
+        socket->setSocketDescriptor(socketDescriptor);
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        socket->startServerEncryption();
+    }
+
+private:
+    QSslCertificate certificate;
+    QSslKey key;
 };
 
 tst_QSslSocket::tst_QSslSocket()
@@ -95,5 +121,47 @@ void tst_QSslSocket::systemCaCertificates()
   }
 }
 
+void tst_QSslSocket::handshakeRate_data()
+{
+    QTest::addColumn<bool>("sessionSharing");
+    QTest::newRow("full handshake") << false;
+    QTest::newRow("resumed") << true;
+}
+
+// Connects to a local server over and over: with session sharing, all but
+// the first handshake resume the session the first one established.
+void tst_QSslSocket::handshakeRate()
+{
+    QFETCH(bool, sessionSharing);
+
+    QFile certFile(QFINDTESTDATA("../../../../auto/network/ssl/qsslsocket/certs/fluke.cert"));
+    QFile keyFile(QFINDTESTDATA("../../../../auto/network/ssl/qsslsocket/certs/fluke.key"));
+    QVERIFY(certFile.open(QIODevice::ReadOnly));
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+    SslServer server(QSslCertificate(certFile.readAll()), QSslKey(keyFile.readAll(), QSsl::Rsa));
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, !sessionSharing);
+
+    QBENCHMARK {
+        for (int i = 0; i < 20; ++i) {
+            // The server runs in this thread, so spin the event loop rather
+            // than blocking in waitForEncrypted().
+            QSslSocket socket;
+            socket.setSslConfiguration(configuration);
+            QEventLoop loop;
+            connect(&socket, &QSslSocket::encrypted, &loop, &QEventLoop::quit);
+            connect(&socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
+                    &loop, &QEventLoop::quit);
+            socket.connectToHostEncrypted(QStringLiteral("127.0.0.1"), server.serverPort());
+            loop.exec();
+            QVERIFY2(socket.isEncrypted(), qPrintable(socket.errorString()));
+            socket.disconnectFromHost();
+        }
+    }
+}
+
 QTEST_MAIN(tst_QSslSocket)
 #include "tst_qsslsocket.moc"
@@ -52,6 +52,16 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void benchmarkInsertPrepared_data() { generic_data(); }
+    void benchmarkInsertPrepared() { insertRows(false); }
+    void benchmarkInsertBatch_data() { generic_data(); }
+    void benchmarkInsertBatch() { insertRows(true); }
+    void benchmarkScrollCached_data() { generic_data(); }
+    void benchmarkScrollCached();
+    void benchmarkExecAsync_data();
+    void benchmarkExecAsync();
+    void benchmarkPrepareLookup_data();
+    void benchmarkPrepareLookup();
 
 private:
     // returns all database connections
@@ -59,6 +69,7 @@ private:
     void dropTestTables( QSqlDatabase db );
     void createTestTables( QSqlDatabase db );
     void populateTestTables( QSqlDatabase db );
+    void insertRows(bool batch);
 
     tst_Databases dbs;
 };
@@ -299,4 +310,257 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     tst_Databases::safeDropTable(db, tableName);
 }
 
+// Reads a wide scrollable result to its end and back again, which goes
+// through the row cache of drivers based on QSqlCachedResult.
+void tst_QSqlQuery::benchmarkScrollCached()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + "(id INT NOT NULL, num DOUBLE PRECISION, t_varchar VARCHAR(20))"));
+
+    const int NUM_ROWS = 50000;
+    QVariantList ids;
+    QVariantList nums;
+    QVariantList strings;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        nums << i / 4.0;
+        strings << QString::fromLatin1("Value%1").arg(i);
+    }
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(nums);
+    q.addBindValue(strings);
+    QVERIFY_SQL(q, execBatch());
+
+    QVERIFY_SQL(q, prepare("SELECT id, num, t_varchar FROM " + tableName));
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        qint64 sum = 0;
+        while (q.next())
+            sum += q.value(0).toInt();
+        while (q.previous())
+            sum -= q.value(0).toInt() + q.value(2).toString().size();
+        QVERIFY(sum < 0);
+    }
+    q.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkExecAsync_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<int>("connections");
+    if (dbs.dbNames.isEmpty())
+        QSKIP("No database drivers are available in this Qt configuration");
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        if (!db.isValid() || db.databaseName() == ":memory:")
+            continue;
+        QTest::newRow(qPrintable(dbName + QLatin1String(": sequential"))) << dbName << 0;
+        for (int connections = 1; connections <= 8; connections *= 2) {
+            QTest::newRow(qPrintable(dbName + QString::fromLatin1(": %1 connections").arg(connections)))
+                << dbName << connections;
+        }
+    }
+}
+
+// Runs a number of aggregate queries either one after the other on the
+// calling thread, or all at once through execAsync() with a growing number
+// of worker connections.
+void tst_QSqlQuery::benchmarkExecAsync()
+{
+    QFETCH(QString, dbName);
+    QFETCH(int, connections);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + "(id INT NOT NULL, num DOUBLE PRECISION)"));
+
+    const int NUM_ROWS = 50000;
+    QVariantList ids;
+    QVariantList nums;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        nums << i / 4.0;
+    }
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(nums);
+    QVERIFY_SQL(q, execBatch());
+
+    const int NUM_QUERIES = 32;
+    const QString query("SELECT COUNT(*), SUM(num) FROM " + tableName + " WHERE id % ? = 0");
+    if (connections > 0) {
+        db.setMaxAsyncConnectionCount(connections);
+        // open the worker connections outside of the measurement
+        QVector<QFuture<QSqlAsyncResult> > futures;
+        for (int i = 0; i < connections; ++i)
+            futures << db.execAsync(query, QVariantList() << NUM_ROWS);
+        for (const QFuture<QSqlAsyncResult> &future : qAsConst(futures))
+            QVERIFY(future.result().isActive());
+    }
+
+    QBENCHMARK {
+        int total = 0;
+        if (connections > 0) {
+            QVector<QFuture<QSqlAsyncResult> > futures;
+            for (int i = 1; i <= NUM_QUERIES; ++i)
+                futures << db.execAsync(query, QVariantList() << i);
+            for (const QFuture<QSqlAsyncResult> &future : qAsConst(futures)) {
+                const QSqlAsyncResult result = future.result();
+                QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+                total += result.value(0, 0).toInt();
+            }
+        } else {
+            QVERIFY_SQL(q, prepare(query));
+            for (int i = 1; i <= NUM_QUERIES; ++i) {
+                q.addBindValue(i);
+                QVERIFY_SQL(q, exec());
+                QVERIFY(q.next());
+                total += q.value(0).toInt();
+            }
+            q.finish();
+        }
+        QVERIFY(total > NUM_ROWS);
+    }
+
+    db.setMaxAsyncConnectionCount(1);
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkPrepareLookup_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<bool>("statementCache");
+    if (dbs.dbNames.isEmpty())
+        QSKIP("No database drivers are available in this Qt configuration");
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QSqlDatabase db = QSqlDatabase::database(dbName);
+        if (tst_Databases::getDatabaseType(db) != QSqlDriver::SQLite)
+            continue;
+        QTest::newRow(qPrintable(dbName + QLatin1String(": cached"))) << dbName << true;
+        QTest::newRow(qPrintable(dbName + QLatin1String(": uncached"))) << dbName << false;
+    }
+}
+
+// Looks up single rows with a new query object each time, the way a model or
+// a data access layer would; the SQLite driver reuses the compiled statement
+// unless its statement cache is disabled.
+void tst_QSqlQuery::benchmarkPrepareLookup()
+{
+    QFETCH(QString, dbName);
+    QFETCH(bool, statementCache);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + "(id INT NOT NULL PRIMARY KEY, t_varchar VARCHAR(20), num DOUBLE PRECISION)"));
+    const int NUM_ROWS = 1000;
+    QVariantList ids;
+    QVariantList strings;
+    QVariantList nums;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        strings << QString::fromLatin1("Value%1").arg(i);
+        nums << i / 4.0;
+    }
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(strings);
+    q.addBindValue(nums);
+    QVERIFY_SQL(q, execBatch());
+
+    QSqlDatabase lookupDb = db;
+    const QString uncachedName = dbName + QLatin1String("_uncached");
+    if (!statementCache) {
+        lookupDb = QSqlDatabase::cloneDatabase(db, uncachedName);
+        lookupDb.setConnectOptions(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE=0"));
+        QVERIFY_SQL(lookupDb, open());
+    }
+
+    const QString select("SELECT t_varchar, num FROM " + tableName + " WHERE id = ?");
+    QBENCHMARK {
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            QSqlQuery lookup(lookupDb);
+            QVERIFY_SQL(lookup, prepare(select));
+            lookup.addBindValue(i);
+            QVERIFY_SQL(lookup, exec());
+            QVERIFY(lookup.next());
+        }
+    }
+
+    if (!statementCache) {
+        lookupDb = QSqlDatabase();
+        QSqlDatabase::removeDatabase(uncachedName);
+    }
+    q.finish();
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+// Inserts the same rows once per exec() and once through execBatch(); drivers
+// with a native batch path should be considerably faster in the latter case.
+void tst_QSqlQuery::insertRows(bool batch)
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + "(id INT NOT NULL, t_varchar VARCHAR(20))"));
+
+    const int NUM_ROWS = 10000;
+    QVariantList ids;
+    QVariantList strings;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        strings << QString::fromLatin1("Value%1").arg(i);
+    }
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+    QBENCHMARK {
+        if (batch) {
+            q.addBindValue(ids);
+            q.addBindValue(strings);
+            QVERIFY_SQL(q, execBatch());
+        } else {
+            for (int i = 0; i < NUM_ROWS; ++i) {
+                q.addBindValue(ids.at(i));
+                q.addBindValue(strings.at(i));
+                QVERIFY_SQL(q, exec());
+            }
+        }
+    }
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt() % NUM_ROWS, 0);
+    q.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 #include "main.moc"